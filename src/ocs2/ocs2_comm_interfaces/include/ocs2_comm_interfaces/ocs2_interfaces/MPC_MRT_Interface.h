@@ -109,6 +109,7 @@ class MPC_MRT_Interface final : public MRT_BASE<STATE_DIM, INPUT_DIM> {
    * Advance the mpc module for one iteration.
    * The evaluation methods can be called while this method is running.
    * They will evaluate the control law that was up-to-date at the last updatePolicy() call
+   * In the real-time iteration mode, the next iteration is prepared after the new policy is handed over.
    */
   void advanceMpc();
 
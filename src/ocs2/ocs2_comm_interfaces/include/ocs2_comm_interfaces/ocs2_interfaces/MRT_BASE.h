@@ -31,13 +31,16 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <Eigen/Dense>
 
+#include <array>
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 
 #include <ocs2_core/Dimensions.h>
 #include <ocs2_core/control/ControllerBase.h>
+#include <ocs2_core/control/LinearController.h>
 #include <ocs2_core/cost/CostDesiredTrajectories.h>
 #include <ocs2_core/logic/ModeSchedule.h>
 #include <ocs2_core/misc/LinearInterpolation.h>
@@ -71,6 +74,7 @@ class MRT_BASE {
   using input_vector_array_t = typename dim_t::input_vector_array_t;
 
   using controller_t = ControllerBase<STATE_DIM, INPUT_DIM>;
+  using linear_controller_t = LinearController<STATE_DIM, INPUT_DIM>;
   using rollout_base_t = RolloutBase<STATE_DIM, INPUT_DIM>;
 
   using primal_solution_t = PrimalSolution<STATE_DIM, INPUT_DIM>;
@@ -87,7 +91,8 @@ class MRT_BASE {
   ~MRT_BASE() = default;
 
   /**
-   * Resets the class to its instantiated state.
+   * Resets the class to its instantiated state. A policy which is not yet taken by updatePolicy() is dropped.
+   * It should not be called concurrently with updatePolicy().
    */
   void reset();
 
@@ -131,6 +136,9 @@ class MRT_BASE {
 
   /**
    * @brief Evaluates the controller
+   * The time lookup starts from the segment of the previous call and, for a linear controller on the time trajectory of the policy,
+   * it is shared between the controller and the state trajectory. The method neither allocates memory nor prints, so it can be
+   * called in a real-time loop. It should be called from the same thread as updatePolicy().
    *
    * @param [in] currentTime: the query time.
    * @param [in] currentState: the query state.
@@ -158,11 +166,18 @@ class MRT_BASE {
    * Checks the data buffer for an update of the MPC policy. If a new policy
    * is available on the buffer this method will load it to the in-use policy.
    * This method also calls the modifyPolicy() method.
+   * The policy is taken over without locks or copies, so the call never waits for the thread which writes the policy.
    *
    * @return True if the policy is updated.
    */
   bool updatePolicy();
 
+  /**
+   * Whether the query time of the last evaluatePolicy() call was beyond the time horizon of the current policy. In this case,
+   * the policy is extrapolated. The flag allows to report it outside of the real-time loop.
+   */
+  bool policyHorizonExceeded() const { return policyHorizonExceeded_; }
+
   /**
    * @brief rolloutSet: Whether or not the internal rollout object has been set
    * @return True if a rollout object is available.
@@ -172,8 +187,8 @@ class MRT_BASE {
  protected:
   /**
    * The updatePolicy() method will call this method which allows the user to
-   * customize the in-use policy. Note that this method is already
-   * protected with a mutex which blocks the policy callback. Moreover, this method
+   * customize the in-use policy. Note that the in-use policy is only accessed
+   * by the thread calling updatePolicy(). Moreover, this method
    * may be called in the main thread of the program. Thus, for efficiency and
    * practical considerations you should avoid computationally expensive operations.
    * For such operations you may want to use the modifyBufferPolicy()
@@ -201,29 +216,75 @@ class MRT_BASE {
    */
   void partitioningTimesUpdate(scalar_t time, scalar_array_t& partitioningTimes) const;
 
+  /**
+   * Hands the policy on the buffer (the variables with suffix *Buffer_) over to updatePolicy() and provides new buffer variables to be
+   * filled with the next policy. The buffer should be completely filled before. This method is wait-free, it should be called with
+   * policyBufferMutex_ locked.
+   */
+  void publishPolicyBuffer();
+
+  /**
+   * Prepares the lookups of evaluatePolicy() for the current policy. It is called whenever the current policy changes.
+   */
+  void resetPolicyEvaluation();
+
  protected:
   // flags on state of the class
   std::atomic_bool policyReceivedEver_;
-  bool newPolicyInBuffer_;  //! Whether a new policy is waiting to be swapped in
 
   // variables related to the MPC output
   std::atomic_bool policyUpdated_;  //! Whether the policy was updated by MPC (i.e., MPC succeeded)
-  bool policyUpdatedBuffer_;        //! Whether the policy in buffer was upated by MPC (i.e., MPC succeeded)
-  std::unique_ptr<primal_solution_t> currentPrimalSolution_;
-  std::unique_ptr<primal_solution_t> primalSolutionBuffer_;
-  std::unique_ptr<command_data_t> currentCommand_;
-  std::unique_ptr<command_data_t> commandBuffer_;
+  primal_solution_t* currentPrimalSolution_;
+  primal_solution_t* primalSolutionBuffer_;
+  command_data_t* currentCommand_;
+  command_data_t* commandBuffer_;
 
   // thread safety
-  mutable std::mutex policyBufferMutex_;  // for policy variables WITH suffix (*Buffer_)
+  mutable std::mutex policyBufferMutex_;  // serializes the writers of policy variables WITH suffix (*Buffer_)
 
   // variables needed for policy evaluation
   std::unique_ptr<rollout_base_t> rolloutPtr_;
+  const linear_controller_t* currentLinearControllerPtr_;  //! The current controller if it is linear, otherwise nullptr
+  bool controllerOnPolicyTime_;                             //! Whether the time stamps of the linear controller are the policy's
+  int policyTimeIndexHint_;
+  int controllerTimeIndexHint_;
+  bool policyHorizonExceeded_;
 
   // variables
-  scalar_array_t partitioningTimes_;
-  scalar_array_t partitioningTimesBuffer_;
+  scalar_array_t* partitioningTimes_;
+  scalar_array_t* partitioningTimesBuffer_;
   SystemObservation<STATE_DIM, INPUT_DIM> initPlanObservation_;  //! The initial observation of the first plan ever received
+
+ private:
+  /**
+   * Sets the pointers to the current policy to its slot. Only called by the reader.
+   */
+  void setCurrentPolicyPointers();
+
+  /**
+   * Sets the pointers to the buffer to its slot. Only called by the writer.
+   */
+  void setBufferPolicyPointers();
+
+  /** The data of a policy which is handed over from the MPC to the MRT. */
+  struct PolicySlot {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    primal_solution_t primalSolution;
+    command_data_t command;
+    scalar_array_t partitioningTimes;
+  };
+
+  /*
+   * Triple buffer of policies: the current policy, the buffer which is filled by the writer, and the ready policy in between. The
+   * writer publishes the buffer by exchanging it with the ready slot, and updatePolicy() takes a new ready policy by exchanging it
+   * with the current one. Neither side waits for the other.
+   */
+  static constexpr uint8_t slotIndexMask_ = 0x3;
+  static constexpr uint8_t newPolicyFlag_ = 0x4;
+  std::array<PolicySlot, 3> policySlots_;
+  uint8_t currentPolicySlot_;
+  uint8_t bufferPolicySlot_;
+  std::atomic<uint8_t> readyPolicySlot_;  //! The index of the ready slot, with newPolicyFlag_ set if it holds a new policy
 };
 
 }  // namespace ocs2
@@ -94,6 +94,9 @@ void MPC_MRT_Interface<STATE_DIM, INPUT_DIM>::advanceMpc() {
     std::cerr << "###   Average : " << mpcTimer_.getAverageInMilliseconds() << "[ms]." << std::endl;
     std::cerr << "###   Latest  : " << mpcTimer_.getLastIntervalInMilliseconds() << "[ms]." << std::endl;
   }
+
+  // prepare the next real-time iteration after the policy is handed over
+  mpc_.prepareRealTimeIteration();
 }
 
 /******************************************************************************************************/
@@ -110,22 +113,21 @@ void MPC_MRT_Interface<STATE_DIM, INPUT_DIM>::fillMpcOutputBuffers(system_observ
   if (mpc_.settings().solutionTimeWindow_ < 0) {
     finalTime = mpc_.getSolverPtr()->getFinalTime();
   }
-  mpc_.getSolverPtr()->getPrimalSolution(finalTime, this->primalSolutionBuffer_.get());
+  mpc_.getSolverPtr()->getPrimalSolution(finalTime, this->primalSolutionBuffer_);
 
   // command
   this->commandBuffer_->mpcInitObservation_ = std::move(mpcInitObservation);
   this->commandBuffer_->mpcCostDesiredTrajectories_ = mpc_.getSolverPtr()->getCostDesiredTrajectories();
 
   // partition
-  this->partitioningTimesUpdate(startTime, this->partitioningTimesBuffer_);
+  this->partitioningTimesUpdate(startTime, *this->partitioningTimesBuffer_);
 
   // allow user to modify the buffer
   this->modifyBufferPolicy(*this->commandBuffer_, *this->primalSolutionBuffer_);
 
-  // Flags to be set last:
-  this->newPolicyInBuffer_ = true;
+  // hand the policy over to the MRT, to be done last
   this->policyReceivedEver_ = true;
-  this->policyUpdatedBuffer_ = true;
+  this->publishPolicyBuffer();
 }
 
 /******************************************************************************************************/
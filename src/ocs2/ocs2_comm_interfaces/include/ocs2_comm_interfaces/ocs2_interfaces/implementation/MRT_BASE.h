@@ -37,12 +37,20 @@ namespace ocs2 {
 /******************************************************************************************************/
 /******************************************************************************************************/
 template <size_t STATE_DIM, size_t INPUT_DIM>
-MRT_BASE<STATE_DIM, INPUT_DIM>::MRT_BASE()
-    : currentPrimalSolution_(new primal_solution_t),
-      primalSolutionBuffer_(new primal_solution_t),
-      currentCommand_(new command_data_t),
-      commandBuffer_(new command_data_t) {
+constexpr uint8_t MRT_BASE<STATE_DIM, INPUT_DIM>::slotIndexMask_;
+
+template <size_t STATE_DIM, size_t INPUT_DIM>
+constexpr uint8_t MRT_BASE<STATE_DIM, INPUT_DIM>::newPolicyFlag_;
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+template <size_t STATE_DIM, size_t INPUT_DIM>
+MRT_BASE<STATE_DIM, INPUT_DIM>::MRT_BASE() : currentPolicySlot_(0), bufferPolicySlot_(1), readyPolicySlot_(2) {
+  setCurrentPolicyPointers();
+  setBufferPolicyPointers();
   reset();
+  resetPolicyEvaluation();
 }
 
 /******************************************************************************************************/
@@ -53,13 +61,13 @@ void MRT_BASE<STATE_DIM, INPUT_DIM>::reset() {
   std::lock_guard<std::mutex> lock(policyBufferMutex_);
 
   policyReceivedEver_ = false;
-  newPolicyInBuffer_ = false;
-
   policyUpdated_ = false;
-  policyUpdatedBuffer_ = false;
 
-  partitioningTimesUpdate(0.0, partitioningTimes_);
-  partitioningTimesUpdate(0.0, partitioningTimesBuffer_);
+  // drop the ready policy
+  readyPolicySlot_.fetch_and(slotIndexMask_);
+
+  partitioningTimesUpdate(0.0, *partitioningTimes_);
+  partitioningTimesUpdate(0.0, *partitioningTimesBuffer_);
 }
 
 /******************************************************************************************************/
@@ -76,15 +84,21 @@ void MRT_BASE<STATE_DIM, INPUT_DIM>::initRollout(const rollout_base_t* rolloutPt
 template <size_t STATE_DIM, size_t INPUT_DIM>
 void MRT_BASE<STATE_DIM, INPUT_DIM>::evaluatePolicy(scalar_t currentTime, const state_vector_t& currentState, state_vector_t& mpcState,
                                                     input_vector_t& mpcInput, size_t& mode) {
-  if (currentTime > currentPrimalSolution_->timeTrajectory_.back()) {
-    std::cerr << "The requested currentTime is greater than the received plan: " + std::to_string(currentTime) + ">" +
-                     std::to_string(currentPrimalSolution_->timeTrajectory_.back())
-              << std::endl;
-  }
+  const auto& timeTrajectory = currentPrimalSolution_->timeTrajectory_;
+  policyHorizonExceeded_ = currentTime > timeTrajectory.back();
 
-  mpcInput = currentPrimalSolution_->controllerPtr_->computeInput(currentTime, currentState);
-  EigenLinearInterpolation<state_vector_t>::interpolate(currentTime, mpcState, &currentPrimalSolution_->timeTrajectory_,
-                                                        &currentPrimalSolution_->stateTrajectory_);
+  const auto indexAlpha = EigenLinearInterpolation<state_vector_t>::timeSegment(currentTime, &timeTrajectory, policyTimeIndexHint_);
+  EigenLinearInterpolation<state_vector_t>::interpolate(indexAlpha, mpcState, &currentPrimalSolution_->stateTrajectory_);
+
+  if (currentLinearControllerPtr_ == nullptr) {
+    mpcInput = currentPrimalSolution_->controllerPtr_->computeInput(currentTime, currentState);
+  } else if (controllerOnPolicyTime_) {
+    mpcInput = currentLinearControllerPtr_->computeInputAtTimeSegment(indexAlpha, currentState);
+  } else {
+    const auto controllerIndexAlpha = EigenLinearInterpolation<input_vector_t>::timeSegment(
+        currentTime, &currentLinearControllerPtr_->timeStamp_, controllerTimeIndexHint_);
+    mpcInput = currentLinearControllerPtr_->computeInputAtTimeSegment(controllerIndexAlpha, currentState);
+  }
 
   mode = currentPrimalSolution_->modeSchedule_.modeAtTime(currentTime);
 }
@@ -132,20 +146,17 @@ void MRT_BASE<STATE_DIM, INPUT_DIM>::rolloutPolicy(scalar_t currentTime, const s
 /******************************************************************************************************/
 template <size_t STATE_DIM, size_t INPUT_DIM>
 bool MRT_BASE<STATE_DIM, INPUT_DIM>::updatePolicy() {
-  std::lock_guard<std::mutex> lock(policyBufferMutex_);
-
-  if (!policyUpdatedBuffer_ || !newPolicyInBuffer_) {
+  if ((readyPolicySlot_.load(std::memory_order_acquire) & newPolicyFlag_) == 0) {
     return false;
   }
-  newPolicyInBuffer_ = false;  // make sure we don't swap in the old policy again
 
-  // update the current policy from buffer
-  policyUpdated_ = policyUpdatedBuffer_;
-  currentCommand_.swap(commandBuffer_);
-  currentPrimalSolution_.swap(primalSolutionBuffer_);
-  partitioningTimes_.swap(partitioningTimesBuffer_);
+  // take the ready policy, the old current policy becomes the ready slot without the new policy flag
+  currentPolicySlot_ = readyPolicySlot_.exchange(currentPolicySlot_, std::memory_order_acq_rel) & slotIndexMask_;
+  setCurrentPolicyPointers();
+  policyUpdated_ = true;
 
   modifyPolicy(*currentCommand_, *currentPrimalSolution_);
+  resetPolicyEvaluation();
 
   return true;
 }
@@ -160,4 +171,47 @@ void MRT_BASE<STATE_DIM, INPUT_DIM>::partitioningTimesUpdate(scalar_t time, scal
   partitioningTimes[1] = std::numeric_limits<scalar_t>::max();
 }
 
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+template <size_t STATE_DIM, size_t INPUT_DIM>
+void MRT_BASE<STATE_DIM, INPUT_DIM>::publishPolicyBuffer() {
+  // the buffer becomes the ready policy, the old ready slot (possibly a policy which was never taken) becomes the buffer
+  bufferPolicySlot_ = readyPolicySlot_.exchange(bufferPolicySlot_ | newPolicyFlag_, std::memory_order_acq_rel) & slotIndexMask_;
+  setBufferPolicyPointers();
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+template <size_t STATE_DIM, size_t INPUT_DIM>
+void MRT_BASE<STATE_DIM, INPUT_DIM>::setCurrentPolicyPointers() {
+  currentPrimalSolution_ = &policySlots_[currentPolicySlot_].primalSolution;
+  currentCommand_ = &policySlots_[currentPolicySlot_].command;
+  partitioningTimes_ = &policySlots_[currentPolicySlot_].partitioningTimes;
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+template <size_t STATE_DIM, size_t INPUT_DIM>
+void MRT_BASE<STATE_DIM, INPUT_DIM>::setBufferPolicyPointers() {
+  primalSolutionBuffer_ = &policySlots_[bufferPolicySlot_].primalSolution;
+  commandBuffer_ = &policySlots_[bufferPolicySlot_].command;
+  partitioningTimesBuffer_ = &policySlots_[bufferPolicySlot_].partitioningTimes;
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+template <size_t STATE_DIM, size_t INPUT_DIM>
+void MRT_BASE<STATE_DIM, INPUT_DIM>::resetPolicyEvaluation() {
+  currentLinearControllerPtr_ = dynamic_cast<const linear_controller_t*>(currentPrimalSolution_->controllerPtr_.get());
+  controllerOnPolicyTime_ =
+      currentLinearControllerPtr_ != nullptr && currentLinearControllerPtr_->timeStamp_ == currentPrimalSolution_->timeTrajectory_;
+  policyTimeIndexHint_ = 0;
+  controllerTimeIndexHint_ = 0;
+  policyHorizonExceeded_ = false;
+}
+
 }  // namespace ocs2
@@ -333,6 +333,9 @@ void MPC_ROS_Interface<STATE_DIM, INPUT_DIM>::mpcObservationCallback(const ocs2_
 
 #endif
 
+  // prepare the next real-time iteration after the policy is published
+  mpc_.prepareRealTimeIteration();
+
   // set the initialCall flag to false
   initialCall_ = false;
 }
@@ -133,7 +133,7 @@ class MRT_ROS_Interface : public MRT_BASE<STATE_DIM, INPUT_DIM> {
  private:
   /**
    * Callback method to receive the MPC policy as well as the mode sequence.
-   * It only updates the policy variables with suffix (*Buffer_) variables.
+   * It fills the policy variables with suffix (*Buffer_) and hands them over to updatePolicy().
    *
    * @param [in] msg: A constant pointer to the message
    */
@@ -142,19 +142,8 @@ void MRT_ROS_Interface<STATE_DIM, INPUT_DIM>::mpcPolicyCallback(const ocs2_msgs:
   auto& initObservationBuffer = this->commandBuffer_->mpcInitObservation_;
   auto& costDesiredBuffer = this->commandBuffer_->mpcCostDesiredTrajectories_;
 
-  // if MPC did not update the policy
+  // if MPC did not update the policy, there is nothing to hand over
   if (!static_cast<bool>(msg->controllerIsUpdated)) {
-    timeBuffer.clear();
-    stateBuffer.clear();
-    inputBuffer.clear();
-    controlBuffer.reset(nullptr);
-    modeScheduleBuffer = ModeSchedule({}, {0});
-    initObservationBuffer = system_observation_t();
-    costDesiredBuffer.clear();
-
-    this->policyUpdatedBuffer_ = false;
-    this->newPolicyInBuffer_ = true;
-
     return;
   }
 
@@ -162,10 +151,8 @@ void MRT_ROS_Interface<STATE_DIM, INPUT_DIM>::mpcPolicyCallback(const ocs2_msgs:
   ros_msg_conversions::readTargetTrajectoriesMsg(msg->planTargetTrajectories, costDesiredBuffer);
   modeScheduleBuffer = ros_msg_conversions::readModeScheduleMsg(msg->modeSchedule);
 
-  this->policyUpdatedBuffer_ = msg->controllerIsUpdated;
-
   const scalar_t partitionInitMargin = 1e-1;  //! @badcode Is this necessary?
-  this->partitioningTimesUpdate(initObservationBuffer.time() - partitionInitMargin, this->partitioningTimesBuffer_);
+  this->partitioningTimesUpdate(initObservationBuffer.time() - partitionInitMargin, *this->partitioningTimesBuffer_);
 
   const size_t N = msg->timeTrajectory.size();
 
@@ -216,13 +203,13 @@ void MRT_ROS_Interface<STATE_DIM, INPUT_DIM>::mpcPolicyCallback(const ocs2_msgs:
   // allow user to modify the buffer
   this->modifyBufferPolicy(*this->commandBuffer_, *this->primalSolutionBuffer_);
 
-  if (!this->policyReceivedEver_ && this->policyUpdatedBuffer_) {
+  if (!this->policyReceivedEver_) {
     this->policyReceivedEver_ = true;
     this->initPlanObservation_ = initObservationBuffer;
     this->initCall(this->initPlanObservation_);
   }
 
-  this->newPolicyInBuffer_ = true;
+  this->publishPolicyBuffer();
 }
 
 /******************************************************************************************************/
@@ -0,0 +1,239 @@
+/******************************************************************************
+Copyright (c) 2017, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <thread>
+
+#include <ocs2_comm_interfaces/ocs2_interfaces/MRT_BASE.h>
+
+namespace {
+std::atomic<size_t> numAllocations{0};
+}  // namespace
+
+// counts the heap allocations of the test
+void* operator new(std::size_t size) {
+  numAllocations++;
+  if (void* ptr = std::malloc(size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+constexpr size_t STATE_DIM = 12;
+constexpr size_t INPUT_DIM = 6;
+
+class TestMrt final : public ocs2::MRT_BASE<STATE_DIM, INPUT_DIM> {
+ public:
+  using BASE = ocs2::MRT_BASE<STATE_DIM, INPUT_DIM>;
+
+  void resetMpcNode(const ocs2::CostDesiredTrajectories& initCostDesiredTrajectories) override {}
+  void setCurrentObservation(const ocs2::SystemObservation<STATE_DIM, INPUT_DIM>& observation) override {}
+
+  bool controllerOnPolicyTime() const { return controllerOnPolicyTime_; }
+
+  /** Puts a policy in the buffer and hands it over as the MPC does. */
+  void setPolicyBuffer(const primal_solution_t& primalSolution) {
+    std::lock_guard<std::mutex> lock(policyBufferMutex_);
+    *primalSolutionBuffer_ = primalSolution;
+    policyReceivedEver_ = true;
+    publishPolicyBuffer();
+  }
+};
+
+class MrtPolicyEvaluationTest : public testing::Test {
+ protected:
+  using primal_solution_t = TestMrt::primal_solution_t;
+  using scalar_t = TestMrt::scalar_t;
+  using scalar_array_t = TestMrt::scalar_array_t;
+  using state_vector_t = TestMrt::state_vector_t;
+  using input_vector_t = TestMrt::input_vector_t;
+  using linear_controller_t = TestMrt::linear_controller_t;
+
+  static constexpr size_t numNodes = 101;
+  static constexpr scalar_t timeStep = 0.01;
+
+  static scalar_array_t getPolicyTime() {
+    scalar_array_t policyTime;
+    for (size_t k = 0; k < numNodes; k++) {
+      policyTime.push_back(k * timeStep);
+    }
+    return policyTime;
+  }
+
+  /** Random policy with a linear controller on the given time stamps. */
+  static primal_solution_t getPolicy(const scalar_array_t& controllerTime) {
+    primal_solution_t primalSolution;
+    primalSolution.timeTrajectory_ = getPolicyTime();
+    for (size_t k = 0; k < numNodes; k++) {
+      primalSolution.stateTrajectory_.push_back(state_vector_t::Random());
+      primalSolution.inputTrajectory_.push_back(input_vector_t::Random());
+    }
+
+    typename linear_controller_t::input_vector_array_t bias;
+    typename linear_controller_t::input_state_matrix_array_t gain;
+    for (size_t k = 0; k < controllerTime.size(); k++) {
+      bias.push_back(input_vector_t::Random());
+      gain.push_back(linear_controller_t::input_state_matrix_t::Random());
+    }
+    primalSolution.controllerPtr_.reset(new linear_controller_t(controllerTime, bias, gain));
+    return primalSolution;
+  }
+
+  /** Compares evaluatePolicy() with a direct evaluation of the policy for increasing times, as in a tracking loop. */
+  void checkPolicyEvaluation(const primal_solution_t& primalSolution, bool controllerOnPolicyTime) {
+    mrt_.setPolicyBuffer(primalSolution);
+    numAllocations = 0;
+    ASSERT_TRUE(mrt_.updatePolicy());
+    ASSERT_EQ(numAllocations.load(), 0);
+    ASSERT_FALSE(mrt_.updatePolicy());
+    ASSERT_EQ(mrt_.controllerOnPolicyTime(), controllerOnPolicyTime);
+
+    const state_vector_t x = state_vector_t::Random();
+    state_vector_t mpcState;
+    input_vector_t mpcInput;
+    size_t mode;
+    for (scalar_t t = -0.1; t < 1.1; t += 0.0025) {
+      numAllocations = 0;
+      mrt_.evaluatePolicy(t, x, mpcState, mpcInput, mode);
+      ASSERT_EQ(numAllocations.load(), 0);
+      ASSERT_EQ(mrt_.policyHorizonExceeded(), t > primalSolution.timeTrajectory_.back());
+
+      state_vector_t expectedState;
+      ocs2::EigenLinearInterpolation<state_vector_t>::interpolate(t, expectedState, &primalSolution.timeTrajectory_,
+                                                                  &primalSolution.stateTrajectory_);
+      const input_vector_t expectedInput = primalSolution.controllerPtr_->computeInput(t, x);
+      ASSERT_TRUE(mpcState.isApprox(expectedState)) << "t = " << t;
+      ASSERT_TRUE(mpcInput.isApprox(expectedInput)) << "t = " << t;
+      ASSERT_EQ(mode, 0);
+    }
+  }
+
+  TestMrt mrt_;
+};
+
+constexpr size_t MrtPolicyEvaluationTest::numNodes;
+constexpr MrtPolicyEvaluationTest::scalar_t MrtPolicyEvaluationTest::timeStep;
+
+TEST_F(MrtPolicyEvaluationTest, controllerOnPolicyTime) {
+  srand(0);
+  checkPolicyEvaluation(getPolicy(getPolicyTime()), true);
+}
+
+TEST_F(MrtPolicyEvaluationTest, controllerOnDifferentTime) {
+  srand(0);
+  scalar_array_t controllerTime;
+  for (size_t k = 0; k < 3 * numNodes; k++) {
+    controllerTime.push_back(0.3 * timeStep * k + 0.001);
+  }
+  checkPolicyEvaluation(getPolicy(controllerTime), false);
+}
+
+TEST_F(MrtPolicyEvaluationTest, concurrentHandoff) {
+  constexpr size_t numPolicies = 2000;
+
+  // every value of the policy with the given id equals the id, such that a torn policy is detected
+  const auto getPolicyWithId = [](size_t id) {
+    primal_solution_t primalSolution;
+    primalSolution.timeTrajectory_ = getPolicyTime();
+    primalSolution.stateTrajectory_.assign(numNodes, state_vector_t::Constant(id));
+    primalSolution.inputTrajectory_.assign(numNodes, input_vector_t::Constant(id));
+    const typename linear_controller_t::input_vector_array_t bias(numNodes, input_vector_t::Constant(id));
+    const typename linear_controller_t::input_state_matrix_array_t gain(numNodes, linear_controller_t::input_state_matrix_t::Zero());
+    primalSolution.controllerPtr_.reset(new linear_controller_t(primalSolution.timeTrajectory_, bias, gain));
+    return primalSolution;
+  };
+
+  std::thread writer([&]() {
+    for (size_t id = 1; id <= numPolicies; id++) {
+      mrt_.setPolicyBuffer(getPolicyWithId(id));
+    }
+  });
+
+  const state_vector_t x = state_vector_t::Random();
+  state_vector_t mpcState;
+  input_vector_t mpcInput;
+  size_t mode;
+  size_t lastId = 0;
+  size_t numUpdates = 0;
+  while (lastId < numPolicies) {
+    if (!mrt_.updatePolicy()) {
+      continue;
+    }
+    numUpdates++;
+    mrt_.evaluatePolicy(0.5, x, mpcState, mpcInput, mode);
+    const size_t id = static_cast<size_t>(mpcState(0));
+    ASSERT_GT(id, lastId);
+    ASSERT_TRUE(mpcState.isApprox(state_vector_t::Constant(id))) << "id = " << id;
+    ASSERT_TRUE(mpcInput.isApprox(input_vector_t::Constant(id))) << "id = " << id;
+    ASSERT_EQ(mrt_.getPolicy().stateTrajectory_.size(), numNodes);
+    lastId = id;
+  }
+  writer.join();
+
+  ASSERT_FALSE(mrt_.updatePolicy());
+  std::cerr << "received " << numUpdates << " out of " << numPolicies << " policies" << std::endl;
+}
+
+TEST_F(MrtPolicyEvaluationTest, latency) {
+  constexpr size_t numEvaluations = 100000;
+  srand(0);
+  mrt_.setPolicyBuffer(getPolicy(getPolicyTime()));
+  ASSERT_TRUE(mrt_.updatePolicy());
+
+  // the tracking loop runs much faster than the policy time step
+  const state_vector_t x = state_vector_t::Random();
+  state_vector_t mpcState;
+  input_vector_t mpcInput;
+  size_t mode;
+  std::vector<double> latencies(numEvaluations);
+  for (size_t i = 0; i < numEvaluations; i++) {
+    const scalar_t t = (timeStep * (numNodes - 1) * i) / numEvaluations;
+    const auto startTime = std::chrono::steady_clock::now();
+    mrt_.evaluatePolicy(t, x, mpcState, mpcInput, mode);
+    const auto endTime = std::chrono::steady_clock::now();
+    latencies[i] = std::chrono::duration<double, std::micro>(endTime - startTime).count();
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  std::cerr << "evaluatePolicy latency, p50: " << latencies[numEvaluations / 2] << " [us], p99: " << latencies[99 * numEvaluations / 100]
+            << " [us], max: " << latencies.back() << " [us]" << std::endl;
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
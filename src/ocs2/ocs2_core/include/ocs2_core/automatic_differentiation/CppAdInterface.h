@@ -54,6 +54,9 @@ class CppAdInterface {
   using dynamic_vector_t = Eigen::Matrix<scalar_t, Eigen::Dynamic, 1>;
   using dynamic_matrix_t = Eigen::Matrix<scalar_t, Eigen::Dynamic, Eigen::Dynamic>;
   using dynamic_rowMajor_matrix_t = Eigen::Matrix<scalar_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+  using dynamic_vector_const_ref_t = Eigen::Ref<const dynamic_vector_t>;
+  using dynamic_vector_ref_t = Eigen::Ref<dynamic_vector_t>;
+  using dynamic_matrix_ref_t = Eigen::Ref<dynamic_matrix_t>;
   using ad_dynamic_vector_t = Eigen::Matrix<ad_scalar_t, Eigen::Dynamic, 1>;
   using ad_function_t = std::function<void(const ad_dynamic_vector_t&, ad_dynamic_vector_t&)>;
   using ad_parameterized_function_t = std::function<void(const ad_dynamic_vector_t&, const ad_dynamic_vector_t&, ad_dynamic_vector_t&)>;
@@ -159,12 +162,61 @@ class CppAdInterface {
    */
   dynamic_matrix_t getHessian(const dynamic_vector_t& w, const dynamic_vector_t& x, const dynamic_vector_t& p = dynamic_vector_t(0)) const;
 
+  /**
+   * In-place version of getFunctionValue. It does not allocate memory in steady state, such that it can be called
+   * in the inner loops of the solvers. The output can be a fixed size type, but it should have the correct size.
+   *
+   * @param [in] x : input vector of size variableDim
+   * @param [in] p : parameter vector of size parameterDim
+   * @param [out] functionValue : y = f(x,p) of size rangeDim
+   */
+  void getFunctionValue(dynamic_vector_const_ref_t x, dynamic_vector_const_ref_t p, dynamic_vector_ref_t functionValue) const;
+
+  /**
+   * In-place version of getJacobian. See getFunctionValue for the requirements on the output.
+   *
+   * @param [in] x : input vector of size variableDim
+   * @param [in] p : parameter vector of size parameterDim
+   * @param [out] jacobian : d/dx( f(x,p) ) of size rangeDim x variableDim
+   */
+  void getJacobian(dynamic_vector_const_ref_t x, dynamic_vector_const_ref_t p, dynamic_matrix_ref_t jacobian) const;
+
+  /**
+   * In-place version of the hessian for a single output. See getFunctionValue for the requirements on the output.
+   *
+   * @param [in] outputIndex : Output to get the hessian for.
+   * @param [in] x : input vector of size variableDim
+   * @param [in] p : parameter vector of size parameterDim
+   * @param [out] hessian : dd/dxdx( f_i(x,p) ) of size variableDim x variableDim
+   */
+  void getHessian(size_t outputIndex, dynamic_vector_const_ref_t x, dynamic_vector_const_ref_t p, dynamic_matrix_ref_t hessian) const;
+
+  /**
+   * In-place version of the weighted hessian. See getFunctionValue for the requirements on the output.
+   *
+   * @param [in] w: vector of weights of size rangeDim
+   * @param [in] x : input vector of size variableDim
+   * @param [in] p : parameter vector of size parameterDim
+   * @param [out] hessian : dd/dxdx(sum_i  w_i*f_i(x,p) ) of size variableDim x variableDim
+   */
+  void getHessian(dynamic_vector_const_ref_t w, dynamic_vector_const_ref_t x, dynamic_vector_const_ref_t p,
+                  dynamic_matrix_ref_t hessian) const;
+
  private:
   /**
    * Defines library folder names
    */
   void setFolderNames();
 
+  /**
+   * Concatenates the variables and parameters into a thread local buffer.
+   *
+   * @param [in] x : input vector of size variableDim
+   * @param [in] p : parameter vector of size parameterDim
+   * @return view on [x; p], valid until the next call on the same thread.
+   */
+  CppAD::cg::ArrayView<const scalar_t> concatenateInput(dynamic_vector_const_ref_t x, dynamic_vector_const_ref_t p) const;
+
   /**
    * Creates folders on disk
    */
@@ -125,13 +125,8 @@ void CppAdInterface<scalar_t>::loadModelsIfAvailable(ApproximationOrder approxim
 template <typename scalar_t>
 typename CppAdInterface<scalar_t>::dynamic_vector_t CppAdInterface<scalar_t>::getFunctionValue(const dynamic_vector_t& x,
                                                                                                const dynamic_vector_t& p) const {
-  dynamic_vector_t xp(variableDim_ + parameterDim_);
-  xp << x, p;
-
   dynamic_vector_t functionValue(rangeDim_);
-
-  model_->ForwardZero(xp, functionValue);
-  assert(functionValue.allFinite());
+  getFunctionValue(x, p, functionValue);
   return functionValue;
 }
 
@@ -141,54 +136,95 @@ typename CppAdInterface<scalar_t>::dynamic_vector_t CppAdInterface<scalar_t>::ge
 template <typename scalar_t>
 typename CppAdInterface<scalar_t>::dynamic_matrix_t CppAdInterface<scalar_t>::getJacobian(const dynamic_vector_t& x,
                                                                                           const dynamic_vector_t& p) const {
-  // Concatenate input
-  dynamic_vector_t xp(variableDim_ + parameterDim_);
-  xp << x, p;
-  CppAD::cg::ArrayView<scalar_t> xpArrayView(xp.data(), xp.size());
+  dynamic_matrix_t jacobian(rangeDim_, variableDim_);
+  getJacobian(x, p, jacobian);
+  return jacobian;
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+template <typename scalar_t>
+typename CppAdInterface<scalar_t>::dynamic_matrix_t CppAdInterface<scalar_t>::getHessian(size_t outputIndex, const dynamic_vector_t& x,
+                                                                                         const dynamic_vector_t& p) const {
+  dynamic_matrix_t hessian(variableDim_, variableDim_);
+  getHessian(outputIndex, x, p, hessian);
+  return hessian;
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+template <typename scalar_t>
+typename CppAdInterface<scalar_t>::dynamic_matrix_t CppAdInterface<scalar_t>::getHessian(const dynamic_vector_t& w,
+                                                                                         const dynamic_vector_t& x,
+                                                                                         const dynamic_vector_t& p) const {
+  dynamic_matrix_t hessian(variableDim_, variableDim_);
+  getHessian(w, x, p, hessian);
+  return hessian;
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+template <typename scalar_t>
+void CppAdInterface<scalar_t>::getFunctionValue(dynamic_vector_const_ref_t x, dynamic_vector_const_ref_t p,
+                                                dynamic_vector_ref_t functionValue) const {
+  assert(functionValue.size() == rangeDim_);
+  CppAD::cg::ArrayView<scalar_t> functionValueArrayView(functionValue.data(), functionValue.size());
+
+  model_->ForwardZero(concatenateInput(x, p), functionValueArrayView);
+  assert(functionValue.allFinite());
+}
 
-  std::vector<scalar_t> sparseJacobian(nnzJacobian_);
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+template <typename scalar_t>
+void CppAdInterface<scalar_t>::getJacobian(dynamic_vector_const_ref_t x, dynamic_vector_const_ref_t p, dynamic_matrix_ref_t jacobian) const {
+  assert(jacobian.rows() == rangeDim_ && jacobian.cols() == variableDim_);
+
+  thread_local std::vector<scalar_t> sparseJacobian;
+  sparseJacobian.resize(nnzJacobian_);
   CppAD::cg::ArrayView<scalar_t> sparseJacobianArrayView(sparseJacobian);
   size_t const* rows;
   size_t const* cols;
   // Call this particular SparseJacobian. Other CppAd functions allocate internal vectors that are incompatible with multithreading.
-  model_->SparseJacobian(xpArrayView, sparseJacobianArrayView, &rows, &cols);
+  model_->SparseJacobian(concatenateInput(x, p), sparseJacobianArrayView, &rows, &cols);
 
   // Write sparse elements into Eigen type. Only jacobian w.r.t. variables was requested, so cols should not contain elements corresponding
-  // to parameters. Write to rowMajor type because sparsity is specified as row major.
-  dynamic_rowMajor_matrix_t jacobian = dynamic_rowMajor_matrix_t::Zero(rangeDim_, variableDim_);
+  // to parameters.
+  jacobian.setZero();
   for (size_t i = 0; i < nnzJacobian_; i++) {
     jacobian(rows[i], cols[i]) = sparseJacobian[i];
   }
 
   assert(jacobian.allFinite());
-  return jacobian;
 }
 
 /******************************************************************************************************/
 /******************************************************************************************************/
 /******************************************************************************************************/
 template <typename scalar_t>
-typename CppAdInterface<scalar_t>::dynamic_matrix_t CppAdInterface<scalar_t>::getHessian(size_t outputIndex, const dynamic_vector_t& x,
-                                                                                         const dynamic_vector_t& p) const {
-  dynamic_vector_t w = dynamic_vector_t::Zero(rangeDim_);
+void CppAdInterface<scalar_t>::getHessian(size_t outputIndex, dynamic_vector_const_ref_t x, dynamic_vector_const_ref_t p,
+                                          dynamic_matrix_ref_t hessian) const {
+  thread_local std::vector<scalar_t> w;
+  w.assign(rangeDim_, 0.0);
   w[outputIndex] = 1.0;
 
-  return getHessian(w, x, p);
+  getHessian(Eigen::Map<const dynamic_vector_t>(w.data(), rangeDim_), x, p, hessian);
 }
 
 /******************************************************************************************************/
 /******************************************************************************************************/
 /******************************************************************************************************/
 template <typename scalar_t>
-typename CppAdInterface<scalar_t>::dynamic_matrix_t CppAdInterface<scalar_t>::getHessian(const dynamic_vector_t& w,
-                                                                                         const dynamic_vector_t& x,
-                                                                                         const dynamic_vector_t& p) const {
-  // Concatenate input
-  dynamic_vector_t xp(variableDim_ + parameterDim_);
-  xp << x, p;
-  CppAD::cg::ArrayView<const scalar_t> xpArrayView(xp.data(), xp.size());
+void CppAdInterface<scalar_t>::getHessian(dynamic_vector_const_ref_t w, dynamic_vector_const_ref_t x, dynamic_vector_const_ref_t p,
+                                          dynamic_matrix_ref_t hessian) const {
+  assert(hessian.rows() == variableDim_ && hessian.cols() == variableDim_);
 
-  std::vector<scalar_t> sparseHessian(nnzHessian_);
+  thread_local std::vector<scalar_t> sparseHessian;
+  sparseHessian.resize(nnzHessian_);
   CppAD::cg::ArrayView<scalar_t> sparseHessianArrayView(sparseHessian);
   size_t const* rows;
   size_t const* cols;
@@ -196,10 +232,10 @@ typename CppAdInterface<scalar_t>::dynamic_matrix_t CppAdInterface<scalar_t>::ge
   CppAD::cg::ArrayView<const scalar_t> wArrayView(w.data(), w.size());
 
   // Call this particular SparseHessian. Other CppAd functions allocate internal vectors that are incompatible with multithreading.
-  model_->SparseHessian(xpArrayView, wArrayView, sparseHessianArrayView, &rows, &cols);
+  model_->SparseHessian(concatenateInput(x, p), wArrayView, sparseHessianArrayView, &rows, &cols);
 
-  // Fills upper triangular sparsity of hessian w.r.t variables. Write to rowMajor type because sparsity is specified as row major.
-  dynamic_rowMajor_matrix_t hessian = dynamic_rowMajor_matrix_t::Zero(variableDim_, variableDim_);
+  // Fills upper triangular sparsity of hessian w.r.t variables.
+  hessian.setZero();
   for (size_t i = 0; i < nnzHessian_; i++) {
     hessian(rows[i], cols[i]) = sparseHessian[i];
   }
@@ -208,7 +244,22 @@ typename CppAdInterface<scalar_t>::dynamic_matrix_t CppAdInterface<scalar_t>::ge
   hessian.template triangularView<Eigen::StrictlyLower>() = hessian.template triangularView<Eigen::StrictlyUpper>().transpose();
 
   assert(hessian.allFinite());
-  return hessian;
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+template <typename scalar_t>
+CppAD::cg::ArrayView<const scalar_t> CppAdInterface<scalar_t>::concatenateInput(dynamic_vector_const_ref_t x,
+                                                                                dynamic_vector_const_ref_t p) const {
+  assert(x.size() == variableDim_ && p.size() == parameterDim_);
+
+  // The buffer only grows, it is shared by all models evaluated on this thread.
+  thread_local std::vector<scalar_t> xp;
+  xp.resize(variableDim_ + parameterDim_);
+  std::copy(x.data(), x.data() + variableDim_, xp.begin());
+  std::copy(p.data(), p.data() + parameterDim_, xp.begin() + variableDim_);
+  return CppAD::cg::ArrayView<const scalar_t>(xp.data(), xp.size());
 }
 
 /******************************************************************************************************/
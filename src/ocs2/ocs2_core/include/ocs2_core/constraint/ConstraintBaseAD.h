@@ -72,6 +72,8 @@ class ConstraintBaseAD : public ConstraintBase<STATE_DIM, INPUT_DIM> {
   using ad_dynamic_vector_t = typename ad_interface_t::ad_dynamic_vector_t;
   using dynamic_vector_t = typename ad_interface_t::dynamic_vector_t;
 
+  using timeStateInput_vector_t = Eigen::Matrix<scalar_t, 1 + STATE_DIM + INPUT_DIM, 1>;
+  using timeState_vector_t = Eigen::Matrix<scalar_t, 1 + STATE_DIM, 1>;
   using constraint_timeStateInput_matrix_t = Eigen::Matrix<scalar_t, -1, 1 + STATE_DIM + INPUT_DIM>;
   using constraint_timeState_matrix_t = Eigen::Matrix<scalar_t, -1, 1 + STATE_DIM>;
 
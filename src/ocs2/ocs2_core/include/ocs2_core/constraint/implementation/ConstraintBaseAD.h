@@ -68,19 +68,24 @@ void ConstraintBaseAD<STATE_DIM, INPUT_DIM>::setCurrentStateAndControl(const sca
                                                                        const input_vector_t& u) {
   BASE::setCurrentStateAndControl(t, x, u);
 
-  dynamic_vector_t tapedTimeStateInput(1 + STATE_DIM + INPUT_DIM);
+  timeStateInput_vector_t tapedTimeStateInput;
   tapedTimeStateInput << t, x, u;
 
-  dynamic_vector_t tapedTimeState(1 + STATE_DIM);
+  timeState_vector_t tapedTimeState;
   tapedTimeState << t, x;
 
-  stateInputValues_ = stateInputADInterfacePtr_->getFunctionValue(tapedTimeStateInput);
-  stateOnlyValues_ = stateOnlyADInterfacePtr_->getFunctionValue(tapedTimeState);
-  stateOnlyFinalValues_ = stateOnlyFinalADInterfacePtr_->getFunctionValue(tapedTimeState);
+  stateInputADInterfacePtr_->getFunctionValue(tapedTimeStateInput, dynamic_vector_t(), stateInputValues_);
+  stateOnlyADInterfacePtr_->getFunctionValue(tapedTimeState, dynamic_vector_t(), stateOnlyValues_);
+  stateOnlyFinalADInterfacePtr_->getFunctionValue(tapedTimeState, dynamic_vector_t(), stateOnlyFinalValues_);
 
-  stateInputJacobian_ = stateInputADInterfacePtr_->getJacobian(tapedTimeStateInput);
-  stateOnlyJacobian_ = stateOnlyADInterfacePtr_->getJacobian(tapedTimeState);
-  stateOnlyFinalJacobian_ = stateOnlyFinalADInterfacePtr_->getJacobian(tapedTimeState);
+  // No-ops after the first call
+  stateInputJacobian_.resize(MAX_CONSTRAINT_DIM_, Eigen::NoChange);
+  stateOnlyJacobian_.resize(MAX_CONSTRAINT_DIM_, Eigen::NoChange);
+  stateOnlyFinalJacobian_.resize(MAX_CONSTRAINT_DIM_, Eigen::NoChange);
+
+  stateInputADInterfacePtr_->getJacobian(tapedTimeStateInput, dynamic_vector_t(), stateInputJacobian_);
+  stateOnlyADInterfacePtr_->getJacobian(tapedTimeState, dynamic_vector_t(), stateOnlyJacobian_);
+  stateOnlyFinalADInterfacePtr_->getJacobian(tapedTimeState, dynamic_vector_t(), stateOnlyFinalJacobian_);
 }
 
 /******************************************************************************************************/
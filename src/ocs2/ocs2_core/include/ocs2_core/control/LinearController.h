@@ -129,8 +129,20 @@ class LinearController final : public ControllerBase<STATE_DIM, INPUT_DIM> {
   }
 
   input_vector_t computeInput(const scalar_t& t, const state_vector_t& x) override {
+    return computeInputAtTimeSegment(EigenLinearInterpolation<input_vector_t>::timeSegment(t, &timeStamp_), x);
+  }
+
+  /**
+   * Computes the control input at a time segment of timeStamp_ which is already looked up by the caller, e.g. with a hinted
+   * EigenLinearInterpolation::timeSegment() or shared with another trajectory on the same time stamps.
+   *
+   * @param [in] indexAlpha: The interval index and the interpolation coefficient in timeStamp_.
+   * @param [in] x: Current state.
+   * @return The control input.
+   */
+  input_vector_t computeInputAtTimeSegment(std::pair<int, scalar_t> indexAlpha, const state_vector_t& x) const {
     input_vector_t uff;
-    const auto indexAlpha = EigenLinearInterpolation<input_vector_t>::interpolate(t, uff, &timeStamp_, &biasArray_);
+    EigenLinearInterpolation<input_vector_t>::interpolate(indexAlpha, uff, &biasArray_);
 
     input_state_matrix_t k;
     EigenLinearInterpolation<input_state_matrix_t>::interpolate(indexAlpha, k, &gainArray_);
@@ -86,8 +86,7 @@ void CostFunctionBaseAD<STATE_DIM, INPUT_DIM>::setCurrentStateAndControl(const s
 /******************************************************************************************************/
 template <size_t STATE_DIM, size_t INPUT_DIM>
 void CostFunctionBaseAD<STATE_DIM, INPUT_DIM>::getIntermediateCost(scalar_t& L) {
-  auto costValue = intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_);
-  L = costValue(0);
+  intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_, Eigen::Map<dynamic_vector_t>(&L, 1));
 }
 
 /******************************************************************************************************/
@@ -96,8 +95,8 @@ void CostFunctionBaseAD<STATE_DIM, INPUT_DIM>::getIntermediateCost(scalar_t& L)
 template <size_t STATE_DIM, size_t INPUT_DIM>
 void CostFunctionBaseAD<STATE_DIM, INPUT_DIM>::getIntermediateCostDerivativeTime(scalar_t& dLdt) {
   if (!intermediateDerivativesComputed_) {
-    intermediateJacobian_ = intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_);
-    intermediateHessian_ = intermediateADInterfacePtr_->getHessian(0, tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_, intermediateJacobian_);
+    intermediateADInterfacePtr_->getHessian(0, tapedTimeStateInput_, intermediateParameters_, intermediateHessian_);
     intermediateDerivativesComputed_ = true;
   }
   dLdt = intermediateJacobian_(0);
@@ -109,8 +108,8 @@ void CostFunctionBaseAD<STATE_DIM, INPUT_DIM>::getIntermediateCostDerivativeTime
 template <size_t STATE_DIM, size_t INPUT_DIM>
 void CostFunctionBaseAD<STATE_DIM, INPUT_DIM>::getIntermediateCostDerivativeState(state_vector_t& dLdx) {
   if (!intermediateDerivativesComputed_) {
-    intermediateJacobian_ = intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_);
-    intermediateHessian_ = intermediateADInterfacePtr_->getHessian(0, tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_, intermediateJacobian_);
+    intermediateADInterfacePtr_->getHessian(0, tapedTimeStateInput_, intermediateParameters_, intermediateHessian_);
     intermediateDerivativesComputed_ = true;
   }
   dLdx = intermediateJacobian_.template segment<STATE_DIM>(1).transpose();
@@ -122,8 +121,8 @@ void CostFunctionBaseAD<STATE_DIM, INPUT_DIM>::getIntermediateCostDerivativeStat
 template <size_t STATE_DIM, size_t INPUT_DIM>
 void CostFunctionBaseAD<STATE_DIM, INPUT_DIM>::getIntermediateCostSecondDerivativeState(state_matrix_t& dLdxx) {
   if (!intermediateDerivativesComputed_) {
-    intermediateJacobian_ = intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_);
-    intermediateHessian_ = intermediateADInterfacePtr_->getHessian(0, tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_, intermediateJacobian_);
+    intermediateADInterfacePtr_->getHessian(0, tapedTimeStateInput_, intermediateParameters_, intermediateHessian_);
     intermediateDerivativesComputed_ = true;
   }
   dLdxx = intermediateHessian_.template block<STATE_DIM, STATE_DIM>(1, 1);
@@ -135,8 +134,8 @@ void CostFunctionBaseAD<STATE_DIM, INPUT_DIM>::getIntermediateCostSecondDerivati
 template <size_t STATE_DIM, size_t INPUT_DIM>
 void CostFunctionBaseAD<STATE_DIM, INPUT_DIM>::getIntermediateCostDerivativeInput(input_vector_t& dLdu) {
   if (!intermediateDerivativesComputed_) {
-    intermediateJacobian_ = intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_);
-    intermediateHessian_ = intermediateADInterfacePtr_->getHessian(0, tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_, intermediateJacobian_);
+    intermediateADInterfacePtr_->getHessian(0, tapedTimeStateInput_, intermediateParameters_, intermediateHessian_);
     intermediateDerivativesComputed_ = true;
   }
   dLdu = intermediateJacobian_.template segment<INPUT_DIM>(1 + STATE_DIM).transpose();
@@ -148,8 +147,8 @@ void CostFunctionBaseAD<STATE_DIM, INPUT_DIM>::getIntermediateCostDerivativeInpu
 template <size_t STATE_DIM, size_t INPUT_DIM>
 void CostFunctionBaseAD<STATE_DIM, INPUT_DIM>::getIntermediateCostSecondDerivativeInput(input_matrix_t& dLduu) {
   if (!intermediateDerivativesComputed_) {
-    intermediateJacobian_ = intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_);
-    intermediateHessian_ = intermediateADInterfacePtr_->getHessian(0, tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_, intermediateJacobian_);
+    intermediateADInterfacePtr_->getHessian(0, tapedTimeStateInput_, intermediateParameters_, intermediateHessian_);
     intermediateDerivativesComputed_ = true;
   }
   dLduu = intermediateHessian_.template block<INPUT_DIM, INPUT_DIM>(1 + STATE_DIM, 1 + STATE_DIM);
@@ -161,8 +160,8 @@ void CostFunctionBaseAD<STATE_DIM, INPUT_DIM>::getIntermediateCostSecondDerivati
 template <size_t STATE_DIM, size_t INPUT_DIM>
 void CostFunctionBaseAD<STATE_DIM, INPUT_DIM>::getIntermediateCostDerivativeInputState(input_state_matrix_t& dLdux) {
   if (!intermediateDerivativesComputed_) {
-    intermediateJacobian_ = intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_);
-    intermediateHessian_ = intermediateADInterfacePtr_->getHessian(0, tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_, intermediateJacobian_);
+    intermediateADInterfacePtr_->getHessian(0, tapedTimeStateInput_, intermediateParameters_, intermediateHessian_);
     intermediateDerivativesComputed_ = true;
   }
   dLdux = intermediateHessian_.template block<INPUT_DIM, STATE_DIM>(1 + STATE_DIM, 1);
@@ -173,8 +172,7 @@ void CostFunctionBaseAD<STATE_DIM, INPUT_DIM>::getIntermediateCostDerivativeInpu
 /******************************************************************************************************/
 template <size_t STATE_DIM, size_t INPUT_DIM>
 void CostFunctionBaseAD<STATE_DIM, INPUT_DIM>::getTerminalCost(scalar_t& Phi) {
-  auto costValue = terminalADInterfacePtr_->getFunctionValue(tapedTimeState_, terminalParameters_);
-  Phi = costValue(0);
+  terminalADInterfacePtr_->getFunctionValue(tapedTimeState_, terminalParameters_, Eigen::Map<dynamic_vector_t>(&Phi, 1));
 }
 
 /******************************************************************************************************/
@@ -183,8 +181,8 @@ void CostFunctionBaseAD<STATE_DIM, INPUT_DIM>::getTerminalCost(scalar_t& Phi) {
 template <size_t STATE_DIM, size_t INPUT_DIM>
 void CostFunctionBaseAD<STATE_DIM, INPUT_DIM>::getTerminalCostDerivativeTime(scalar_t& dPhidt) {
   if (!terminalDerivativesComputed_) {
-    terminalJacobian_ = terminalADInterfacePtr_->getJacobian(tapedTimeState_, terminalParameters_);
-    terminalHessian_ = terminalADInterfacePtr_->getHessian(0, tapedTimeState_, terminalParameters_);
+    terminalADInterfacePtr_->getJacobian(tapedTimeState_, terminalParameters_, terminalJacobian_);
+    terminalADInterfacePtr_->getHessian(0, tapedTimeState_, terminalParameters_, terminalHessian_);
     terminalDerivativesComputed_ = true;
   }
   dPhidt = terminalJacobian_(0);
@@ -196,8 +194,8 @@ void CostFunctionBaseAD<STATE_DIM, INPUT_DIM>::getTerminalCostDerivativeTime(sca
 template <size_t STATE_DIM, size_t INPUT_DIM>
 void CostFunctionBaseAD<STATE_DIM, INPUT_DIM>::getTerminalCostDerivativeState(state_vector_t& dPhidx) {
   if (!terminalDerivativesComputed_) {
-    terminalJacobian_ = terminalADInterfacePtr_->getJacobian(tapedTimeState_, terminalParameters_);
-    terminalHessian_ = terminalADInterfacePtr_->getHessian(0, tapedTimeState_, terminalParameters_);
+    terminalADInterfacePtr_->getJacobian(tapedTimeState_, terminalParameters_, terminalJacobian_);
+    terminalADInterfacePtr_->getHessian(0, tapedTimeState_, terminalParameters_, terminalHessian_);
     terminalDerivativesComputed_ = true;
   }
   dPhidx = terminalJacobian_.template segment<STATE_DIM>(1).transpose();
@@ -209,8 +207,8 @@ void CostFunctionBaseAD<STATE_DIM, INPUT_DIM>::getTerminalCostDerivativeState(st
 template <size_t STATE_DIM, size_t INPUT_DIM>
 void CostFunctionBaseAD<STATE_DIM, INPUT_DIM>::getTerminalCostSecondDerivativeState(state_matrix_t& dPhidxx) {
   if (!terminalDerivativesComputed_) {
-    terminalJacobian_ = terminalADInterfacePtr_->getJacobian(tapedTimeState_, terminalParameters_);
-    terminalHessian_ = terminalADInterfacePtr_->getHessian(0, tapedTimeState_, terminalParameters_);
+    terminalADInterfacePtr_->getJacobian(tapedTimeState_, terminalParameters_, terminalJacobian_);
+    terminalADInterfacePtr_->getHessian(0, tapedTimeState_, terminalParameters_, terminalHessian_);
     terminalDerivativesComputed_ = true;
   }
   dPhidxx = terminalHessian_.template block<STATE_DIM, STATE_DIM>(1, 1);
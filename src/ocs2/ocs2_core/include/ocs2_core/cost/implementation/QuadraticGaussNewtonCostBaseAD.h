@@ -95,7 +95,7 @@ void QuadraticGaussNewtonCostBaseAD<STATE_DIM, INPUT_DIM, INTERMEDIATE_COST_DIM,
 template <size_t STATE_DIM, size_t INPUT_DIM, size_t INTERMEDIATE_COST_DIM, size_t TERMINAL_COST_DIM>
 void QuadraticGaussNewtonCostBaseAD<STATE_DIM, INPUT_DIM, INTERMEDIATE_COST_DIM, TERMINAL_COST_DIM>::getIntermediateCost(scalar_t& L) {
   if (!intermediateCostValuesComputed_) {
-    intermediateCostValues_ = intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_, intermediateCostValues_);
     intermediateCostValuesComputed_ = true;
   }
   L = 0.5 * intermediateCostValues_.dot(intermediateCostValues_);
@@ -108,11 +108,11 @@ template <size_t STATE_DIM, size_t INPUT_DIM, size_t INTERMEDIATE_COST_DIM, size
 void QuadraticGaussNewtonCostBaseAD<STATE_DIM, INPUT_DIM, INTERMEDIATE_COST_DIM, TERMINAL_COST_DIM>::getIntermediateCostDerivativeTime(
     scalar_t& dLdt) {
   if (!intermediateDerivativesComputed_) {
-    intermediateJacobian_ = intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_, intermediateJacobian_);
     intermediateDerivativesComputed_ = true;
   }
   if (!intermediateCostValuesComputed_) {
-    intermediateCostValues_ = intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_, intermediateCostValues_);
     intermediateCostValuesComputed_ = true;
   }
   dLdt = intermediateCostValues_.transpose() * intermediateJacobian_.col(0);
@@ -125,11 +125,11 @@ template <size_t STATE_DIM, size_t INPUT_DIM, size_t INTERMEDIATE_COST_DIM, size
 void QuadraticGaussNewtonCostBaseAD<STATE_DIM, INPUT_DIM, INTERMEDIATE_COST_DIM, TERMINAL_COST_DIM>::getIntermediateCostDerivativeState(
     state_vector_t& dLdx) {
   if (!intermediateDerivativesComputed_) {
-    intermediateJacobian_ = intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_, intermediateJacobian_);
     intermediateDerivativesComputed_ = true;
   }
   if (!intermediateCostValuesComputed_) {
-    intermediateCostValues_ = intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_, intermediateCostValues_);
     intermediateCostValuesComputed_ = true;
   }
   dLdx = intermediateJacobian_.template block<INTERMEDIATE_COST_DIM, STATE_DIM>(0, 1).transpose() * intermediateCostValues_;
@@ -142,11 +142,11 @@ template <size_t STATE_DIM, size_t INPUT_DIM, size_t INTERMEDIATE_COST_DIM, size
 void QuadraticGaussNewtonCostBaseAD<STATE_DIM, INPUT_DIM, INTERMEDIATE_COST_DIM,
                                     TERMINAL_COST_DIM>::getIntermediateCostSecondDerivativeState(state_matrix_t& dLdxx) {
   if (!intermediateDerivativesComputed_) {
-    intermediateJacobian_ = intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_, intermediateJacobian_);
     intermediateDerivativesComputed_ = true;
   }
   if (!intermediateCostValuesComputed_) {
-    intermediateCostValues_ = intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_, intermediateCostValues_);
     intermediateCostValuesComputed_ = true;
   }
   dLdxx = intermediateJacobian_.template block<INTERMEDIATE_COST_DIM, STATE_DIM>(0, 1).transpose() *
@@ -160,11 +160,11 @@ template <size_t STATE_DIM, size_t INPUT_DIM, size_t INTERMEDIATE_COST_DIM, size
 void QuadraticGaussNewtonCostBaseAD<STATE_DIM, INPUT_DIM, INTERMEDIATE_COST_DIM, TERMINAL_COST_DIM>::getIntermediateCostDerivativeInput(
     input_vector_t& dLdu) {
   if (!intermediateDerivativesComputed_) {
-    intermediateJacobian_ = intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_, intermediateJacobian_);
     intermediateDerivativesComputed_ = true;
   }
   if (!intermediateCostValuesComputed_) {
-    intermediateCostValues_ = intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_, intermediateCostValues_);
     intermediateCostValuesComputed_ = true;
   }
   dLdu = intermediateJacobian_.template block<INTERMEDIATE_COST_DIM, INPUT_DIM>(0, 1 + STATE_DIM).transpose() * intermediateCostValues_;
@@ -177,11 +177,11 @@ template <size_t STATE_DIM, size_t INPUT_DIM, size_t INTERMEDIATE_COST_DIM, size
 void QuadraticGaussNewtonCostBaseAD<STATE_DIM, INPUT_DIM, INTERMEDIATE_COST_DIM,
                                     TERMINAL_COST_DIM>::getIntermediateCostSecondDerivativeInput(input_matrix_t& dLduu) {
   if (!intermediateDerivativesComputed_) {
-    intermediateJacobian_ = intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_, intermediateJacobian_);
     intermediateDerivativesComputed_ = true;
   }
   if (!intermediateCostValuesComputed_) {
-    intermediateCostValues_ = intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_, intermediateCostValues_);
     intermediateCostValuesComputed_ = true;
   }
   dLduu = intermediateJacobian_.template block<INTERMEDIATE_COST_DIM, INPUT_DIM>(0, 1 + STATE_DIM).transpose() *
@@ -195,7 +195,7 @@ template <size_t STATE_DIM, size_t INPUT_DIM, size_t INTERMEDIATE_COST_DIM, size
 void QuadraticGaussNewtonCostBaseAD<STATE_DIM, INPUT_DIM, INTERMEDIATE_COST_DIM,
                                     TERMINAL_COST_DIM>::getIntermediateCostDerivativeInputState(input_state_matrix_t& dLdux) {
   if (!intermediateDerivativesComputed_) {
-    intermediateJacobian_ = intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_, intermediateJacobian_);
     intermediateDerivativesComputed_ = true;
   }
   dLdux = intermediateJacobian_.template block<INTERMEDIATE_COST_DIM, INPUT_DIM>(0, 1 + STATE_DIM).transpose() *
@@ -208,7 +208,7 @@ void QuadraticGaussNewtonCostBaseAD<STATE_DIM, INPUT_DIM, INTERMEDIATE_COST_DIM,
 template <size_t STATE_DIM, size_t INPUT_DIM, size_t INTERMEDIATE_COST_DIM, size_t TERMINAL_COST_DIM>
 void QuadraticGaussNewtonCostBaseAD<STATE_DIM, INPUT_DIM, INTERMEDIATE_COST_DIM, TERMINAL_COST_DIM>::getTerminalCost(scalar_t& Phi) {
   if (terminalCostValuesComputed_) {
-    terminalCostValues_ = terminalADInterfacePtr_->getFunctionValue(tapedTimeState_, terminalParameters_);
+    terminalADInterfacePtr_->getFunctionValue(tapedTimeState_, terminalParameters_, terminalCostValues_);
     terminalCostValuesComputed_ = true;
   }
   Phi = 0.5 * terminalCostValues_.dot(terminalCostValues_);
@@ -221,11 +221,11 @@ template <size_t STATE_DIM, size_t INPUT_DIM, size_t INTERMEDIATE_COST_DIM, size
 void QuadraticGaussNewtonCostBaseAD<STATE_DIM, INPUT_DIM, INTERMEDIATE_COST_DIM, TERMINAL_COST_DIM>::getTerminalCostDerivativeTime(
     scalar_t& dPhidt) {
   if (!terminalDerivativesComputed_) {
-    terminalJacobian_ = terminalADInterfacePtr_->getJacobian(tapedTimeState_, terminalParameters_);
+    terminalADInterfacePtr_->getJacobian(tapedTimeState_, terminalParameters_, terminalJacobian_);
     terminalDerivativesComputed_ = true;
   }
   if (terminalCostValuesComputed_) {
-    terminalCostValues_ = terminalADInterfacePtr_->getFunctionValue(tapedTimeState_, terminalParameters_);
+    terminalADInterfacePtr_->getFunctionValue(tapedTimeState_, terminalParameters_, terminalCostValues_);
     terminalCostValuesComputed_ = true;
   }
   dPhidt = terminalCostValues_.transpose() * terminalJacobian_.col(0);
@@ -238,11 +238,11 @@ template <size_t STATE_DIM, size_t INPUT_DIM, size_t INTERMEDIATE_COST_DIM, size
 void QuadraticGaussNewtonCostBaseAD<STATE_DIM, INPUT_DIM, INTERMEDIATE_COST_DIM, TERMINAL_COST_DIM>::getTerminalCostDerivativeState(
     state_vector_t& dPhidx) {
   if (!terminalDerivativesComputed_) {
-    terminalJacobian_ = terminalADInterfacePtr_->getJacobian(tapedTimeState_, terminalParameters_);
+    terminalADInterfacePtr_->getJacobian(tapedTimeState_, terminalParameters_, terminalJacobian_);
     terminalDerivativesComputed_ = true;
   }
   if (terminalCostValuesComputed_) {
-    terminalCostValues_ = terminalADInterfacePtr_->getFunctionValue(tapedTimeState_, terminalParameters_);
+    terminalADInterfacePtr_->getFunctionValue(tapedTimeState_, terminalParameters_, terminalCostValues_);
     terminalCostValuesComputed_ = true;
   }
   dPhidx = terminalJacobian_.template block<TERMINAL_COST_DIM, STATE_DIM>(0, 1).transpose() * terminalCostValues_;
@@ -255,11 +255,11 @@ template <size_t STATE_DIM, size_t INPUT_DIM, size_t INTERMEDIATE_COST_DIM, size
 void QuadraticGaussNewtonCostBaseAD<STATE_DIM, INPUT_DIM, INTERMEDIATE_COST_DIM, TERMINAL_COST_DIM>::getTerminalCostSecondDerivativeState(
     state_matrix_t& dPhidxx) {
   if (!terminalDerivativesComputed_) {
-    terminalJacobian_ = terminalADInterfacePtr_->getJacobian(tapedTimeState_, terminalParameters_);
+    terminalADInterfacePtr_->getJacobian(tapedTimeState_, terminalParameters_, terminalJacobian_);
     terminalDerivativesComputed_ = true;
   }
   if (terminalCostValuesComputed_) {
-    terminalCostValues_ = terminalADInterfacePtr_->getFunctionValue(tapedTimeState_, terminalParameters_);
+    terminalADInterfacePtr_->getFunctionValue(tapedTimeState_, terminalParameters_, terminalCostValues_);
     terminalCostValuesComputed_ = true;
   }
   dPhidxx = terminalJacobian_.template block<TERMINAL_COST_DIM, STATE_DIM>(0, 1).transpose() *
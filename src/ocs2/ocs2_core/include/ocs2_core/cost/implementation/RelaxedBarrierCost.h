@@ -122,7 +122,7 @@ void RelaxedBarrierCost<STATE_DIM, INPUT_DIM, INTERMEDIATE_COST_DIM, TERMINAL_CO
   }
 
   if (!intermediateCostValuesComputed_) {
-    intermediateCostValues_ = intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_, intermediateCostValues_);
     intermediateCostValuesComputed_ = true;
   }
   for (int i = 0; i < INTERMEDIATE_COST_DIM; i++) {
@@ -141,11 +141,11 @@ void RelaxedBarrierCost<STATE_DIM, INPUT_DIM, INTERMEDIATE_COST_DIM, TERMINAL_CO
   }
 
   if (!intermediateDerivativesComputed_) {
-    intermediateJacobian_ = intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_, intermediateJacobian_);
     intermediateDerivativesComputed_ = true;
   }
   if (!intermediateCostValuesComputed_) {
-    intermediateCostValues_ = intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_, intermediateCostValues_);
     intermediateCostValuesComputed_ = true;
   }
 
@@ -168,11 +168,11 @@ void RelaxedBarrierCost<STATE_DIM, INPUT_DIM, INTERMEDIATE_COST_DIM, TERMINAL_CO
   }
 
   if (!intermediateDerivativesComputed_) {
-    intermediateJacobian_ = intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_, intermediateJacobian_);
     intermediateDerivativesComputed_ = true;
   }
   if (!intermediateCostValuesComputed_) {
-    intermediateCostValues_ = intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_, intermediateCostValues_);
     intermediateCostValuesComputed_ = true;
   }
 
@@ -195,11 +195,11 @@ void RelaxedBarrierCost<STATE_DIM, INPUT_DIM, INTERMEDIATE_COST_DIM, TERMINAL_CO
   }
 
   if (!intermediateDerivativesComputed_) {
-    intermediateJacobian_ = intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_, intermediateJacobian_);
     intermediateDerivativesComputed_ = true;
   }
   if (!intermediateCostValuesComputed_) {
-    intermediateCostValues_ = intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_, intermediateCostValues_);
     intermediateCostValuesComputed_ = true;
   }
 
@@ -223,11 +223,11 @@ void RelaxedBarrierCost<STATE_DIM, INPUT_DIM, INTERMEDIATE_COST_DIM, TERMINAL_CO
   }
 
   if (!intermediateDerivativesComputed_) {
-    intermediateJacobian_ = intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_, intermediateJacobian_);
     intermediateDerivativesComputed_ = true;
   }
   if (!intermediateCostValuesComputed_) {
-    intermediateCostValues_ = intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_, intermediateCostValues_);
     intermediateCostValuesComputed_ = true;
   }
 
@@ -250,11 +250,11 @@ void RelaxedBarrierCost<STATE_DIM, INPUT_DIM, INTERMEDIATE_COST_DIM, TERMINAL_CO
   }
 
   if (!intermediateDerivativesComputed_) {
-    intermediateJacobian_ = intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_, intermediateJacobian_);
     intermediateDerivativesComputed_ = true;
   }
   if (!intermediateCostValuesComputed_) {
-    intermediateCostValues_ = intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getFunctionValue(tapedTimeStateInput_, intermediateParameters_, intermediateCostValues_);
     intermediateCostValuesComputed_ = true;
   }
 
@@ -279,7 +279,7 @@ void RelaxedBarrierCost<STATE_DIM, INPUT_DIM, INTERMEDIATE_COST_DIM, TERMINAL_CO
   }
 
   if (!intermediateDerivativesComputed_) {
-    intermediateJacobian_ = intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_);
+    intermediateADInterfacePtr_->getJacobian(tapedTimeStateInput_, intermediateParameters_, intermediateJacobian_);
     intermediateDerivativesComputed_ = true;
   }
 
@@ -302,7 +302,7 @@ void RelaxedBarrierCost<STATE_DIM, INPUT_DIM, INTERMEDIATE_COST_DIM, TERMINAL_CO
   }
 
   if (!terminalCostValuesComputed_) {
-    terminalCostValues_ = terminalADInterfacePtr_->getFunctionValue(tapedTimeState_, terminalParameters_);
+    terminalADInterfacePtr_->getFunctionValue(tapedTimeState_, terminalParameters_, terminalCostValues_);
     terminalCostValuesComputed_ = true;
   }
 
@@ -322,11 +322,11 @@ void RelaxedBarrierCost<STATE_DIM, INPUT_DIM, INTERMEDIATE_COST_DIM, TERMINAL_CO
   }
 
   if (!terminalDerivativesComputed_) {
-    terminalJacobian_ = terminalADInterfacePtr_->getJacobian(tapedTimeState_, terminalParameters_);
+    terminalADInterfacePtr_->getJacobian(tapedTimeState_, terminalParameters_, terminalJacobian_);
     terminalDerivativesComputed_ = true;
   }
   if (!terminalCostValuesComputed_) {
-    terminalCostValues_ = terminalADInterfacePtr_->getFunctionValue(tapedTimeState_, terminalParameters_);
+    terminalADInterfacePtr_->getFunctionValue(tapedTimeState_, terminalParameters_, terminalCostValues_);
     terminalCostValuesComputed_ = true;
   }
 
@@ -349,11 +349,11 @@ void RelaxedBarrierCost<STATE_DIM, INPUT_DIM, INTERMEDIATE_COST_DIM, TERMINAL_CO
   }
 
   if (!terminalDerivativesComputed_) {
-    terminalJacobian_ = terminalADInterfacePtr_->getJacobian(tapedTimeState_, terminalParameters_);
+    terminalADInterfacePtr_->getJacobian(tapedTimeState_, terminalParameters_, terminalJacobian_);
     terminalDerivativesComputed_ = true;
   }
   if (!terminalCostValuesComputed_) {
-    terminalCostValues_ = terminalADInterfacePtr_->getFunctionValue(tapedTimeState_, terminalParameters_);
+    terminalADInterfacePtr_->getFunctionValue(tapedTimeState_, terminalParameters_, terminalCostValues_);
     terminalCostValuesComputed_ = true;
   }
 
@@ -376,11 +376,11 @@ void RelaxedBarrierCost<STATE_DIM, INPUT_DIM, INTERMEDIATE_COST_DIM, TERMINAL_CO
   }
 
   if (!terminalDerivativesComputed_) {
-    terminalJacobian_ = terminalADInterfacePtr_->getJacobian(tapedTimeState_, terminalParameters_);
+    terminalADInterfacePtr_->getJacobian(tapedTimeState_, terminalParameters_, terminalJacobian_);
     terminalDerivativesComputed_ = true;
   }
   if (!terminalCostValuesComputed_) {
-    terminalCostValues_ = terminalADInterfacePtr_->getFunctionValue(tapedTimeState_, terminalParameters_);
+    terminalADInterfacePtr_->getFunctionValue(tapedTimeState_, terminalParameters_, terminalCostValues_);
     terminalCostValuesComputed_ = true;
   }
 
@@ -66,6 +66,8 @@ class SystemDynamicsBaseAD : public SystemDynamicsBase<STATE_DIM, INPUT_DIM, NUM
   using ad_scalar_t = typename ad_interface_t::ad_scalar_t;
   using ad_dynamic_vector_t = typename ad_interface_t::ad_dynamic_vector_t;
 
+  using timeStateInput_vector_t = Eigen::Matrix<scalar_t, 1 + STATE_DIM + INPUT_DIM, 1>;
+  using timeState_vector_t = Eigen::Matrix<scalar_t, 1 + STATE_DIM, 1>;
   using state_timeStateInput_matrix_t = Eigen::Matrix<scalar_t, STATE_DIM, 1 + STATE_DIM + INPUT_DIM>;
   using state_timeState_matrix_t = Eigen::Matrix<scalar_t, STATE_DIM, 1 + STATE_DIM>;
   using mode_timeState_matrix_t = Eigen::Matrix<scalar_t, NUM_MODES, 1 + STATE_DIM>;
@@ -72,10 +72,10 @@ void SystemDynamicsBaseAD<STATE_DIM, INPUT_DIM, NUM_MODES>::initialize(const std
 template <size_t STATE_DIM, size_t INPUT_DIM, size_t NUM_MODES>
 void SystemDynamicsBaseAD<STATE_DIM, INPUT_DIM, NUM_MODES>::computeFlowMap(const scalar_t& time, const state_vector_t& state,
                                                                            const input_vector_t& input, state_vector_t& stateDerivative) {
-  dynamic_vector_t tapedInput(1 + STATE_DIM + INPUT_DIM);
+  timeStateInput_vector_t tapedInput;
   tapedInput << time, state, input;
 
-  stateDerivative = flowMapADInterfacePtr_->getFunctionValue(tapedInput);
+  flowMapADInterfacePtr_->getFunctionValue(tapedInput, dynamic_vector_t(), stateDerivative);
 }
 
 /******************************************************************************************************/
@@ -84,10 +84,10 @@ void SystemDynamicsBaseAD<STATE_DIM, INPUT_DIM, NUM_MODES>::computeFlowMap(const
 template <size_t STATE_DIM, size_t INPUT_DIM, size_t NUM_MODES>
 void SystemDynamicsBaseAD<STATE_DIM, INPUT_DIM, NUM_MODES>::computeJumpMap(const scalar_t& time, const state_vector_t& state,
                                                                            state_vector_t& jumpedState) {
-  dynamic_vector_t tapedInput(1 + STATE_DIM);
+  timeState_vector_t tapedInput;
   tapedInput << time, state;
 
-  jumpedState = jumpMapADInterfacePtr_->getFunctionValue(tapedInput);
+  jumpMapADInterfacePtr_->getFunctionValue(tapedInput, dynamic_vector_t(), jumpedState);
 }
 
 /******************************************************************************************************/
@@ -96,10 +96,11 @@ void SystemDynamicsBaseAD<STATE_DIM, INPUT_DIM, NUM_MODES>::computeJumpMap(const
 template <size_t STATE_DIM, size_t INPUT_DIM, size_t NUM_MODES>
 void SystemDynamicsBaseAD<STATE_DIM, INPUT_DIM, NUM_MODES>::computeGuardSurfaces(const scalar_t& time, const state_vector_t& state,
                                                                                  dynamic_vector_t& guardSurfacesValue) {
-  dynamic_vector_t tapedInput(1 + STATE_DIM);
+  timeState_vector_t tapedInput;
   tapedInput << time, state;
 
-  guardSurfacesValue = guardSurfacesADInterfacePtr_->getFunctionValue(tapedInput);
+  guardSurfacesValue.resize(NUM_MODES);
+  guardSurfacesADInterfacePtr_->getFunctionValue(tapedInput, dynamic_vector_t(), guardSurfacesValue);
 }
 
 /******************************************************************************************************/
@@ -110,15 +111,15 @@ void SystemDynamicsBaseAD<STATE_DIM, INPUT_DIM, NUM_MODES>::setCurrentStateAndCo
                                                                                       const input_vector_t& input) {
   BASE::setCurrentStateAndControl(time, state, input);
 
-  dynamic_vector_t tapedTimeStateInput(1 + STATE_DIM + INPUT_DIM);
+  timeStateInput_vector_t tapedTimeStateInput;
   tapedTimeStateInput << time, state, input;
 
-  dynamic_vector_t tapedTimeState(1 + STATE_DIM);
+  timeState_vector_t tapedTimeState;
   tapedTimeState << time, state;
 
-  flowJacobian_ = flowMapADInterfacePtr_->getJacobian(tapedTimeStateInput);
-  jumpJacobian_ = jumpMapADInterfacePtr_->getJacobian(tapedTimeState);
-  guardJacobian_ = guardSurfacesADInterfacePtr_->getJacobian(tapedTimeState);
+  flowMapADInterfacePtr_->getJacobian(tapedTimeStateInput, dynamic_vector_t(), flowJacobian_);
+  jumpMapADInterfacePtr_->getJacobian(tapedTimeState, dynamic_vector_t(), jumpJacobian_);
+  guardSurfacesADInterfacePtr_->getJacobian(tapedTimeState, dynamic_vector_t(), guardJacobian_);
 }
 
 /******************************************************************************************************/
@@ -30,6 +30,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef OCS2_CTRL_LINEARALGEBRA_H
 #define OCS2_CTRL_LINEARALGEBRA_H
 
+#include <stdexcept>
+
 #include <Eigen/Dense>
 
 namespace ocs2 {
@@ -46,11 +48,31 @@ bool makePSD(Eigen::MatrixXd& squareMatrix);
 
 template <typename Derived>
 bool makePSD(Eigen::MatrixBase<Derived>& squareMatrix) {
-  bool hasNegativeEigenValue;
-
-  Eigen::MatrixXd mat = squareMatrix;
-  hasNegativeEigenValue = makePSD(mat);
-  squareMatrix = mat;
+  // the eigen solver works on the plain type of the input, so fixed-size matrices are decomposed without heap allocation
+  using matrix_t = typename Derived::PlainObject;
+  using eigen_solver_t = Eigen::SelfAdjointEigenSolver<matrix_t>;
+
+  if (squareMatrix.rows() != squareMatrix.cols()) {
+    throw std::runtime_error("Not a square matrix: makePSD() method is for square matrix.");
+  }
+
+  eigen_solver_t eig(squareMatrix, Eigen::EigenvaluesOnly);
+  typename eigen_solver_t::RealVectorType lambda = eig.eigenvalues();
+
+  bool hasNegativeEigenValue = false;
+  for (Eigen::Index j = 0; j < lambda.size(); j++) {
+    if (lambda(j) < 0.0) {
+      hasNegativeEigenValue = true;
+      lambda(j) = 1e-6;
+    }
+  }
+
+  if (hasNegativeEigenValue) {
+    eig.compute(squareMatrix, Eigen::ComputeEigenvectors);
+    squareMatrix = eig.eigenvectors() * lambda.asDiagonal() * eig.eigenvectors().inverse();
+  } else {
+    squareMatrix = 0.5 * (squareMatrix + squareMatrix.transpose()).eval();
+  }
 
   return hasNegativeEigenValue;
 }
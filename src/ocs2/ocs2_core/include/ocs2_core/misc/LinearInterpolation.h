@@ -160,12 +160,39 @@ class LinearInterpolation {
       return {0, scalar_t(1.0)};
     }
 
-    int index = lookup::findIntervalInTimeArray(*timeArrayPtr, enquiryTime);
-    auto lastInterval = static_cast<int>(timeArrayPtr->size() - 1);
+    const int index = lookup::findIntervalInTimeArray(*timeArrayPtr, enquiryTime);
+    return timeSegmentOfInterval(index, enquiryTime, *timeArrayPtr);
+  }
+
+  /**
+   * Same as timeSegment() but the interval lookup starts at the index of the previous call. This is meant for a sequence of
+   * close enquiry times, e.g. the function evaluations of an ODE solver.
+   *
+   * @param [in] enquiryTime: The enquiry time for interpolation.
+   * @param [in] timeArrayPtr: interpolation time array.
+   * @param [in, out] indexHint: index of the previous lookup, it is updated to the current one. Any value is valid.
+   * @return std::pair<int, double> : {index, alpha}
+   */
+  static std::pair<int, double> timeSegment(scalar_t enquiryTime, const std::vector<scalar_t>* timeArrayPtr, int& indexHint) {
+    // corner cases (no time set OR single time element)
+    if (!timeArrayPtr || timeArrayPtr->size() <= 1) {
+      return {0, scalar_t(1.0)};
+    }
+
+    indexHint = lookup::findIndexInTimeArray(*timeArrayPtr, enquiryTime, indexHint);
+    return timeSegmentOfInterval(indexHint - 1, enquiryTime, *timeArrayPtr);
+  }
+
+ private:
+  /**
+   * Get the interpolation coefficient alpha for the interval index from lookup::findIntervalInTimeArray.
+   */
+  static std::pair<int, double> timeSegmentOfInterval(int index, scalar_t enquiryTime, const std::vector<scalar_t>& timeArray) {
+    auto lastInterval = static_cast<int>(timeArray.size() - 1);
     if (index >= 0) {
       if (index < lastInterval) {
         // interpolation : 0 <= index < lastInterval
-        scalar_t alpha = (enquiryTime - (*timeArrayPtr)[index + 1]) / ((*timeArrayPtr)[index] - (*timeArrayPtr)[index + 1]);
+        scalar_t alpha = (enquiryTime - timeArray[index + 1]) / (timeArray[index] - timeArray[index + 1]);
         return {index, alpha};
       } else {
         // upper bound : index >= lastInterval
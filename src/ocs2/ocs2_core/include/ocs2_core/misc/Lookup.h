@@ -91,6 +91,45 @@ int findIndexInTimeArray(const std::vector<scalar_t>& timeArray, scalar_t time)
   return static_cast<int>(firstLargerValueIterator - timeArray.begin());
 }
 
+/**
+ * Same as findIndexInTimeArray, but the search starts at indexHint and expands exponentially from there. For a sequence of close
+ * enquiry times, e.g. the function evaluations of an ODE solver, passing the previous result finds the index in constant time.
+ *
+ * @tparam scalar_t : numerical type of time
+ * @param timeArray : sorted time array to perform the lookup in
+ * @param time : enquiry time
+ * @param indexHint : guess of the result, any value is valid
+ * @return index between [0, size(timeArray)]
+ */
+template <typename scalar_t = double>
+int findIndexInTimeArray(const std::vector<scalar_t>& timeArray, scalar_t time, int indexHint) {
+  auto lessOperator = [](scalar_t element, scalar_t value) { return !numerics::almost_ge(element, value); };
+  const int size = static_cast<int>(timeArray.size());
+  indexHint = std::min(std::max(indexHint, 0), size);
+
+  // bracket the result in [first, last]
+  int first, last;
+  int step = 1;
+  if (indexHint < size && lessOperator(timeArray[indexHint], time)) {
+    first = indexHint + 1;
+    while (first + step - 1 < size && lessOperator(timeArray[first + step - 1], time)) {
+      first += step;
+      step *= 2;
+    }
+    last = std::min(first + step - 1, size);
+  } else {
+    last = indexHint;
+    while (last - step >= 0 && !lessOperator(timeArray[last - step], time)) {
+      last -= step;
+      step *= 2;
+    }
+    first = std::max(last - step + 1, 0);
+  }
+
+  auto firstLargerValueIterator = std::lower_bound(timeArray.begin() + first, timeArray.begin() + last, time, lessOperator);
+  return static_cast<int>(firstLargerValueIterator - timeArray.begin());
+}
+
 /**
  *  Find interval into a sorted time Array
  *
@@ -1,9 +1,15 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
 #include <future>
 #include <list>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <thread>
@@ -48,6 +54,10 @@ class Task : TaskBase {
 /**
  * Thread pool class to execute tasks in multiple threads.
  *
+ * Besides the task interface (run, runAfter), the pool offers a fork-join primitive (parallelFor, runParallel) which does not
+ * allocate: every worker owns a range of indices which it consumes from the front, idle workers steal the back half of another
+ * worker's range. Workers spin shortly after a fork-join job before they go to sleep, since these jobs usually come in bursts.
+ *
  * Note:
  * The task ID is assumed to be unique, so there can't be more than INT_MAX tasks pending.
  */
@@ -93,12 +103,27 @@ class ThreadPool {
   /**
    * Helper function to run a task N times parallel on the pool
    *
-   * @note this is a blocking operation, returns when all tasks are completed.
+   * @note this is a blocking operation, returns when all tasks are completed. The calling thread runs tasks as well.
    *
-   * @param [in] taskFunction: task function to run in the pool.
+   * @param [in] taskFunction: task function to run in the pool, it receives the workerId as in parallelFor.
    * @param [in] N: number of times to run taskFunction, if N = 1 it is run on main thread.
    */
-  void runParallel(std::function<void(int)> taskFunction, size_t N);
+  void runParallel(const std::function<void(int)>& taskFunction, size_t N);
+
+  /**
+   * Fork-join loop over [begin, end). The indices are processed in chunks of grain indices by the workers and the calling thread.
+   * Calls from inside a task of this pool run sequentially on the calling thread.
+   *
+   * @note this is a blocking operation, returns when all indices are processed. Exceptions are rethrown in the calling thread.
+   *
+   * @param [in] begin: first index.
+   * @param [in] end: one past the last index.
+   * @param [in] grain: number of consecutive indices which are claimed at once.
+   * @param [in] taskFunction: callable as taskFunction(int workerId, size_t index). The workerId lies in [0, nThreads] and is
+   * unique among the threads working on this loop, so it can be used to select per-thread data.
+   */
+  template <typename Functor>
+  void parallelFor(size_t begin, size_t end, size_t grain, Functor&& taskFunction);
 
   /**
    * Enable debug log
@@ -108,6 +133,14 @@ class ThreadPool {
   void enableDebug(std::function<void(const std::string)> debugPrint);
 
  private:
+  using fork_join_function_t = void (*)(void* context, int workerId, size_t first, size_t last);
+
+  /** Index range of one fork-join participant, [first, last) packed into one word and padded to a cache line. */
+  struct ForkJoinRange {
+    std::atomic<uint64_t> range{0};
+    char padding[64 - sizeof(std::atomic<uint64_t>)];
+  };
+
   /**
    * Push task to ready queue
    *
@@ -115,13 +148,6 @@ class ThreadPool {
    */
   void pushReady(int taskId);
 
-  /**
-   * Pop next task from ready queue
-   *
-   * @return next task from queue
-   */
-  int popReady();
-
   /**
    * Thread worker loop
    *
@@ -146,6 +172,42 @@ class ThreadPool {
    */
   int runTaskWithDependency(std::shared_ptr<TaskBase> task, int runAfterId);
 
+  /**
+   * Distributes [begin, end) over all participants, works on it in the calling thread and waits for the workers.
+   *
+   * @param [in] begin: first index.
+   * @param [in] end: one past the last index.
+   * @param [in] grain: number of consecutive indices which are claimed at once.
+   * @param [in] function: type erased loop body, runs the indices [first, last).
+   * @param [in] context: loop body object passed to function.
+   */
+  void runForkJoin(size_t begin, size_t end, size_t grain, fork_join_function_t function, void* context);
+
+  /**
+   * Works on the current fork-join job until no range is left to claim or steal.
+   *
+   * @param [in] workerId: participant id, also the index of its own range.
+   */
+  void runForkJoinTasks(int workerId);
+
+  /**
+   * Claims the next chunk of a participant's own range.
+   *
+   * @param [in] workerId: participant id.
+   * @param [out] first: first claimed index, relative to the begin of the loop.
+   * @param [out] last: one past the last claimed index.
+   * @return false if the range is empty.
+   */
+  bool claimForkJoinChunk(int workerId, uint64_t& first, uint64_t& last);
+
+  /**
+   * Moves the back half of the range of another participant into the participant's own (empty) range.
+   *
+   * @param [in] workerId: participant id.
+   * @return false if all ranges are empty.
+   */
+  bool stealForkJoinRange(int workerId);
+
   /**
    * Print debug message
    *
@@ -163,6 +225,21 @@ class ThreadPool {
   std::queue<int> readyQueue_;
   std::condition_variable readyQueueCondition_;
   std::mutex readyQueueLock_;
+  std::atomic<int> numSleepingWorkers_;  // modified under readyQueueLock_
+
+  std::mutex forkJoinLock_;  // serializes fork-join jobs of different callers
+  std::unique_ptr<ForkJoinRange[]> forkJoinRanges_;  // one per worker and one for the calling thread
+  fork_join_function_t forkJoinFunction_;
+  void* forkJoinContext_;
+  size_t forkJoinBegin_;
+  size_t forkJoinGrain_;
+  std::atomic<size_t> forkJoinGeneration_;
+  std::atomic<bool> forkJoinOpen_;
+  std::atomic<int> forkJoinParticipants_;
+  std::atomic<uint64_t> forkJoinRemaining_;
+  std::atomic<bool> forkJoinFailed_;
+  std::exception_ptr forkJoinException_;
+  static constexpr std::chrono::microseconds forkJoinSpinDuration_{50};
 
   bool debug_;
   std::function<void(const std::string)> debugPrint_;
@@ -236,4 +313,19 @@ std::future<typename std::result_of<Functor(int)>::type> ThreadPool::runAfter(in
   return std::move(future);
 }
 
+/**************************************************************************************************/
+/**************************************************************************************************/
+/**************************************************************************************************/
+template <typename Functor>
+void ThreadPool::parallelFor(size_t begin, size_t end, size_t grain, Functor&& taskFunction) {
+  using functor_t = typename std::remove_reference<Functor>::type;
+  fork_join_function_t function = [](void* context, int workerId, size_t first, size_t last) {
+    functor_t& f = *static_cast<functor_t*>(context);
+    for (size_t i = first; i < last; i++) {
+      f(workerId, i);
+    }
+  };
+  runForkJoin(begin, end, grain, function, const_cast<void*>(static_cast<const void*>(&taskFunction)));
+}
+
 }  // namespace ocs2
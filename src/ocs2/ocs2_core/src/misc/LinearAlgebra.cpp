@@ -33,29 +33,8 @@ namespace ocs2 {
 namespace LinearAlgebra {
 
 bool makePSD(Eigen::MatrixXd& squareMatrix) {
-  if (squareMatrix.rows() != squareMatrix.cols()) {
-    throw std::runtime_error("Not a square matrix: makePSD() method is for square matrix.");
-  }
-
-  Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eig(squareMatrix, Eigen::EigenvaluesOnly);
-  Eigen::VectorXd lambda = eig.eigenvalues();
-
-  bool hasNegativeEigenValue = false;
-  for (size_t j = 0; j < lambda.size(); j++) {
-    if (lambda(j) < 0.0) {
-      hasNegativeEigenValue = true;
-      lambda(j) = 1e-6;
-    }
-  }
-
-  if (hasNegativeEigenValue) {
-    eig.compute(squareMatrix, Eigen::ComputeEigenvectors);
-    squareMatrix = eig.eigenvectors() * lambda.asDiagonal() * eig.eigenvectors().inverse();
-  } else {
-    squareMatrix = 0.5 * (squareMatrix + squareMatrix.transpose()).eval();
-  }
-
-  return hasNegativeEigenValue;
+  Eigen::MatrixBase<Eigen::MatrixXd>& squareMatrixBase = squareMatrix;
+  return makePSD(squareMatrixBase);
 }
 
 void computeConstraintProjection(const Eigen::MatrixXd& D, const Eigen::MatrixXd& RinvChol, Eigen::MatrixXd& Ddagger,
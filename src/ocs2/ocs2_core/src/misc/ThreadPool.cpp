@@ -1,6 +1,10 @@
 #include <ocs2_core/misc/SetThreadPriority.h>
 #include <ocs2_core/misc/ThreadPool.h>
 
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
 #define DEBUG_MSG(...)         \
   if (debug_) {                \
     debugMessage(__VA_ARGS__); \
@@ -8,10 +12,42 @@
 
 namespace ocs2 {
 
+namespace {
+// Set in the worker threads and in a thread running a fork-join job, used to run nested fork-join calls sequentially.
+thread_local const ThreadPool* currentThreadPool = nullptr;
+thread_local int currentWorkerId = -1;
+
+inline uint64_t packRange(uint64_t first, uint64_t last) {
+  return (first << 32) | last;
+}
+inline uint64_t rangeFirst(uint64_t range) {
+  return range >> 32;
+}
+inline uint64_t rangeLast(uint64_t range) {
+  return range & 0xffffffff;
+}
+}  // unnamed namespace
+
+constexpr std::chrono::microseconds ThreadPool::forkJoinSpinDuration_;
+
 /**************************************************************************************************/
 /**************************************************************************************************/
 /**************************************************************************************************/
-ThreadPool::ThreadPool(size_t nThreads, int priority) : nextTaskId_(0), stop_(false), debug_(false) {
+ThreadPool::ThreadPool(size_t nThreads, int priority)
+    : nextTaskId_(0),
+      stop_(false),
+      numSleepingWorkers_(0),
+      forkJoinRanges_(new ForkJoinRange[nThreads + 1]),
+      forkJoinFunction_(nullptr),
+      forkJoinContext_(nullptr),
+      forkJoinBegin_(0),
+      forkJoinGrain_(1),
+      forkJoinGeneration_(0),
+      forkJoinOpen_(false),
+      forkJoinParticipants_(0),
+      forkJoinRemaining_(0),
+      forkJoinFailed_(false),
+      debug_(false) {
   workerThreads_.reserve(nThreads);
   for (size_t i = 0; i < nThreads; i++) {
     workerThreads_.emplace_back(&ThreadPool::worker, this, i);
@@ -44,35 +80,50 @@ void ThreadPool::pushReady(int taskId) {
   readyQueueCondition_.notify_one();
 }
 
-/**************************************************************************************************/
-/**************************************************************************************************/
-/**************************************************************************************************/
-int ThreadPool::popReady() {
-  int task;
-  {
-    std::unique_lock<std::mutex> lock(readyQueueLock_);
-    readyQueueCondition_.wait(lock, [&] { return stop_ || !readyQueue_.empty(); });
-    if (!readyQueue_.empty()) {
-      task = readyQueue_.front();
-      readyQueue_.pop();
-    }
-  }
-  return task;
-}
-
 /**************************************************************************************************/
 /**************************************************************************************************/
 /**************************************************************************************************/
 void ThreadPool::worker(int workerId) {
+  currentThreadPool = this;
+  currentWorkerId = workerId;
+  size_t forkJoinGeneration = forkJoinGeneration_.load();
+
   while (true) {
-    int taskId;
+    // fork-join jobs come in bursts, wait for the next one without sleeping for a moment
+    const auto spinEnd = std::chrono::steady_clock::now() + forkJoinSpinDuration_;
+    while (forkJoinGeneration_.load() == forkJoinGeneration && std::chrono::steady_clock::now() < spinEnd) {
+      std::this_thread::yield();
+    }
 
-    taskId = popReady();  // can return if stop_ flag is set
+    int taskId = -1;
+    if (forkJoinGeneration_.load() == forkJoinGeneration) {
+      std::unique_lock<std::mutex> lock(readyQueueLock_);
+      numSleepingWorkers_++;
+      readyQueueCondition_.wait(lock, [&] { return stop_ || !readyQueue_.empty() || forkJoinGeneration_.load() != forkJoinGeneration; });
+      numSleepingWorkers_--;
 
-    // exit condition
-    if (stop_) {
-      DEBUG_MSG("stop", workerId);
-      break;
+      // exit condition
+      if (stop_) {
+        lock.unlock();
+        DEBUG_MSG("stop", workerId);
+        break;
+      }
+
+      if (forkJoinGeneration_.load() == forkJoinGeneration) {
+        taskId = readyQueue_.front();
+        readyQueue_.pop();
+      }
+    }
+
+    if (taskId < 0) {
+      forkJoinGeneration = forkJoinGeneration_.load();
+      // The job may already be finished, the caller only returns once all participants have left.
+      forkJoinParticipants_++;
+      if (forkJoinOpen_.load()) {
+        runForkJoinTasks(workerId);
+      }
+      forkJoinParticipants_--;
+      continue;
     }
 
     std::shared_ptr<TaskBase> task;
@@ -154,22 +205,145 @@ int ThreadPool::runTaskWithDependency(std::shared_ptr<TaskBase> task, int runAft
 /**************************************************************************************************/
 /**************************************************************************************************/
 /**************************************************************************************************/
-void ThreadPool::runParallel(std::function<void(int)> taskFunction, size_t N) {
-  if (N <= 1) {
-    taskFunction(0);
+void ThreadPool::runParallel(const std::function<void(int)>& taskFunction, size_t N) {
+  parallelFor(0, N, 1, [&](int workerId, size_t) { taskFunction(workerId); });
+}
+
+/**************************************************************************************************/
+/**************************************************************************************************/
+/**************************************************************************************************/
+void ThreadPool::runForkJoin(size_t begin, size_t end, size_t grain, fork_join_function_t function, void* context) {
+  if (end <= begin) {
+    return;
+  }
+  grain = std::max<size_t>(grain, 1);
+  const size_t numIndices = end - begin;
+  const int nThreads = workerThreads_.size();
+
+  // nested calls and small loops run on the calling thread
+  if (currentThreadPool == this) {
+    function(context, currentWorkerId, begin, end);
     return;
   }
+  if (nThreads == 0 || numIndices <= grain) {
+    function(context, nThreads, begin, end);
+    return;
+  }
+  if (numIndices > std::numeric_limits<uint32_t>::max()) {
+    throw std::runtime_error("[ThreadPool] parallelFor range exceeds 2^32 indices.");
+  }
+
+  std::lock_guard<std::mutex> lock(forkJoinLock_);
+
+  forkJoinFunction_ = function;
+  forkJoinContext_ = context;
+  forkJoinBegin_ = begin;
+  forkJoinGrain_ = grain;
+  forkJoinFailed_ = false;
+  forkJoinException_ = nullptr;
+  forkJoinRemaining_ = numIndices;
+  const uint64_t numRanges = nThreads + 1;
+  for (uint64_t i = 0; i < numRanges; i++) {
+    forkJoinRanges_[i].range = packRange(numIndices * i / numRanges, numIndices * (i + 1) / numRanges);
+  }
 
-  std::vector<std::future<void>> futures;
-  futures.reserve(N);
+  // publish the job and wake up sleeping workers
+  forkJoinOpen_ = true;
+  forkJoinGeneration_++;
+  if (numSleepingWorkers_.load() > 0) {
+    { std::lock_guard<std::mutex> queueLock(readyQueueLock_); }
+    readyQueueCondition_.notify_all();
+  }
 
-  for (int i = 0; i < N; i++) {
-    futures.push_back(std::move(run(taskFunction)));
+  currentThreadPool = this;
+  currentWorkerId = nThreads;
+  runForkJoinTasks(nThreads);
+  currentThreadPool = nullptr;
+  currentWorkerId = -1;
+
+  // wait for the chunks claimed by the workers, then until no worker refers to this job anymore
+  while (forkJoinRemaining_.load() > 0) {
+    std::this_thread::yield();
+  }
+  forkJoinOpen_ = false;
+  while (forkJoinParticipants_.load() > 0) {
+    std::this_thread::yield();
   }
 
-  for (auto&& fut : futures) {
-    fut.get();
+  if (forkJoinFailed_) {
+    std::rethrow_exception(forkJoinException_);
+  }
+}
+
+/**************************************************************************************************/
+/**************************************************************************************************/
+/**************************************************************************************************/
+void ThreadPool::runForkJoinTasks(int workerId) {
+  uint64_t first, last;
+  while (true) {
+    if (!claimForkJoinChunk(workerId, first, last)) {
+      if (stealForkJoinRange(workerId)) {
+        continue;
+      }
+      return;
+    }
+
+    if (!forkJoinFailed_.load(std::memory_order_relaxed)) {
+      try {
+        forkJoinFunction_(forkJoinContext_, workerId, forkJoinBegin_ + first, forkJoinBegin_ + last);
+      } catch (...) {
+        if (!forkJoinFailed_.exchange(true)) {
+          forkJoinException_ = std::current_exception();
+        }
+      }
+    }
+    forkJoinRemaining_ -= last - first;
+  }
+}
+
+/**************************************************************************************************/
+/**************************************************************************************************/
+/**************************************************************************************************/
+bool ThreadPool::claimForkJoinChunk(int workerId, uint64_t& first, uint64_t& last) {
+  std::atomic<uint64_t>& range = forkJoinRanges_[workerId].range;
+  uint64_t current = range.load();
+  while (true) {
+    first = rangeFirst(current);
+    const uint64_t rangeEnd = rangeLast(current);
+    if (first >= rangeEnd) {
+      return false;
+    }
+    last = std::min<uint64_t>(first + forkJoinGrain_, rangeEnd);
+    if (range.compare_exchange_weak(current, packRange(last, rangeEnd))) {
+      return true;
+    }
+  }
+}
+
+/**************************************************************************************************/
+/**************************************************************************************************/
+/**************************************************************************************************/
+bool ThreadPool::stealForkJoinRange(int workerId) {
+  const int numRanges = workerThreads_.size() + 1;
+  for (int i = 1; i < numRanges; i++) {
+    std::atomic<uint64_t>& victimRange = forkJoinRanges_[(workerId + i) % numRanges].range;
+    uint64_t current = victimRange.load();
+    while (true) {
+      const uint64_t first = rangeFirst(current);
+      const uint64_t last = rangeLast(current);
+      if (first >= last) {
+        break;
+      }
+      // take the back half, or everything if it is not worth splitting
+      const uint64_t split = (last - first > forkJoinGrain_) ? first + (last - first) / 2 : first;
+      if (victimRange.compare_exchange_weak(current, packRange(first, split))) {
+        // The own range is empty, so nobody else modifies it concurrently.
+        forkJoinRanges_[workerId].range = packRange(split, last);
+        return true;
+      }
+    }
   }
+  return false;
 }
 
 /**************************************************************************************************/
@@ -44,6 +44,26 @@ TEST_F(CppAdInterfaceParameterizedFixture, loadIfAvailable) {
   ASSERT_TRUE(adInterface.getHessian(1, x, p).isApprox(testHessian(1, x, p)));
 }
 
+TEST_F(CppAdInterfaceParameterizedFixture, inPlaceEvaluation) {
+  ocs2::CppAdInterface<scalar_t> adInterface(funImpl, rangeDim_, variableDim_, parameterDim_, "testModelInPlace");
+
+  adInterface.loadModelsIfAvailable(ocs2::CppAdInterface<scalar_t>::ApproximationOrder::Second, true);
+  dynamic_vector_t x = dynamic_vector_t::Random(variableDim_);
+  dynamic_vector_t p = dynamic_vector_t::Random(parameterDim_);
+
+  dynamic_vector_t functionValue(rangeDim_);
+  dynamic_matrix_t jacobian(rangeDim_, variableDim_);
+  dynamic_matrix_t hessian(variableDim_, variableDim_);
+  for (int i = 0; i < 2; i++) {  // second pass reuses the thread local buffers
+    adInterface.getFunctionValue(x, p, functionValue);
+    ASSERT_TRUE(functionValue.isApprox(testFun(x, p)));
+    adInterface.getJacobian(x, p, jacobian);
+    ASSERT_TRUE(jacobian.isApprox(testJacobian(x, p)));
+    adInterface.getHessian(1, x, p, hessian);
+    ASSERT_TRUE(hessian.isApprox(testHessian(1, x, p)));
+  }
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
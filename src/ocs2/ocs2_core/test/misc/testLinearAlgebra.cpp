@@ -67,6 +67,33 @@ TEST(constraintProjection, checkAgainstFullComputations)
   ASSERT_LT( (RinvConstrained - RinvConstrained_check).array().abs().maxCoeff() , tol );
 }
 
+TEST(makePSD, fixedSizeAgainstDynamicSize)
+{
+  const size_t n = 6; // matrix size
+  const double tol = 1e-9; // Coefficient-wise tolerance
+
+  // Some random symmetric indefinite matrix
+  using Matrix_t = Eigen::Matrix<double, n, n>;
+  Matrix_t A = Matrix_t::Random();
+  A = 0.5 * (A + A.transpose()).eval();
+  A.diagonal() -= Eigen::Matrix<double, n, 1>::Constant(2.0);
+
+  Matrix_t Apsd = A;
+  Eigen::MatrixXd ApsdDynamic = A;
+  ASSERT_TRUE(makePSD(Apsd));
+  ASSERT_TRUE(makePSD(ApsdDynamic));
+  ASSERT_LT( (Apsd - ApsdDynamic).array().abs().maxCoeff() , tol );
+
+  Eigen::SelfAdjointEigenSolver<Matrix_t> eig(Apsd, Eigen::EigenvaluesOnly);
+  ASSERT_GT(eig.eigenvalues().minCoeff(), 0.0);
+
+  // A positive definite matrix is only symmetrized
+  Matrix_t B = generateSPDmatrix<Matrix_t>();
+  Matrix_t Bpsd = B;
+  ASSERT_FALSE(makePSD(Bpsd));
+  ASSERT_LT( (Bpsd - B).array().abs().maxCoeff() , tol );
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -37,6 +37,27 @@ TEST(testLookup, findIndexInTimeArray)
   ASSERT_EQ(findIndexInTimeArray(timeArrayEmpty,  1.0), 0);
 }
 
+TEST(testLookup, findIndexInTimeArrayWithHint)
+{
+  std::vector<double> timeArray{-1.0, 0.0, 0.5, 2.0, 2.0, 2.0, 3.0, 4.0, 4.5, 5.0, 7.0};
+  std::vector<double> timeArrayEmpty;
+  const std::vector<double> enquiryTimes{-2.0, -1.0, -0.5, 0.0, 0.25, 1.9, 2.0, 2.1, 3.0, 4.9, 5.0, 6.0, 7.0, 8.0};
+  for (const double time : enquiryTimes) {
+    const int index = findIndexInTimeArray(timeArray, time);
+    for (int indexHint = -2; indexHint <= static_cast<int>(timeArray.size()) + 2; indexHint++) {
+      ASSERT_EQ(findIndexInTimeArray(timeArray, time, indexHint), index) << "time: " << time << ", hint: " << indexHint;
+    }
+    ASSERT_EQ(findIndexInTimeArray(timeArrayEmpty, time, 0), 0);
+  }
+
+  // Sequence of decreasing times as in a backward integration
+  int indexHint = timeArray.size();
+  for (double time = 8.0; time > -2.0; time -= 0.01) {
+    indexHint = findIndexInTimeArray(timeArray, time, indexHint);
+    ASSERT_EQ(indexHint, findIndexInTimeArray(timeArray, time));
+  }
+}
+
 TEST(testLookup, findIntervalInTimeArray)
 {
   // Normal case
@@ -172,3 +172,75 @@ TEST(testThreadPool, testNoThreads) {
   auto fut2 = pool.runAfter(id, [&](int) -> std::string { return "ok"; });
   EXPECT_EQ(fut2.get(), "ok");
 }
+
+TEST(testThreadPool, testParallelFor) {
+  const size_t nThreads = 3;
+  ThreadPool pool(nThreads);
+
+  for (size_t grain : {1, 3, 1000}) {
+    std::vector<std::atomic_int> visits(1000);
+    for (auto& v : visits) {
+      v = 0;
+    }
+    std::atomic_bool validWorkerId(true);
+
+    pool.parallelFor(0, visits.size(), grain, [&](int workerId, size_t i) {
+      if (workerId < 0 || workerId > static_cast<int>(nThreads)) {
+        validWorkerId = false;
+      }
+      visits[i]++;
+    });
+
+    EXPECT_TRUE(validWorkerId);
+    for (const auto& v : visits) {
+      ASSERT_EQ(v, 1);
+    }
+  }
+}
+
+TEST(testThreadPool, testParallelForWorkerIdIsUnique) {
+  const size_t nThreads = 4;
+  ThreadPool pool(nThreads);
+  std::vector<std::atomic_int> running(nThreads + 1);
+  for (auto& r : running) {
+    r = 0;
+  }
+  std::atomic_bool unique(true);
+
+  pool.parallelFor(10, 10000, 7, [&](int workerId, size_t) {
+    if (running[workerId]++ != 0) {
+      unique = false;
+    }
+    running[workerId]--;
+  });
+
+  EXPECT_TRUE(unique);
+}
+
+TEST(testThreadPool, testParallelForNested) {
+  ThreadPool pool(2);
+  std::atomic_int counter;
+  counter = 0;
+
+  pool.parallelFor(0, 8, 1, [&](int, size_t) { pool.parallelFor(0, 8, 1, [&](int, size_t) { counter++; }); });
+
+  EXPECT_EQ(counter, 64);
+}
+
+TEST(testThreadPool, testParallelForPropagateException) {
+  ThreadPool pool(2);
+  std::atomic_int counter;
+  counter = 0;
+
+  EXPECT_THROW(pool.parallelFor(0, 100, 1,
+                                [&](int, size_t i) {
+                                  if (i == 42) {
+                                    throw std::string("exception");
+                                  }
+                                }),
+               std::string);
+
+  // the pool is still usable
+  pool.runParallel([&](int) { counter++; }, 42);
+  EXPECT_EQ(counter, 42);
+}
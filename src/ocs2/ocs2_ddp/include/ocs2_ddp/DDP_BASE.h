@@ -29,6 +29,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+
 #include <ocs2_core/constraint/ConstraintBase.h>
 #include <ocs2_core/constraint/RelaxedBarrierPenalty.h>
 #include <ocs2_core/control/LinearController.h>
@@ -142,6 +145,7 @@ class DDP_BASE : public Solver_BASE<STATE_DIM, INPUT_DIM> {
   using penalty_base_t = PenaltyBase<STATE_DIM, INPUT_DIM>;
 
   using rollout_base_t = RolloutBase<STATE_DIM, INPUT_DIM>;
+  using rollout_partition_callback_t = std::function<void(size_t partitionIndex)>;
   using time_triggered_rollout_t = TimeTriggeredRollout<STATE_DIM, INPUT_DIM>;
   using linear_quadratic_approximator_t = LinearQuadraticApproximator<STATE_DIM, INPUT_DIM>;
   using operating_trajectorie_rollout_t = OperatingTrajectoriesRollout<STATE_DIM, INPUT_DIM>;
@@ -197,12 +201,15 @@ class DDP_BASE : public Solver_BASE<STATE_DIM, INPUT_DIM> {
    * @param [out] inputTrajectoriesStock: Array of trajectories containing the
    * output control input trajectory.
    * @param [in] threadId: Working thread (default is 0).
+   * @param [in] partitionCallback: If set, it is called with the partition index as soon as a partition is rolled out. It can
+   * throw to stop the rollout.
    *
    * @return average time step.
    */
   scalar_t rolloutTrajectory(linear_controller_array_t& controllersStock, scalar_array2_t& timeTrajectoriesStock,
                              size_array2_t& postEventIndicesStock, state_vector_array2_t& stateTrajectoriesStock,
-                             input_vector_array2_t& inputTrajectoriesStock, size_t threadId = 0);
+                             input_vector_array2_t& inputTrajectoriesStock, size_t threadId = 0,
+                             const rollout_partition_callback_t& partitionCallback = nullptr);
 
   /**
    * Calculates a rollout constraints. It uses the given rollout trajectories
@@ -251,6 +258,18 @@ class DDP_BASE : public Solver_BASE<STATE_DIM, INPUT_DIM> {
                                 const state_vector_array2_t& stateTrajectoriesStock, const input_vector_array2_t& inputTrajectoriesStock,
                                 size_t threadId = 0);
 
+  /**
+   * Calculates the heuristics cost at the end of a rollout.
+   *
+   * @param [in] timeTrajectoriesStock: Array of trajectories containing the time trajectory stamp of a rollout.
+   * @param [in] stateTrajectoriesStock: Array of trajectories containing the state trajectory of a rollout.
+   * @param [in] inputTrajectoriesStock: Array of trajectories containing the control input trajectory of a rollout.
+   * @param [in] threadId: Working thread (default is 0).
+   * @return The heuristics cost at the final time.
+   */
+  scalar_t calculateRolloutHeuristicsCost(const scalar_array2_t& timeTrajectoriesStock, const state_vector_array2_t& stateTrajectoriesStock,
+                                          const input_vector_array2_t& inputTrajectoriesStock, size_t threadId = 0);
+
   /**
    * Calculates the merit function as a function of cost, inequality constraints penalty, and ISE of state equality constraints.
    *
@@ -357,6 +376,14 @@ class DDP_BASE : public Solver_BASE<STATE_DIM, INPUT_DIM> {
 
   const std::vector<PerformanceIndex>& getIterationsLog() const override;
 
+  /**
+   * Gets the number of time nodes which each worker has approximated in the last LQ approximation. This shows how well
+   * the LQ approximation is balanced over the threads.
+   *
+   * @return number of LQ approximated time nodes per worker.
+   */
+  const size_array_t& getNumLQNodesPerWorker() const;
+
   /**
    * Write access to ddp settings
    */
@@ -373,6 +400,17 @@ class DDP_BASE : public Solver_BASE<STATE_DIM, INPUT_DIM> {
 
   const scalar_array_t& getPartitioningTimes() const override;
 
+  /**
+   * Gets pointers to the nominal time, state, and input trajectories of all partitions.
+   *
+   * @param [out] nominalTimeTrajectoriesStockPtr: A pointer to the nominal time trajectories.
+   * @param [out] nominalStateTrajectoriesStockPtr: A pointer to the nominal state trajectories.
+   * @param [out] nominalInputTrajectoriesStockPtr: A pointer to the nominal input trajectories.
+   */
+  void getNominalTrajectoriesPtr(const scalar_array2_t*& nominalTimeTrajectoriesStockPtr,
+                                 const state_vector_array2_t*& nominalStateTrajectoriesStockPtr,
+                                 const input_vector_array2_t*& nominalInputTrajectoriesStockPtr) const;
+
   void rewindOptimizer(size_t firstIndex) override;
 
   const unsigned long long int& getRewindCounter() const override;
@@ -387,7 +425,52 @@ class DDP_BASE : public Solver_BASE<STATE_DIM, INPUT_DIM> {
    */
   void runIteration();
 
+  /**
+   * Prepares a real-time iteration: the LQ problem is approximated around the current nominal trajectories and the Riccati
+   * equations are solved for the controller update. This does not depend on the next initial state, so it can be done before
+   * the next observation arrives. The next run() with the internal controller (i.e. an empty controllersPtrStock) then only
+   * performs the line search of the prepared update from its initial state. Any other run() discards the preparation.
+   */
+  void prepareRealTimeIteration();
+
  protected:
+  /**
+   * The per-thread variables of the line search. They are sized in setupOptimizer() and reused over the iterations, so
+   * the rollouts write into trajectory buffers which keep their capacity instead of building new ones.
+   */
+  struct LineSearchWorkspace {
+    linear_controller_array_t controllersStock;
+    scalar_array2_t timeTrajectoriesStock;
+    size_array2_t postEventIndicesStock;
+    state_vector_array2_t stateTrajectoriesStock;
+    input_vector_array2_t inputTrajectoriesStock;
+
+    size_array2_t nc1TrajectoriesStock;
+    constraint1_vector_array2_t EvTrajectoryStock;
+    size_array2_t nc2TrajectoriesStock;
+    constraint2_vector_array2_t HvTrajectoryStock;
+    size_array2_t ncIneqTrajectoriesStock;
+    scalar_array3_t hTrajectoryStock;
+    size_array2_t nc2FinalStock;
+    constraint2_vector_array2_t HvFinalStock;
+
+    void resize(size_t numPartitions) {
+      controllersStock.resize(numPartitions);
+      timeTrajectoriesStock.resize(numPartitions);
+      postEventIndicesStock.resize(numPartitions);
+      stateTrajectoriesStock.resize(numPartitions);
+      inputTrajectoriesStock.resize(numPartitions);
+      nc1TrajectoriesStock.resize(numPartitions);
+      EvTrajectoryStock.resize(numPartitions);
+      nc2TrajectoriesStock.resize(numPartitions);
+      HvTrajectoryStock.resize(numPartitions);
+      ncIneqTrajectoriesStock.resize(numPartitions);
+      hTrajectoryStock.resize(numPartitions);
+      nc2FinalStock.resize(numPartitions);
+      HvFinalStock.resize(numPartitions);
+    }
+  };
+
   /**
    * Sets up optimizer for different number of partitions.
    *
@@ -406,7 +489,7 @@ class DDP_BASE : public Solver_BASE<STATE_DIM, INPUT_DIM> {
    * @param [in] taskFunction: task function
    * @param [in] N: number of times to run taskFunction, if N = 1 it is run in the main thread
    */
-  void runParallel(std::function<void(void)> taskFunction, size_t N);
+  void runParallel(const std::function<void(void)>& taskFunction, size_t N);
 
   /**
    * Calculates an LQ approximate of the optimal control problem at a given
@@ -500,23 +583,26 @@ class DDP_BASE : public Solver_BASE<STATE_DIM, INPUT_DIM> {
   void lineSearchTask();
 
   /**
-   * Line search with a specific learning rate.
+   * Line search with a specific learning rate. The rollout and its constraints are written into the given workspace.
    *
-   * @param workerIndex
-   * @param learningRate
-   * @param lsPerformanceIndex
-   * @param lsConstraint1MaxNorm
-   * @param lsConstraint2MaxNorm
-   * @param lsControllersStock
-   * @param lsTimeTrajectoriesStock
-   * @param lsPostEventIndicesStock
-   * @param lsStateTrajectoriesStock
-   * @param lsInputTrajectoriesStock
+   * @param [in] workerIndex: Working agent index.
+   * @param [in] learningRate: The learning rate.
+   * @param [out] lsPerformanceIndex: The performance index of the rollout.
+   * @param [out] lsConstraint1MaxNorm: The maximum norm of the type-1 constraints.
+   * @param [out] lsConstraint2MaxNorm: The maximum norm of the type-2 constraints.
+   * @param [in, out] workspace: The worker's workspace. Its controllers should be initialized to initLScontrollersStock_.
    */
   void lineSearchWorker(size_t workerIndex, scalar_t learningRate, PerformanceIndex& lsPerformanceIndex, scalar_t& lsConstraint1MaxNorm,
-                        scalar_t& lsConstraint2MaxNorm, linear_controller_array_t& lsControllersStock,
-                        scalar_array2_t& lsTimeTrajectoriesStock, size_array2_t& lsPostEventIndicesStock,
-                        state_vector_array2_t& lsStateTrajectoriesStock, input_vector_array2_t& lsInputTrajectoriesStock);
+                        scalar_t& lsConstraint2MaxNorm, LineSearchWorkspace& workspace);
+
+  /**
+   * Copies a controller into an existing one while reusing its memory. Unlike the copy assignment of the
+   * LinearController, this does not allocate once the destination has grown to the size of the source.
+   *
+   * @param [in] source: The controller to copy from.
+   * @param [out] destination: The controller to copy to.
+   */
+  static void copyControllerInPlace(const linear_controller_t& source, linear_controller_t& destination);
 
   /**
    * Solves Riccati equations for the partitions assigned to the given thread.
@@ -629,12 +715,28 @@ class DDP_BASE : public Solver_BASE<STATE_DIM, INPUT_DIM> {
   // multi-threading helper variables
   std::atomic_size_t nextTaskId_;
   std::atomic_size_t nextTimeIndex_;
+  // the LQ approximation hands out at least this many chunks of time nodes per thread, more chunks balance the load better
+  static constexpr size_t lqChunksPerThread_ = 4;
+  // upper bound on the LQ data written for one chunk of time nodes, such that a chunk stays in the worker's L2 cache
+  static constexpr size_t lqChunkBytes_ = 128 * 1024;
+
+  /** The range of global time nodes which is initially assigned to one worker of the LQ approximation. */
+  struct LQWorkerRange {
+    std::atomic_size_t next{0};
+    size_t end = 0;
+    char padding[64 - sizeof(std::atomic_size_t) - sizeof(size_t)];
+  };
+  std::vector<LQWorkerRange> lqWorkerRanges_;
+  // the global index of the first time node of each partition, the last element is the total number of time nodes
+  size_array_t lqPartitionOffsets_;
+  size_array_t numLQNodesPerWorker_;
 
   std::string algorithmName_;
 
   unsigned long long int rewindCounter_;
 
   bool useParallelRiccatiSolverFromInitItr_ = false;
+  bool realTimeIterationPrepared_ = false;  //! Whether the controller update for the next real-time iteration is prepared
 
   scalar_t initTime_;
   scalar_t finalTime_;
@@ -693,6 +795,7 @@ class DDP_BASE : public Solver_BASE<STATE_DIM, INPUT_DIM> {
   std::vector<bool> alphaProcessed_;
   scalar_t baselineMerit_;                            // the merit of the rollout for zero learning rate
   linear_controller_array_t initLScontrollersStock_;  // needed for lineSearch
+  std::vector<LineSearchWorkspace> lineSearchWorkspaces_;  // one per thread, reused over the iterations
 
   std::vector<EigenLinearInterpolation<state_vector_t>> nominalStateFunc_;
   std::vector<EigenLinearInterpolation<input_vector_t>> nominalInputFunc_;
@@ -52,6 +52,7 @@ class DDP_Settings {
         minLearningRate_(0.05),
         maxLearningRate_(1.0),
         lineSearchContractionRate_(0.5),
+        useLineSearchMeritBound_(false),
         minRelCost_(1e-3),
         stateConstraintPenaltyCoeff_(0.0),
         stateConstraintPenaltyBase_(1.0),
@@ -124,6 +125,9 @@ class DDP_Settings {
   double maxLearningRate_;
   /** Line-search scheme contraction rate. */
   double lineSearchContractionRate_;
+  /** If true, a line-search rollout is stopped as soon as the cost of its partitions rolled out so far exceeds the acceptable merit.
+   * The partial cost is only a lower bound of the merit if the cost and the constraint penalties are non-negative. */
+  bool useLineSearchMeritBound_;
   /** This value determines the termination condition based on the minimum relative changes of the cost. */
   double minRelCost_;
   /** The penalty function coefficient, \f$\alpha\f$, for state-only constraints. \f$ p(i) = \alpha a^i \f$ */
@@ -196,6 +200,7 @@ inline void DDP_Settings::loadSettings(const std::string& filename, const std::s
   loadData::loadPtreeValue(pt, maxNumIterations_, fieldName + ".maxNumIterations", verbose);
   loadData::loadPtreeValue(pt, minLearningRate_, fieldName + ".minLearningRate", verbose);
   loadData::loadPtreeValue(pt, maxLearningRate_, fieldName + ".maxLearningRate", verbose);
+  loadData::loadPtreeValue(pt, useLineSearchMeritBound_, fieldName + ".useLineSearchMeritBound", verbose);
   loadData::loadPtreeValue(pt, minRelCost_, fieldName + ".minRelCost", verbose);
   loadData::loadPtreeValue(pt, stateConstraintPenaltyCoeff_, fieldName + ".stateConstraintPenaltyCoeff", verbose);
   loadData::loadPtreeValue(pt, stateConstraintPenaltyBase_, fieldName + ".stateConstraintPenaltyBase", verbose);
@@ -29,6 +29,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <exception>
 
@@ -41,6 +42,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ocs2_ddp/SLQ_Settings.h"
 #include "ocs2_ddp/riccati_equations/SequentialErrorEquation.h"
 #include "ocs2_ddp/riccati_equations/SequentialRiccatiEquations.h"
+#include "ocs2_ddp/riccati_equations/TimeParallelBackwardRecursion.h"
 
 namespace ocs2 {
 
@@ -125,6 +127,8 @@ class SLQ final : public DDP_BASE<STATE_DIM, INPUT_DIM> {
   using error_equation_t = SequentialErrorEquation<STATE_DIM, INPUT_DIM>;
   using s_vector_t = typename riccati_equations_t::s_vector_t;
   using s_vector_array_t = typename riccati_equations_t::s_vector_array_t;
+  using riccati_element_t = ConditionalValueFunction<STATE_DIM>;
+  using error_equation_element_t = AffineBackwardMap<STATE_DIM>;
 
   /**
    * class for collecting SLQ data
@@ -161,6 +165,19 @@ class SLQ final : public DDP_BASE<STATE_DIM, INPUT_DIM> {
 
   void approximateOptimalControlProblem() override;
 
+  /**
+   * Solves Riccati equations for all the partitions. If settings_.useDiscreteTimeRiccati_ and settings_.useTimeParallelRiccati_
+   * are set, the discrete-time recursion is solved in parallel over time instead of over partitions.
+   *
+   * @param [in] SmFinal: The final Sm for Riccati equation.
+   * @param [in] SvFinal: The final Sv for Riccati equation.
+   * @param [in] sFinal: The final s for Riccati equation.
+   *
+   * @return average time step
+   */
+  scalar_t solveSequentialRiccatiEquations(const state_matrix_t& SmFinal, const state_vector_t& SvFinal,
+                                           const eigen_scalar_t& sFinal) override;
+
   void getStateInputConstraintLagrangian(scalar_t time, const state_vector_t& state, dynamic_vector_t& nu) const override;
 
   /**
@@ -213,6 +230,67 @@ class SLQ final : public DDP_BASE<STATE_DIM, INPUT_DIM> {
   void riccatiEquationsWorker(size_t workerIndex, size_t partitionIndex, const state_matrix_t& SmFinal, const state_vector_t& SvFinal,
                               const eigen_scalar_t& sFinal);
 
+  /**
+   * Solves the Riccati equations for the partition in the given index as a discrete-time recursion on the nominal time trajectory.
+   * Each time step is discretized with the LQ model at its beginning, so the recursion converges to the Riccati equations as the
+   * time step goes to zero. All kernels are fixed-size and there is neither adaptive stepping nor interpolation.
+   *
+   * @param [in] partitionIndex: The requested partition index to solve Riccati equations.
+   * @param [in] SmFinal: The final Sm for Riccati equation.
+   * @param [in] SvFinal: The final Sv for Riccati equation.
+   * @param [in] sFinal: The final s for Riccati equation.
+   */
+  void discreteRiccatiEquationsWorker(size_t partitionIndex, const state_matrix_t& SmFinal, const state_vector_t& SvFinal,
+                                      const eigen_scalar_t& sFinal);
+
+  /**
+   * Sets the time and normalized time trajectories of the discrete-time Riccati recursion and resizes the value function trajectories.
+   *
+   * @param [in] partitionIndex: The requested partition index.
+   */
+  void initializeDiscreteRiccatiTrajectories(size_t partitionIndex);
+
+  /**
+   * Computes the value function at time node k of the discrete-time Riccati recursion from the one at node k + 1.
+   *
+   * @param [in] partitionIndex: The requested partition index.
+   * @param [in] k: Time index in the partition.
+   */
+  void discreteRiccatiStep(size_t partitionIndex, size_t k);
+
+  /**
+   * Computes the conditional value function of the step from time node k to k + 1 of the discrete-time Riccati recursion.
+   *
+   * @param [in] partitionIndex: The requested partition index.
+   * @param [in] k: Time index in the partition.
+   * @param [out] element: The conditional value function of the step.
+   */
+  void discreteRiccatiStepElement(size_t partitionIndex, size_t k, riccati_element_t& element) const;
+
+  /**
+   * Solves the discrete-time Riccati recursion and the error equation of all active partitions in parallel over time.
+   */
+  void timeParallelRiccatiSolver();
+
+  /**
+   * Computes the coefficients of the error equation dSve/dt = -(Gm' Sve + Gv) at time node k.
+   *
+   * @param [in] partitionIndex: The requested partition index.
+   * @param [in] k: Time index in the partition.
+   * @param [in] Sm: The Riccati matrix at time node k.
+   * @param [out] Gm: The state matrix of the error equation.
+   * @param [out] Gv: The bias of the error equation.
+   */
+  void computeErrorEquationCoefficients(size_t partitionIndex, size_t k, const state_matrix_t& Sm, state_matrix_t& Gm,
+                                        state_vector_t& Gv) const;
+
+  /**
+   * Throws if the value function of the given partition is not finite or Sm is not positive semi-definite.
+   *
+   * @param [in] partitionIndex: The requested partition index.
+   */
+  void checkRiccatiNumericalStability(size_t partitionIndex) const;
+
   /**
    * Type_1 constraints error correction compensation which solves a set of error Riccati equations for the partition in the given index.
    *
@@ -276,10 +354,20 @@ class SLQ final : public DDP_BASE<STATE_DIM, INPUT_DIM> {
   input_matrix_array2_t DmProjectedTrajectoryStock_;        // DmDager * Dm
   input_matrix_array2_t RmInverseTrajectoryStock_;
 
+  // backward pass buffers, kept over iterations to reuse their capacity
+  std::vector<s_vector_array_t> allSsTrajectoryStock_;
+  state_vector_array2_t GvTrajectoryStock_;
+  state_matrix_array2_t GmTrajectoryStock_;
+
   std::vector<std::shared_ptr<riccati_equations_t>> riccatiEquationsPtrStock_;
   std::vector<std::unique_ptr<IntegratorBase<riccati_equations_t::S_DIM_>>> riccatiIntegratorPtrStock_;
   std::vector<std::shared_ptr<error_equation_t>> errorEquationPtrStock_;
   std::vector<std::unique_ptr<IntegratorBase<STATE_DIM>>> errorIntegratorPtrStock_;
+
+  // time-parallel Riccati solver, nodes as (partition index, time index) of all active partitions
+  std::vector<std::pair<size_t, size_t>> timeParallelNodes_;
+  TimeParallelBackwardRecursion<riccati_element_t> timeParallelRiccati_;
+  TimeParallelBackwardRecursion<error_equation_element_t> timeParallelErrorEquation_;
 };
 
 }  // namespace ocs2
@@ -52,6 +52,8 @@ class SLQ_Settings {
    */
   SLQ_Settings()
       : useNominalTimeForBackwardPass_(false),
+        useDiscreteTimeRiccati_(false),
+        useTimeParallelRiccati_(false),
         preComputeRiccatiTerms_(true),
         RiccatiIntegratorType_(IntegratorType::ODE45),
         adams_integrator_dt_(0.001),
@@ -86,6 +88,12 @@ class SLQ_Settings {
 
   /** If true, SLQ solves the backward path over the nominal time trajectory. */
   bool useNominalTimeForBackwardPass_;
+  /** If true, SLQ solves the backward path as a discrete-time Riccati recursion on the nominal time trajectory instead of integrating
+   * the Riccati equations. The cost of the backward pass is then fixed by the number of time nodes. */
+  bool useDiscreteTimeRiccati_;
+  /** If true, the discrete-time Riccati recursion (useDiscreteTimeRiccati_) is solved in parallel over time by combining the
+   * time steps with an associative scan, so all threads are used independent of the number of partitions. */
+  bool useTimeParallelRiccati_;
   /** If true, terms of the Riccati equation will be precomputed before interpolation in the flowmap */
   bool preComputeRiccatiTerms_;
   /** Riccati integrator type. */
@@ -110,6 +118,8 @@ inline void SLQ_Settings::loadSettings(const std::string& filename, const std::s
   }
 
   loadData::loadPtreeValue(pt, useNominalTimeForBackwardPass_, fieldName + ".useNominalTimeForBackwardPass", verbose);
+  loadData::loadPtreeValue(pt, useDiscreteTimeRiccati_, fieldName + ".useDiscreteTimeRiccati", verbose);
+  loadData::loadPtreeValue(pt, useTimeParallelRiccati_, fieldName + ".useTimeParallelRiccati", verbose);
   loadData::loadPtreeValue(pt, preComputeRiccatiTerms_, fieldName + ".preComputeRiccatiTerms", verbose);
 
   std::string integratorName = integrator_type::toString(RiccatiIntegratorType_);  // keep default
@@ -56,6 +56,8 @@ DDP_BASE<STATE_DIM, INPUT_DIM>::DDP_BASE(const rollout_base_t* rolloutPtr, const
   dynamicsForwardRolloutPtrStock_.reserve(ddpSettings_.nThreads_);
   operatingTrajectoriesRolloutPtrStock_.clear();
   operatingTrajectoriesRolloutPtrStock_.reserve(ddpSettings_.nThreads_);
+  lqWorkerRanges_ = std::vector<LQWorkerRange>(ddpSettings_.nThreads_);
+  numLQNodesPerWorker_.assign(ddpSettings_.nThreads_, 0);
 
   // initialize all subsystems, etc.
   for (size_t i = 0; i < ddpSettings_.nThreads_; i++) {
@@ -122,6 +124,7 @@ template <size_t STATE_DIM, size_t INPUT_DIM>
 void DDP_BASE<STATE_DIM, INPUT_DIM>::reset() {
   iteration_ = 0;
   rewindCounter_ = 0;
+  realTimeIterationPrepared_ = false;
 
   learningRateStar_ = 1.0;
   maxLearningRate_ = 1.0;
@@ -165,7 +168,8 @@ void DDP_BASE<STATE_DIM, INPUT_DIM>::reset() {
 template <size_t STATE_DIM, size_t INPUT_DIM>
 typename DDP_BASE<STATE_DIM, INPUT_DIM>::scalar_t DDP_BASE<STATE_DIM, INPUT_DIM>::rolloutTrajectory(
     linear_controller_array_t& controllersStock, scalar_array2_t& timeTrajectoriesStock, size_array2_t& postEventIndicesStock,
-    state_vector_array2_t& stateTrajectoriesStock, input_vector_array2_t& inputTrajectoriesStock, size_t threadId /*= 0*/) {
+    state_vector_array2_t& stateTrajectoriesStock, input_vector_array2_t& inputTrajectoriesStock, size_t threadId /*= 0*/,
+    const rollout_partition_callback_t& partitionCallback /*= nullptr*/) {
   const scalar_array_t& eventTimes = this->getModeSchedule().eventTimes;
 
   if (controllersStock.size() != numPartitions_) {
@@ -287,6 +291,10 @@ typename DDP_BASE<STATE_DIM, INPUT_DIM>::scalar_t DDP_BASE<STATE_DIM, INPUT_DIM>
 
     // total number of steps
     numSteps += timeTrajectoriesStock[i].size();
+
+    if (partitionCallback) {
+      partitionCallback(i);
+    }
   }  // end of i loop
 
   if (!xCurrent.allFinite()) {
@@ -484,6 +492,19 @@ auto DDP_BASE<STATE_DIM, INPUT_DIM>::calculateRolloutCost(const scalar_array2_t&
   }  // end of i loop
 
   // calculate the Heuristics function at the final time
+  totalCost += calculateRolloutHeuristicsCost(timeTrajectoriesStock, stateTrajectoriesStock, inputTrajectoriesStock, threadId);
+
+  return totalCost;
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/***************************************************************************************************** */
+template <size_t STATE_DIM, size_t INPUT_DIM>
+auto DDP_BASE<STATE_DIM, INPUT_DIM>::calculateRolloutHeuristicsCost(const scalar_array2_t& timeTrajectoriesStock,
+                                                                    const state_vector_array2_t& stateTrajectoriesStock,
+                                                                    const input_vector_array2_t& inputTrajectoriesStock, size_t threadId)
+    -> scalar_t {
   // set desired trajectories
   heuristicsFunctionsPtrStock_[threadId]->setCostDesiredTrajectoriesPtr(&this->getCostDesiredTrajectories());
   // set state-input
@@ -493,9 +514,7 @@ auto DDP_BASE<STATE_DIM, INPUT_DIM>::calculateRolloutCost(const scalar_array2_t&
   // compute
   scalar_t sHeuristics;
   heuristicsFunctionsPtrStock_[threadId]->getTerminalCost(sHeuristics);
-  totalCost += sHeuristics;
-
-  return totalCost;
+  return sHeuristics;
 }
 
 /******************************************************************************************************/
@@ -534,6 +553,8 @@ void DDP_BASE<STATE_DIM, INPUT_DIM>::calculateRolloutMerit(const size_array2_t&
 /***************************************************************************************************** */
 template <size_t STATE_DIM, size_t INPUT_DIM>
 void DDP_BASE<STATE_DIM, INPUT_DIM>::approximateOptimalControlProblem() {
+  lqPartitionOffsets_.resize(numPartitions_ + 1);
+  lqPartitionOffsets_[0] = 0;
   for (size_t i = 0; i < numPartitions_; i++) {
     // number of the intermediate LQ variables
     auto N = nominalTimeTrajectoriesStock_[i].size();
@@ -581,31 +602,59 @@ void DDP_BASE<STATE_DIM, INPUT_DIM>::approximateOptimalControlProblem() {
     QvFinalStock_[i].resize(NE);
     QmFinalStock_[i].resize(NE);
 
-    if (N > 0) {
-      for (size_t j = 0; j < ddpSettings_.nThreads_; j++) {
-        // set desired trajectories
-        linearQuadraticApproximatorPtrStock_[j]->costFunction().setCostDesiredTrajectoriesPtr(&this->getCostDesiredTrajectories());
-      }  // end of j loop
-
-      // perform the approximateLQWorker for partition i
-      nextTimeIndex_ = 0;
-      nextTaskId_ = 0;
-      std::function<void(void)> task = [this, i] {
-        int N = nominalTimeTrajectoriesStock_[i].size();
-        int timeIndex;
-        size_t taskId = nextTaskId_++;  // assign task ID (atomic)
-
-        // get next time index is atomic
-        while ((timeIndex = nextTimeIndex_++) < N) {
-          // execute approximateLQ for the given partition and time node index
-          approximateLQWorker(taskId, i, timeIndex);
-        }
-      };
-      runParallel(task, ddpSettings_.nThreads_);
-    }
-
+    lqPartitionOffsets_[i + 1] = lqPartitionOffsets_[i] + N;
   }  // end of i loop
 
+  const size_t numNodes = lqPartitionOffsets_.back();
+  if (numNodes > 0) {
+    const size_t nThreads = ddpSettings_.nThreads_;
+    for (size_t j = 0; j < nThreads; j++) {
+      // set desired trajectories
+      linearQuadraticApproximatorPtrStock_[j]->costFunction().setCostDesiredTrajectoriesPtr(&this->getCostDesiredTrajectories());
+    }  // end of j loop
+
+    // the dominant LQ terms which are written per time node
+    const size_t lqBytesPerNode = 2 * sizeof(state_matrix_t) + sizeof(state_input_matrix_t) + sizeof(input_matrix_t) +
+                                  sizeof(input_state_matrix_t) + sizeof(constraint1_state_matrix_t) + sizeof(constraint1_input_matrix_t) +
+                                  sizeof(constraint2_state_matrix_t);
+    const size_t chunkSize =
+        std::max<size_t>(1, std::min<size_t>(lqChunkBytes_ / lqBytesPerNode, numNodes / (lqChunksPerThread_ * nThreads)));
+
+    // All partitions are approximated in one parallel region. Each worker starts on its own consecutive stretch of the
+    // horizon, which it consumes chunk by chunk. Afterwards it helps the other workers by claiming chunks from their stretches.
+    for (size_t j = 0; j < nThreads; j++) {
+      lqWorkerRanges_[j].next = j * numNodes / nThreads;
+      lqWorkerRanges_[j].end = (j + 1) * numNodes / nThreads;
+    }
+    nextTaskId_ = 0;
+    std::function<void(void)> task = [this, nThreads, chunkSize] {
+      const size_t taskId = nextTaskId_++;  // assign task ID (atomic)
+
+      size_t numProcessedNodes = 0;
+      for (size_t j = 0; j < nThreads; j++) {
+        LQWorkerRange& range = lqWorkerRanges_[(taskId + j) % nThreads];
+
+        // get next chunk of global time indices (atomic)
+        size_t chunkStart;
+        while ((chunkStart = range.next.fetch_add(chunkSize)) < range.end) {
+          const size_t chunkEnd = std::min(chunkStart + chunkSize, range.end);
+          // partition of the first node in the chunk, upper_bound skips the empty partitions
+          size_t i = std::upper_bound(lqPartitionOffsets_.begin(), lqPartitionOffsets_.end(), chunkStart) - lqPartitionOffsets_.begin() - 1;
+          for (size_t globalIndex = chunkStart; globalIndex < chunkEnd; globalIndex++) {
+            while (globalIndex >= lqPartitionOffsets_[i + 1]) {
+              i++;
+            }
+            // execute approximateLQ for the given partition and time node index
+            approximateLQWorker(taskId, i, globalIndex - lqPartitionOffsets_[i]);
+          }
+          numProcessedNodes += chunkEnd - chunkStart;
+        }
+      }
+      numLQNodesPerWorker_[taskId] = numProcessedNodes;
+    };
+    runParallel(task, nThreads);
+  }
+
   // calculate the Heuristics function at the final time
   heuristicsFunctionsPtrStock_[0]->setCostDesiredTrajectoriesPtr(&this->getCostDesiredTrajectories());
   heuristicsFunctionsPtrStock_[0]->setCurrentStateAndControl(nominalTimeTrajectoriesStock_[finalActivePartition_].back(),
@@ -733,8 +782,11 @@ void DDP_BASE<STATE_DIM, INPUT_DIM>::lineSearch() {
   baselineRollout();
 
   baselineMerit_ = performanceIndex_.merit;
-  learningRateStar_ = 0.0;                             // input correction learning rate is zero
-  initLScontrollersStock_ = nominalControllersStock_;  // this will serve to init the workers
+  learningRateStar_ = 0.0;  // input correction learning rate is zero
+  // this will serve to init the workers
+  for (size_t i = 0; i < numPartitions_; i++) {
+    copyControllerInPlace(nominalControllersStock_[i], initLScontrollersStock_[i]);
+  }
 
   // if no line search
   if (ddpSettings_.maxLearningRate_ < OCS2NumericTraits<scalar_t>::limitEpsilon()) {
@@ -754,7 +806,7 @@ void DDP_BASE<STATE_DIM, INPUT_DIM>::lineSearch() {
       std::log(ddpSettings_.minLearningRate_ / ddpSettings_.maxLearningRate_) / std::log(ddpSettings_.lineSearchContractionRate_) + 1);
 
   alphaExpNext_ = 0;
-  alphaProcessed_ = std::vector<bool>(maxNumOfLineSearches, false);
+  alphaProcessed_.assign(maxNumOfLineSearches, false);
 
   nextTaskId_ = 0;
   std::function<void(void)> task = [this] { lineSearchTask(); };
@@ -829,11 +881,7 @@ void DDP_BASE<STATE_DIM, INPUT_DIM>::lineSearchTask() {
   // local search forward simulation's variables
   PerformanceIndex lsPerformanceIndex;
   scalar_t lsConstraint1MaxNorm, lsConstraint2MaxNorm;
-  linear_controller_array_t lsControllersStock(numPartitions_);
-  scalar_array2_t lsTimeTrajectoriesStock(numPartitions_);
-  size_array2_t lsPostEventIndicesStock(numPartitions_);
-  state_vector_array2_t lsStateTrajectoriesStock(numPartitions_);
-  input_vector_array2_t lsInputTrajectoriesStock(numPartitions_);
+  LineSearchWorkspace& workspace = lineSearchWorkspaces_[taskId];
 
   while (true) {
     size_t alphaExp = alphaExpNext_++;
@@ -861,9 +909,10 @@ void DDP_BASE<STATE_DIM, INPUT_DIM>::lineSearchTask() {
     }
 
     // do a line search
-    lsControllersStock = initLScontrollersStock_;
-    lineSearchWorker(taskId, learningRate, lsPerformanceIndex, lsConstraint1MaxNorm, lsConstraint2MaxNorm, lsControllersStock,
-                     lsTimeTrajectoriesStock, lsPostEventIndicesStock, lsStateTrajectoriesStock, lsInputTrajectoriesStock);
+    for (size_t i = 0; i < numPartitions_; i++) {
+      copyControllerInPlace(initLScontrollersStock_[i], workspace.controllersStock[i]);
+    }
+    lineSearchWorker(taskId, learningRate, lsPerformanceIndex, lsConstraint1MaxNorm, lsConstraint2MaxNorm, workspace);
 
     bool terminateLinesearchTasks = false;
     {
@@ -880,11 +929,12 @@ void DDP_BASE<STATE_DIM, INPUT_DIM>::lineSearchTask() {
         nominalConstraint2MaxNorm_ = lsConstraint2MaxNorm;
         performanceIndex_ = lsPerformanceIndex;
 
-        nominalControllersStock_.swap(lsControllersStock);
-        nominalTimeTrajectoriesStock_.swap(lsTimeTrajectoriesStock);
-        nominalPostEventIndicesStock_.swap(lsPostEventIndicesStock);
-        nominalStateTrajectoriesStock_.swap(lsStateTrajectoriesStock);
-        nominalInputTrajectoriesStock_.swap(lsInputTrajectoriesStock);
+        // the swaps hand the previous nominal buffers to this workspace, so no memory is lost to the pool
+        nominalControllersStock_.swap(workspace.controllersStock);
+        nominalTimeTrajectoriesStock_.swap(workspace.timeTrajectoriesStock);
+        nominalPostEventIndicesStock_.swap(workspace.postEventIndicesStock);
+        nominalStateTrajectoriesStock_.swap(workspace.stateTrajectoriesStock);
+        nominalInputTrajectoriesStock_.swap(workspace.inputTrajectoriesStock);
 
         // whether to stop all other thread.
         terminateLinesearchTasks = true;
@@ -919,10 +969,13 @@ void DDP_BASE<STATE_DIM, INPUT_DIM>::lineSearchTask() {
 template <size_t STATE_DIM, size_t INPUT_DIM>
 void DDP_BASE<STATE_DIM, INPUT_DIM>::lineSearchWorker(size_t workerIndex, scalar_t learningRate, PerformanceIndex& lsPerformanceIndex,
                                                       scalar_t& lsConstraint1MaxNorm, scalar_t& lsConstraint2MaxNorm,
-                                                      linear_controller_array_t& lsControllersStock,
-                                                      scalar_array2_t& lsTimeTrajectoriesStock, size_array2_t& lsPostEventIndicesStock,
-                                                      state_vector_array2_t& lsStateTrajectoriesStock,
-                                                      input_vector_array2_t& lsInputTrajectoriesStock) {
+                                                      LineSearchWorkspace& workspace) {
+  linear_controller_array_t& lsControllersStock = workspace.controllersStock;
+  scalar_array2_t& lsTimeTrajectoriesStock = workspace.timeTrajectoriesStock;
+  size_array2_t& lsPostEventIndicesStock = workspace.postEventIndicesStock;
+  state_vector_array2_t& lsStateTrajectoriesStock = workspace.stateTrajectoriesStock;
+  input_vector_array2_t& lsInputTrajectoriesStock = workspace.inputTrajectoriesStock;
+
   // modifying uff by local increments
   for (size_t i = 0; i < numPartitions_; i++) {
     for (size_t k = 0; k < lsControllersStock[i].timeStamp_.size(); k++) {
@@ -930,20 +983,40 @@ void DDP_BASE<STATE_DIM, INPUT_DIM>::lineSearchWorker(size_t workerIndex, scalar
     }
   }
 
+  // the same acceptance condition as in lineSearchTask
+  const scalar_t acceptableMerit = baselineMerit_ * (1 - 1e-3 * learningRate);
+  const bool useMeritBound = ddpSettings_.useLineSearchMeritBound_;
+  scalar_t partialCost = 0.0;
+
+  // This is checked after each rolled out partition. The rollout is stopped as soon as a larger learning rate is accepted or, if
+  // useLineSearchMeritBound_ is set, the cost of the partitions so far (a lower bound of the merit) rules out the acceptance.
+  const rollout_partition_callback_t partitionCallback = [&](size_t i) {
+    if (learningRate < learningRateStar_) {
+      throw std::runtime_error("a larger learning rate is already found!");
+    }
+    if (useMeritBound) {
+      partialCost += calculateCostWorker(workerIndex, i, lsTimeTrajectoriesStock[i], lsPostEventIndicesStock[i],
+                                         lsStateTrajectoriesStock[i], lsInputTrajectoriesStock[i]);
+      if (partialCost >= acceptableMerit) {
+        throw std::runtime_error("the cost up to partition " + std::to_string(i) + " exceeds the acceptable merit!");
+      }
+    }
+  };
+
   try {
     // perform a rollout
     scalar_t avgTimeStepFP = rolloutTrajectory(lsControllersStock, lsTimeTrajectoriesStock, lsPostEventIndicesStock,
-                                               lsStateTrajectoriesStock, lsInputTrajectoriesStock, workerIndex);
+                                               lsStateTrajectoriesStock, lsInputTrajectoriesStock, workerIndex, partitionCallback);
 
     // calculate rollout constraints
-    size_array2_t lsNc1TrajectoriesStock(numPartitions_);
-    constraint1_vector_array2_t lsEvTrajectoryStock(numPartitions_);
-    size_array2_t lsNc2TrajectoriesStock(numPartitions_);
-    constraint2_vector_array2_t lsHvTrajectoryStock(numPartitions_);
-    size_array2_t lsNcIneqTrajectoriesStock(numPartitions_);
-    scalar_array3_t lshTrajectoryStock(numPartitions_);
-    size_array2_t lsNc2FinalStock(numPartitions_);
-    constraint2_vector_array2_t lsHvFinalStock(numPartitions_);
+    size_array2_t& lsNc1TrajectoriesStock = workspace.nc1TrajectoriesStock;
+    constraint1_vector_array2_t& lsEvTrajectoryStock = workspace.EvTrajectoryStock;
+    size_array2_t& lsNc2TrajectoriesStock = workspace.nc2TrajectoriesStock;
+    constraint2_vector_array2_t& lsHvTrajectoryStock = workspace.HvTrajectoryStock;
+    size_array2_t& lsNcIneqTrajectoriesStock = workspace.ncIneqTrajectoriesStock;
+    scalar_array3_t& lshTrajectoryStock = workspace.hTrajectoryStock;
+    size_array2_t& lsNc2FinalStock = workspace.nc2FinalStock;
+    constraint2_vector_array2_t& lsHvFinalStock = workspace.HvFinalStock;
 
     // calculate rollout constraints
     calculateRolloutConstraints(lsTimeTrajectoriesStock, lsPostEventIndicesStock, lsStateTrajectoriesStock, lsInputTrajectoriesStock,
@@ -959,9 +1032,14 @@ void DDP_BASE<STATE_DIM, INPUT_DIM>::lineSearchWorker(size_t workerIndex, scalar
     lsPerformanceIndex.inequalityConstraintPenalty = calculateInequalityConstraintPenalty(
         lsTimeTrajectoriesStock, lsNcIneqTrajectoriesStock, lshTrajectoryStock, lsPerformanceIndex.inequalityConstraintISE, workerIndex);
 
-    // calculate rollout cost
-    lsPerformanceIndex.totalCost = calculateRolloutCost(lsTimeTrajectoriesStock, lsPostEventIndicesStock, lsStateTrajectoriesStock,
-                                                        lsInputTrajectoriesStock, workerIndex);
+    // calculate rollout cost, with the merit bound the partitions' costs are already summed up
+    if (useMeritBound) {
+      lsPerformanceIndex.totalCost = partialCost + calculateRolloutHeuristicsCost(lsTimeTrajectoriesStock, lsStateTrajectoriesStock,
+                                                                                  lsInputTrajectoriesStock, workerIndex);
+    } else {
+      lsPerformanceIndex.totalCost = calculateRolloutCost(lsTimeTrajectoriesStock, lsPostEventIndicesStock, lsStateTrajectoriesStock,
+                                                          lsInputTrajectoriesStock, workerIndex);
+    }
     // calculates merit
     calculateRolloutMerit(lsNc2FinalStock, lsHvFinalStock, lsPerformanceIndex, workerIndex);
 
@@ -990,6 +1068,18 @@ void DDP_BASE<STATE_DIM, INPUT_DIM>::lineSearchWorker(size_t workerIndex, scalar
   }
 }
 
+/******************************************************************************************************/
+/******************************************************************************************************/
+/***************************************************************************************************** */
+template <size_t STATE_DIM, size_t INPUT_DIM>
+void DDP_BASE<STATE_DIM, INPUT_DIM>::copyControllerInPlace(const linear_controller_t& source, linear_controller_t& destination) {
+  // std::vector assignment reuses the destination's capacity
+  destination.timeStamp_ = source.timeStamp_;
+  destination.biasArray_ = source.biasArray_;
+  destination.deltaBiasArray_ = source.deltaBiasArray_;
+  destination.gainArray_ = source.gainArray_;
+}
+
 /******************************************************************************************************/
 /******************************************************************************************************/
 /***************************************************************************************************** */
@@ -1419,6 +1509,14 @@ const std::vector<PerformanceIndex>& DDP_BASE<STATE_DIM, INPUT_DIM>::getIteratio
   return performanceIndexHistory_;
 }
 
+/******************************************************************************************************/
+/******************************************************************************************************/
+/***************************************************************************************************** */
+template <size_t STATE_DIM, size_t INPUT_DIM>
+auto DDP_BASE<STATE_DIM, INPUT_DIM>::getNumLQNodesPerWorker() const -> const size_array_t& {
+  return numLQNodesPerWorker_;
+}
+
 /******************************************************************************************************/
 /******************************************************************************************************/
 /***************************************************************************************************** */
@@ -1512,6 +1610,18 @@ const typename DDP_BASE<STATE_DIM, INPUT_DIM>::scalar_array_t& DDP_BASE<STATE_DI
   return partitioningTimes_;
 }
 
+/******************************************************************************************************/
+/******************************************************************************************************/
+/***************************************************************************************************** */
+template <size_t STATE_DIM, size_t INPUT_DIM>
+void DDP_BASE<STATE_DIM, INPUT_DIM>::getNominalTrajectoriesPtr(const scalar_array2_t*& nominalTimeTrajectoriesStockPtr,
+                                                               const state_vector_array2_t*& nominalStateTrajectoriesStockPtr,
+                                                               const input_vector_array2_t*& nominalInputTrajectoriesStockPtr) const {
+  nominalTimeTrajectoriesStockPtr = &nominalTimeTrajectoriesStock_;
+  nominalStateTrajectoriesStockPtr = &nominalStateTrajectoriesStock_;
+  nominalInputTrajectoriesStockPtr = &nominalInputTrajectoriesStock_;
+}
+
 /******************************************************************************************************/
 /******************************************************************************************************/
 /***************************************************************************************************** */
@@ -1529,10 +1639,16 @@ void DDP_BASE<STATE_DIM, INPUT_DIM>::rewindOptimizer(size_t firstIndex) {
     throw std::runtime_error("Index for rewinding is greater than the current size.");
   }
 
+  // shift the partitions. The trajectories and controllers are swapped, so only their buffers change places. The nominal trajectories
+  // move along with their partitions such that the next run caches them for the same time span.
   const size_t preservedLength = numPartitions_ - firstIndex;
   for (size_t i = 0; i < numPartitions_; i++) {
     if (i < preservedLength) {
       nominalControllersStock_[i].swap(nominalControllersStock_[firstIndex + i]);
+      nominalTimeTrajectoriesStock_[i].swap(nominalTimeTrajectoriesStock_[firstIndex + i]);
+      nominalPostEventIndicesStock_[i].swap(nominalPostEventIndicesStock_[firstIndex + i]);
+      nominalStateTrajectoriesStock_[i].swap(nominalStateTrajectoriesStock_[firstIndex + i]);
+      nominalInputTrajectoriesStock_[i].swap(nominalInputTrajectoriesStock_[firstIndex + i]);
       SmFinalStock_[i] = SmFinalStock_[firstIndex + i];
       SvFinalStock_[i] = SvFinalStock_[firstIndex + i];
       SveFinalStock_[i] = SveFinalStock_[firstIndex + i];
@@ -1540,6 +1656,10 @@ void DDP_BASE<STATE_DIM, INPUT_DIM>::rewindOptimizer(size_t firstIndex) {
       xFinalStock_[i] = xFinalStock_[firstIndex + i];
     } else {
       nominalControllersStock_[i].clear();
+      nominalTimeTrajectoriesStock_[i].clear();
+      nominalPostEventIndicesStock_[i].clear();
+      nominalStateTrajectoriesStock_[i].clear();
+      nominalInputTrajectoriesStock_[i].clear();
       SmFinalStock_[i].setZero();
       SvFinalStock_[i].setZero();
       SveFinalStock_[i].setZero();
@@ -1603,7 +1723,7 @@ void DDP_BASE<STATE_DIM, INPUT_DIM>::distributeWork() {
 /******************************************************************************************************/
 /***************************************************************************************************** */
 template <size_t STATE_DIM, size_t INPUT_DIM>
-void DDP_BASE<STATE_DIM, INPUT_DIM>::runParallel(std::function<void(void)> taskFunction, size_t N) {
+void DDP_BASE<STATE_DIM, INPUT_DIM>::runParallel(const std::function<void(void)>& taskFunction, size_t N) {
   threadPool_.runParallel([&](int) { taskFunction(); }, N);
 }
 
@@ -1616,6 +1736,9 @@ void DDP_BASE<STATE_DIM, INPUT_DIM>::setupOptimizer(size_t numPartitions) {
     throw std::runtime_error("Number of partitions cannot be zero!");
   }
 
+  // a prepared real-time iteration does not fit the new partitions
+  realTimeIterationPrepared_ = false;
+
   /*
    * nominal trajectories
    */
@@ -1631,6 +1754,15 @@ void DDP_BASE<STATE_DIM, INPUT_DIM>::setupOptimizer(size_t numPartitions) {
   cachedStateTrajectoriesStock_.resize(numPartitions);
   cachedInputTrajectoriesStock_.resize(numPartitions);
 
+  /*
+   * line search
+   */
+  initLScontrollersStock_.resize(numPartitions);
+  lineSearchWorkspaces_.resize(ddpSettings_.nThreads_);
+  for (auto& workspace : lineSearchWorkspaces_) {
+    workspace.resize(numPartitions);
+  }
+
   /*
    * Riccati solver variables and controller update
    */
@@ -1798,6 +1930,35 @@ void DDP_BASE<STATE_DIM, INPUT_DIM>::runIteration() {
   Eigen::setNbThreads(0);
 }
 
+/******************************************************************************************************/
+/******************************************************************************************************/
+/***************************************************************************************************** */
+template <size_t STATE_DIM, size_t INPUT_DIM>
+void DDP_BASE<STATE_DIM, INPUT_DIM>::prepareRealTimeIteration() {
+  // disable Eigen multi-threading
+  Eigen::setNbThreads(1);
+
+  // linearizing the dynamics and quadratizing the cost function along nominal trajectories
+  linearQuadraticApproximationTimer_.startTimer();
+  approximateOptimalControlProblem();
+  linearQuadraticApproximationTimer_.endTimer();
+
+  // solve Riccati equations
+  backwardPassTimer_.startTimer();
+  avgTimeStepBP_ = solveSequentialRiccatiEquations(SmHeuristics_, SvHeuristics_, sHeuristics_);
+  backwardPassTimer_.endTimer();
+
+  // calculate controller
+  computeControllerTimer_.startTimer();
+  calculateController();
+  computeControllerTimer_.endTimer();
+
+  // restore default Eigen thread number
+  Eigen::setNbThreads(0);
+
+  realTimeIterationPrepared_ = true;
+}
+
 /******************************************************************************************************/
 /******************************************************************************************************/
 /***************************************************************************************************** */
@@ -1908,6 +2069,31 @@ void DDP_BASE<STATE_DIM, INPUT_DIM>::runImpl(scalar_t initTime, const state_vect
   // distribution of the sequential tasks (e.g. Riccati solver) in between threads
   distributeWork();
 
+  // real-time iteration: only the line search of the prepared controller update starting from the new initial state
+  const bool runRealTimeIteration = realTimeIterationPrepared_ && controllersPtrStock.empty();
+  realTimeIterationPrepared_ = false;
+  if (runRealTimeIteration) {
+    // cache the nominal trajectories before the new rollout (time, state, input, ...)
+    swapNominalTrajectoriesToCache();
+
+    Eigen::setNbThreads(1);
+    maxLearningRate_ = ddpSettings_.maxLearningRate_;
+    linesearchTimer_.startTimer();
+    lineSearch();
+    linesearchTimer_.endTimer();
+    Eigen::setNbThreads(0);
+
+    performanceIndexHistory_.push_back(performanceIndex_);
+
+    // display
+    if (ddpSettings_.displayInfo_ || ddpSettings_.displayShortSummary_) {
+      std::cerr << "\n" + algorithmName_ + " real-time iteration in time period [" << initTime_ << " ," << finalTime_ << "]" << std::endl;
+      printRolloutInfo();
+      std::cerr << std::endl;
+    }
+    return;
+  }
+
   // run DDP initializer and update the member variables
   runInit();
 
@@ -390,6 +390,65 @@ void SLQ<STATE_DIM, INPUT_DIM>::calculateControllerWorker(size_t workerIndex, si
   }
 }
 
+/******************************************************************************************************/
+/******************************************************************************************************/
+/***************************************************************************************************** */
+template <size_t STATE_DIM, size_t INPUT_DIM>
+typename SLQ<STATE_DIM, INPUT_DIM>::scalar_t SLQ<STATE_DIM, INPUT_DIM>::solveSequentialRiccatiEquations(const state_matrix_t& SmFinal,
+                                                                                                        const state_vector_t& SvFinal,
+                                                                                                        const eigen_scalar_t& sFinal) {
+  if (!settings_.useDiscreteTimeRiccati_ || !settings_.useTimeParallelRiccati_) {
+    return BASE::solveSequentialRiccatiEquations(SmFinal, SvFinal, sFinal);
+  }
+
+  BASE::SmFinalStock_[BASE::finalActivePartition_] = SmFinal;
+  BASE::SvFinalStock_[BASE::finalActivePartition_] = SvFinal;
+  BASE::SveFinalStock_[BASE::finalActivePartition_].setZero();
+  BASE::sFinalStock_[BASE::finalActivePartition_] = sFinal;
+
+  // for inactive subsystems
+  for (size_t i = 0; i < BASE::numPartitions_; i++) {
+    if (i < BASE::initActivePartition_ || i > BASE::finalActivePartition_) {
+      BASE::SsTimeTrajectoryStock_[i].clear();
+      BASE::SsNormalizedTimeTrajectoryStock_[i].clear();
+      BASE::SsNormalizedEventsPastTheEndIndecesStock_[i].clear();
+      BASE::SmTrajectoryStock_[i].clear();
+      BASE::SvTrajectoryStock_[i].clear();
+      BASE::SveTrajectoryStock_[i].clear();
+      BASE::sTrajectoryStock_[i].clear();
+
+      BASE::SmFinalStock_[i].setZero();
+      BASE::SvFinalStock_[i].setZero();
+      BASE::SveFinalStock_[i].setZero();
+      BASE::sFinalStock_[i].setZero();
+      BASE::xFinalStock_[i].setZero();
+    }
+  }
+
+  timeParallelRiccatiSolver();
+
+  // the final values of the partitions as they are cached by the partition-wise solver
+  for (size_t i = BASE::initActivePartition_ + 1; i <= BASE::finalActivePartition_; i++) {
+    BASE::SmFinalStock_[i - 1] = BASE::SmTrajectoryStock_[i].front();
+    BASE::SvFinalStock_[i - 1] = BASE::SvTrajectoryStock_[i].front();
+    BASE::SveFinalStock_[i - 1] = BASE::SveTrajectoryStock_[i].front();
+    BASE::sFinalStock_[i - 1] = BASE::sTrajectoryStock_[i].front();
+    BASE::xFinalStock_[i - 1] = BASE::nominalStateTrajectoriesStock_[i].front();
+  }
+
+  // total number of call
+  size_t numSteps = 0;
+  for (size_t i = BASE::initActivePartition_; i <= BASE::finalActivePartition_; i++) {
+    if (BASE::ddpSettings_.checkNumericalStability_) {
+      checkRiccatiNumericalStability(i);
+    }
+    numSteps += BASE::SsTimeTrajectoryStock_[i].size();
+  }
+
+  // average time step
+  return (BASE::finalTime_ - BASE::initTime_) / numSteps;
+}
+
 /******************************************************************************************************/
 /******************************************************************************************************/
 /***************************************************************************************************** */
@@ -474,45 +533,53 @@ void SLQ<STATE_DIM, INPUT_DIM>::constrainedRiccatiEquationsWorker(size_t workerI
   errorRiccatiEquationWorker(workerIndex, partitionIndex, SveFinal);
 
   // testing the numerical stability of the Riccati equations
-  int N = BASE::SsTimeTrajectoryStock_[partitionIndex].size();
   if (BASE::ddpSettings_.checkNumericalStability_) {
-    for (int k = N - 1; k >= 0; k--) {
-      try {
-        if (!BASE::SmTrajectoryStock_[partitionIndex][k].allFinite()) {
-          throw std::runtime_error("Sm is unstable.");
-        }
-        if (LinearAlgebra::eigenvalues(BASE::SmTrajectoryStock_[partitionIndex][k]).real().minCoeff() <
-            -Eigen::NumTraits<scalar_t>::epsilon()) {
-          throw std::runtime_error(
-              "Sm matrix is not positive semi-definite. It's smallest eigenvalue is " +
-              std::to_string(LinearAlgebra::eigenvalues(BASE::SmTrajectoryStock_[partitionIndex][k]).real().minCoeff()) + ".");
-        }
-        if (!BASE::SvTrajectoryStock_[partitionIndex][k].allFinite()) {
-          throw std::runtime_error("Sv is unstable.");
-        }
-        if (!BASE::SveTrajectoryStock_[partitionIndex][k].allFinite()) {
-          throw std::runtime_error("Sve is unstable");
-        }
-        if (!BASE::sTrajectoryStock_[partitionIndex][k].allFinite()) {
-          throw std::runtime_error("s is unstable");
-        }
-      } catch (const std::exception& error) {
-        std::cerr << "what(): " << error.what() << " at time " << BASE::SsTimeTrajectoryStock_[partitionIndex][k] << " [sec]." << std::endl;
-        for (int kp = k; kp < k + 10; kp++) {
-          if (kp >= N) {
-            continue;
-          }
-          std::cerr << "Sm[" << BASE::SsTimeTrajectoryStock_[partitionIndex][kp] << "]: \t"
-                    << BASE::SmTrajectoryStock_[partitionIndex][kp].norm() << std::endl;
-          std::cerr << "Sv[" << BASE::SsTimeTrajectoryStock_[partitionIndex][kp] << "]: \t"
-                    << BASE::SvTrajectoryStock_[partitionIndex][kp].transpose().norm() << std::endl;
-          std::cerr << "Sve[" << BASE::SsTimeTrajectoryStock_[partitionIndex][kp] << "]:\t"
-                    << BASE::SveTrajectoryStock_[partitionIndex][kp].transpose().norm() << std::endl;
-          std::cerr << "s[" << BASE::SsTimeTrajectoryStock_[partitionIndex][kp] << "]:  \t"
-                    << BASE::sTrajectoryStock_[partitionIndex][kp].transpose().norm() << std::endl;
+    checkRiccatiNumericalStability(partitionIndex);
+  }
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/***************************************************************************************************** */
+template <size_t STATE_DIM, size_t INPUT_DIM>
+void SLQ<STATE_DIM, INPUT_DIM>::checkRiccatiNumericalStability(size_t partitionIndex) const {
+  int N = BASE::SsTimeTrajectoryStock_[partitionIndex].size();
+  for (int k = N - 1; k >= 0; k--) {
+    try {
+      if (!BASE::SmTrajectoryStock_[partitionIndex][k].allFinite()) {
+        throw std::runtime_error("Sm is unstable.");
+      }
+      if (LinearAlgebra::eigenvalues(BASE::SmTrajectoryStock_[partitionIndex][k]).real().minCoeff() <
+          -Eigen::NumTraits<scalar_t>::epsilon()) {
+        throw std::runtime_error(
+            "Sm matrix is not positive semi-definite. It's smallest eigenvalue is " +
+            std::to_string(LinearAlgebra::eigenvalues(BASE::SmTrajectoryStock_[partitionIndex][k]).real().minCoeff()) + ".");
+      }
+      if (!BASE::SvTrajectoryStock_[partitionIndex][k].allFinite()) {
+        throw std::runtime_error("Sv is unstable.");
+      }
+      if (!BASE::SveTrajectoryStock_[partitionIndex][k].allFinite()) {
+        throw std::runtime_error("Sve is unstable");
+      }
+      if (!BASE::sTrajectoryStock_[partitionIndex][k].allFinite()) {
+        throw std::runtime_error("s is unstable");
+      }
+    } catch (const std::exception& error) {
+      std::cerr << "what(): " << error.what() << " at time " << BASE::SsTimeTrajectoryStock_[partitionIndex][k] << " [sec]." << std::endl;
+      for (int kp = k; kp < k + 10; kp++) {
+        if (kp >= N) {
+          continue;
         }
-        throw;
+        std::cerr << "Sm[" << BASE::SsTimeTrajectoryStock_[partitionIndex][kp] << "]: \t"
+                  << BASE::SmTrajectoryStock_[partitionIndex][kp].norm() << std::endl;
+        std::cerr << "Sv[" << BASE::SsTimeTrajectoryStock_[partitionIndex][kp] << "]: \t"
+                  << BASE::SvTrajectoryStock_[partitionIndex][kp].transpose().norm() << std::endl;
+        std::cerr << "Sve[" << BASE::SsTimeTrajectoryStock_[partitionIndex][kp] << "]:\t"
+                  << BASE::SveTrajectoryStock_[partitionIndex][kp].transpose().norm() << std::endl;
+        std::cerr << "s[" << BASE::SsTimeTrajectoryStock_[partitionIndex][kp] << "]:  \t"
+                  << BASE::sTrajectoryStock_[partitionIndex][kp].transpose().norm() << std::endl;
       }
+      throw;
     }
   }
 }
@@ -542,6 +609,11 @@ void SLQ<STATE_DIM, INPUT_DIM>::setupOptimizer(size_t numPartitions) {
   DmProjectedTrajectoryStock_.resize(numPartitions);
   RmInvConstrainedCholTrajectoryStock_.resize(numPartitions);
   RmInverseTrajectoryStock_.resize(numPartitions);
+
+  // backward pass buffers
+  allSsTrajectoryStock_.resize(numPartitions);
+  GvTrajectoryStock_.resize(numPartitions);
+  GmTrajectoryStock_.resize(numPartitions);
 }
 
 /******************************************************************************************************/
@@ -550,6 +622,11 @@ void SLQ<STATE_DIM, INPUT_DIM>::setupOptimizer(size_t numPartitions) {
 template <size_t STATE_DIM, size_t INPUT_DIM>
 void SLQ<STATE_DIM, INPUT_DIM>::riccatiEquationsWorker(size_t workerIndex, size_t partitionIndex, const state_matrix_t& SmFinal,
                                                        const state_vector_t& SvFinal, const eigen_scalar_t& sFinal) {
+  if (settings_.useDiscreteTimeRiccati_) {
+    discreteRiccatiEquationsWorker(partitionIndex, SmFinal, SvFinal, sFinal);
+    return;
+  }
+
   // set data for Riccati equations
   riccatiEquationsPtrStock_[workerIndex]->resetNumFunctionCalls();
   riccatiEquationsPtrStock_[workerIndex]->setData(
@@ -579,7 +656,8 @@ void SLQ<STATE_DIM, INPUT_DIM>::riccatiEquationsWorker(size_t workerIndex, size_
   // Clear output containers
   SsNormalizedTime.clear();
   SsNormalizedEventsPastTheEndIndices.clear();
-  s_vector_array_t allSsTrajectory;
+  auto& allSsTrajectory = allSsTrajectoryStock_[partitionIndex];
+  allSsTrajectory.clear();
 
   /*
    *  The riccati equations are solved backwards in time
@@ -623,6 +701,289 @@ void SLQ<STATE_DIM, INPUT_DIM>::riccatiEquationsWorker(size_t workerIndex, size_
   }
 }
 
+/******************************************************************************************************/
+/******************************************************************************************************/
+/***************************************************************************************************** */
+template <size_t STATE_DIM, size_t INPUT_DIM>
+void SLQ<STATE_DIM, INPUT_DIM>::discreteRiccatiEquationsWorker(size_t partitionIndex, const state_matrix_t& SmFinal,
+                                                               const state_vector_t& SvFinal, const eigen_scalar_t& sFinal) {
+  initializeDiscreteRiccatiTrajectories(partitionIndex);
+
+  auto& SmTrajectory = BASE::SmTrajectoryStock_[partitionIndex];
+  auto& SvTrajectory = BASE::SvTrajectoryStock_[partitionIndex];
+  auto& sTrajectory = BASE::sTrajectoryStock_[partitionIndex];
+  SmTrajectory.back() = SmFinal;
+  SvTrajectory.back() = SvFinal;
+  sTrajectory.back() = sFinal;
+
+  for (int k = static_cast<int>(SmTrajectory.size()) - 2; k >= 0; k--) {
+    discreteRiccatiStep(partitionIndex, k);
+  }
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/***************************************************************************************************** */
+template <size_t STATE_DIM, size_t INPUT_DIM>
+void SLQ<STATE_DIM, INPUT_DIM>::initializeDiscreteRiccatiTrajectories(size_t partitionIndex) {
+  // Const partition containers
+  const auto& nominalTimeTrajectory = BASE::nominalTimeTrajectoriesStock_[partitionIndex];
+  const auto& nominalEventsPastTheEndIndices = BASE::nominalPostEventIndicesStock_[partitionIndex];
+
+  // Modified partition containers
+  auto& SsNormalizedTime = BASE::SsNormalizedTimeTrajectoryStock_[partitionIndex];
+  auto& SsNormalizedEventsPastTheEndIndices = BASE::SsNormalizedEventsPastTheEndIndecesStock_[partitionIndex];
+  auto& SsTimeTrajectory = BASE::SsTimeTrajectoryStock_[partitionIndex];
+
+  // The value function is computed on the nominal time trajectory, the normalized time is kept for the error equation
+  const int nominalTimeSize = nominalTimeTrajectory.size();
+  const int numEvents = nominalEventsPastTheEndIndices.size();
+  SsTimeTrajectory = nominalTimeTrajectory;
+  SsNormalizedTime.resize(nominalTimeSize);
+  for (int k = 0; k < nominalTimeSize; k++) {
+    SsNormalizedTime[nominalTimeSize - 1 - k] = -nominalTimeTrajectory[k];
+  }
+  SsNormalizedEventsPastTheEndIndices.clear();
+  for (int j = numEvents - 1; j >= 0; j--) {
+    SsNormalizedEventsPastTheEndIndices.push_back(nominalTimeSize - nominalEventsPastTheEndIndices[j]);
+  }
+
+  BASE::SmTrajectoryStock_[partitionIndex].resize(nominalTimeSize);
+  BASE::SvTrajectoryStock_[partitionIndex].resize(nominalTimeSize);
+  BASE::sTrajectoryStock_[partitionIndex].resize(nominalTimeSize);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/***************************************************************************************************** */
+template <size_t STATE_DIM, size_t INPUT_DIM>
+void SLQ<STATE_DIM, INPUT_DIM>::discreteRiccatiStep(size_t partitionIndex, size_t k) {
+  // Const partition containers
+  const auto& nominalTimeTrajectory = BASE::nominalTimeTrajectoriesStock_[partitionIndex];
+  const auto& nominalEventsPastTheEndIndices = BASE::nominalPostEventIndicesStock_[partitionIndex];
+
+  // const Data
+  const auto& AmTrajectory = AmConstrainedTrajectoryStock_[partitionIndex];
+  const auto& BmTrajectory = BASE::BmTrajectoryStock_[partitionIndex];
+  const auto& qTrajectory = BASE::qTrajectoryStock_[partitionIndex];
+  const auto& QvTrajectory = QvConstrainedTrajectoryStock_[partitionIndex];
+  const auto& QmTrajectory = QmConstrainedTrajectoryStock_[partitionIndex];
+  const auto& RvTrajectory = BASE::RvTrajectoryStock_[partitionIndex];
+  const auto& RmInvCholTrajectory = RmInvConstrainedCholTrajectoryStock_[partitionIndex];
+  const auto& PmTrajectory = BASE::PmTrajectoryStock_[partitionIndex];
+
+  // Modified partition containers
+  auto& SmTrajectory = BASE::SmTrajectoryStock_[partitionIndex];
+  auto& SvTrajectory = BASE::SvTrajectoryStock_[partitionIndex];
+  auto& sTrajectory = BASE::sTrajectoryStock_[partitionIndex];
+
+  // jump map at the event between k and k + 1
+  const auto eventItr = std::find(nominalEventsPastTheEndIndices.begin(), nominalEventsPastTheEndIndices.end(), k + 1);
+  if (eventItr != nominalEventsPastTheEndIndices.end()) {
+    const size_t eventIndex = eventItr - nominalEventsPastTheEndIndices.begin();
+    SmTrajectory[k] = SmTrajectory[k + 1] + BASE::QmFinalStock_[partitionIndex][eventIndex];
+    SvTrajectory[k] = SvTrajectory[k + 1] + BASE::QvFinalStock_[partitionIndex][eventIndex];
+    sTrajectory[k] = sTrajectory[k + 1] + BASE::qFinalStock_[partitionIndex][eventIndex];
+    return;
+  }
+
+  /*
+   * The input is parametrized as u = RinvChol * v, where RinvChol spans the constrained input space and RinvChol' * Rm * RinvChol = I.
+   * RinvChol is padded with zero columns to INPUT_DIM which keeps all terms fixed-size and does not change the recursion. With
+   * Ad = I + dt * Am, the Hessian, mixed term and gradient of the Q-function w.r.t. v divided by dt are:
+   *  Hm = I + dt * (Bm * RinvChol)' * Sm * (Bm * RinvChol)
+   *  Gm = RinvChol' * (Pm + Bm' * Sm * Ad)
+   *  gv = RinvChol' * (Rv + Bm' * Sv)
+   */
+  const scalar_t dt = nominalTimeTrajectory[k + 1] - nominalTimeTrajectory[k];
+  const auto& Sv = SvTrajectory[k + 1];
+  state_matrix_t Sm = SmTrajectory[k + 1];
+  if (BASE::ddpSettings_.useMakePSD_) {
+    LinearAlgebra::makePSD(Sm);
+  }
+
+  state_matrix_t Ad = dt * AmTrajectory[k];
+  Ad.diagonal().array() += 1.0;
+  input_matrix_t RinvChol = input_matrix_t::Zero();
+  RinvChol.leftCols(RmInvCholTrajectory[k].cols()) = RmInvCholTrajectory[k];
+  const state_input_matrix_t B_RinvChol = BmTrajectory[k] * RinvChol;
+  const state_input_matrix_t Sm_B_RinvChol = Sm * B_RinvChol;
+
+  input_matrix_t Hm = input_matrix_t::Identity();
+  Hm.noalias() += dt * B_RinvChol.transpose() * Sm_B_RinvChol;
+  input_state_matrix_t Gm;
+  Gm.noalias() = RinvChol.transpose() * PmTrajectory[k];
+  Gm.noalias() += Sm_B_RinvChol.transpose() * Ad;
+  input_vector_t gv;
+  gv.noalias() = RinvChol.transpose() * RvTrajectory[k];
+  gv.noalias() += B_RinvChol.transpose() * Sv;
+
+  const Eigen::LLT<input_matrix_t> HmLlt(Hm);
+  const input_state_matrix_t Hinv_Gm = HmLlt.solve(Gm);
+  const input_vector_t Hinv_gv = HmLlt.solve(gv);
+
+  // Sm
+  state_matrix_t SmCurrent = dt * QmTrajectory[k];
+  SmCurrent.noalias() += Ad.transpose() * (Sm * Ad);
+  SmCurrent.noalias() -= dt * Gm.transpose() * Hinv_Gm;
+  SmTrajectory[k] = 0.5 * (SmCurrent + SmCurrent.transpose());
+
+  // Sv
+  SvTrajectory[k] = dt * QvTrajectory[k];
+  SvTrajectory[k].noalias() += Ad.transpose() * Sv;
+  SvTrajectory[k].noalias() -= dt * Gm.transpose() * Hinv_gv;
+
+  // s
+  sTrajectory[k] = sTrajectory[k + 1] + dt * qTrajectory[k];
+  sTrajectory[k].noalias() -= 0.5 * dt * gv.transpose() * Hinv_gv;
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/***************************************************************************************************** */
+template <size_t STATE_DIM, size_t INPUT_DIM>
+void SLQ<STATE_DIM, INPUT_DIM>::discreteRiccatiStepElement(size_t partitionIndex, size_t k, riccati_element_t& element) const {
+  const auto& nominalEventsPastTheEndIndices = BASE::nominalPostEventIndicesStock_[partitionIndex];
+
+  // jump map at the event between k and k + 1
+  const auto eventItr = std::find(nominalEventsPastTheEndIndices.begin(), nominalEventsPastTheEndIndices.end(), k + 1);
+  if (eventItr != nominalEventsPastTheEndIndices.end()) {
+    const size_t eventIndex = eventItr - nominalEventsPastTheEndIndices.begin();
+    element.setIdentity();
+    element.J = BASE::QmFinalStock_[partitionIndex][eventIndex];
+    element.eta = BASE::QvFinalStock_[partitionIndex][eventIndex];
+    element.c = BASE::qFinalStock_[partitionIndex][eventIndex](0);
+    return;
+  }
+
+  /*
+   * Minimizing the cost of the step over v for a given next state y = Ad * x + dt * Bm * RinvChol * v results in:
+   *  A = Ad - dt * (Bm * RinvChol) * (RinvChol' * Pm),      b = -dt * (Bm * RinvChol) * (RinvChol' * Rv)
+   *  C = dt * (Bm * RinvChol) * (Bm * RinvChol)'
+   *  J = dt * (Qm - Pm' * RinvChol * RinvChol' * Pm),       eta = dt * (Qv - Pm' * RinvChol * RinvChol' * Rv)
+   *  c = dt * (q - 0.5 * Rv' * RinvChol * RinvChol' * Rv)
+   */
+  const auto& nominalTimeTrajectory = BASE::nominalTimeTrajectoriesStock_[partitionIndex];
+  const auto& RmInvChol = RmInvConstrainedCholTrajectoryStock_[partitionIndex][k];
+  const scalar_t dt = nominalTimeTrajectory[k + 1] - nominalTimeTrajectory[k];
+
+  input_matrix_t RinvChol = input_matrix_t::Zero();
+  RinvChol.leftCols(RmInvChol.cols()) = RmInvChol;
+  const state_input_matrix_t B_RinvChol = BASE::BmTrajectoryStock_[partitionIndex][k] * RinvChol;
+  const input_state_matrix_t RinvCholT_Pm = RinvChol.transpose() * BASE::PmTrajectoryStock_[partitionIndex][k];
+  const input_vector_t RinvCholT_Rv = RinvChol.transpose() * BASE::RvTrajectoryStock_[partitionIndex][k];
+
+  element.A = dt * AmConstrainedTrajectoryStock_[partitionIndex][k];
+  element.A.diagonal().array() += 1.0;
+  element.A.noalias() -= dt * B_RinvChol * RinvCholT_Pm;
+  element.b.noalias() = -dt * B_RinvChol * RinvCholT_Rv;
+  element.C.noalias() = dt * B_RinvChol * B_RinvChol.transpose();
+  element.J = dt * QmConstrainedTrajectoryStock_[partitionIndex][k];
+  element.J.noalias() -= dt * RinvCholT_Pm.transpose() * RinvCholT_Pm;
+  element.eta = dt * QvConstrainedTrajectoryStock_[partitionIndex][k];
+  element.eta.noalias() -= dt * RinvCholT_Pm.transpose() * RinvCholT_Rv;
+  element.c = dt * (BASE::qTrajectoryStock_[partitionIndex][k](0) - 0.5 * RinvCholT_Rv.squaredNorm());
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/***************************************************************************************************** */
+template <size_t STATE_DIM, size_t INPUT_DIM>
+void SLQ<STATE_DIM, INPUT_DIM>::timeParallelRiccatiSolver() {
+  // time nodes of all active partitions
+  timeParallelNodes_.clear();
+  for (size_t i = BASE::initActivePartition_; i <= BASE::finalActivePartition_; i++) {
+    initializeDiscreteRiccatiTrajectories(i);
+    const size_t nominalTimeSize = BASE::nominalTimeTrajectoriesStock_[i].size();
+    BASE::SveTrajectoryStock_[i].resize(nominalTimeSize);
+    for (size_t k = 0; k < nominalTimeSize; k++) {
+      timeParallelNodes_.emplace_back(i, k);
+    }
+  }
+  const size_t numNodes = timeParallelNodes_.size();
+  if (numNodes == 0) {
+    return;
+  }
+
+  const size_t finalPartition = BASE::finalActivePartition_;
+  BASE::SmTrajectoryStock_[finalPartition].back() = BASE::SmFinalStock_[finalPartition];
+  BASE::SvTrajectoryStock_[finalPartition].back() = BASE::SvFinalStock_[finalPartition];
+  BASE::sTrajectoryStock_[finalPartition].back() = BASE::sFinalStock_[finalPartition];
+  BASE::SveTrajectoryStock_[finalPartition].back() = BASE::SveFinalStock_[finalPartition];
+
+  // The value function is continuous at the partition boundaries, where the last node of a partition is followed by the first
+  // node of the next one.
+  auto isPartitionBoundary = [&](size_t n) { return timeParallelNodes_[n].first != timeParallelNodes_[n + 1].first; };
+
+  // Sm, Sv, s
+  timeParallelRiccati_.solve(
+      BASE::threadPool_, BASE::ddpSettings_.nThreads_, numNodes,
+      [&](size_t n, riccati_element_t& element) {
+        if (isPartitionBoundary(n)) {
+          element.setIdentity();
+        } else {
+          discreteRiccatiStepElement(timeParallelNodes_[n].first, timeParallelNodes_[n].second, element);
+        }
+      },
+      [&](size_t n, riccati_element_t& value) {
+        const size_t i = timeParallelNodes_[n].first;
+        const size_t k = timeParallelNodes_[n].second;
+        value.setValueFunction(BASE::SmTrajectoryStock_[i][k], BASE::SvTrajectoryStock_[i][k], BASE::sTrajectoryStock_[i][k](0));
+      },
+      [&](size_t n, const riccati_element_t& value) {
+        const size_t i = timeParallelNodes_[n].first;
+        const size_t k = timeParallelNodes_[n].second;
+        BASE::SmTrajectoryStock_[i][k] = value.J;
+        BASE::SvTrajectoryStock_[i][k] = value.eta;
+        BASE::sTrajectoryStock_[i][k](0) = value.c;
+      },
+      [&](size_t n) {
+        const size_t i = timeParallelNodes_[n].first;
+        const size_t k = timeParallelNodes_[n].second;
+        if (isPartitionBoundary(n)) {
+          BASE::SmTrajectoryStock_[i][k] = BASE::SmTrajectoryStock_[i + 1].front();
+          BASE::SvTrajectoryStock_[i][k] = BASE::SvTrajectoryStock_[i + 1].front();
+          BASE::sTrajectoryStock_[i][k] = BASE::sTrajectoryStock_[i + 1].front();
+        } else {
+          discreteRiccatiStep(i, k);
+        }
+      });
+
+  // Sve, the discrete-time error equation Sve[k] = (I + dt * Gm') * Sve[k + 1] + dt * Gv
+  auto getErrorEquationStep = [&](size_t n, error_equation_element_t& element) {
+    const size_t i = timeParallelNodes_[n].first;
+    const size_t k = timeParallelNodes_[n].second;
+    element.T.setIdentity();
+    element.t.setZero();
+    if (!isPartitionBoundary(n)) {
+      const scalar_t dt = BASE::nominalTimeTrajectoriesStock_[i][k + 1] - BASE::nominalTimeTrajectoriesStock_[i][k];
+      state_matrix_t Gm;
+      state_vector_t Gv;
+      computeErrorEquationCoefficients(i, k, BASE::SmTrajectoryStock_[i][k], Gm, Gv);
+      element.T.noalias() += dt * Gm.transpose();
+      element.t = dt * Gv;
+    }
+  };
+  timeParallelErrorEquation_.solve(
+      BASE::threadPool_, BASE::ddpSettings_.nThreads_, numNodes, getErrorEquationStep,
+      [&](size_t n, error_equation_element_t& value) {
+        value.setValue(BASE::SveTrajectoryStock_[timeParallelNodes_[n].first][timeParallelNodes_[n].second]);
+      },
+      [&](size_t n, const error_equation_element_t& value) {
+        BASE::SveTrajectoryStock_[timeParallelNodes_[n].first][timeParallelNodes_[n].second] = value.t;
+      },
+      [&](size_t n) {
+        const size_t i = timeParallelNodes_[n].first;
+        const size_t k = timeParallelNodes_[n].second;
+        const state_vector_t& SveNext =
+            isPartitionBoundary(n) ? BASE::SveTrajectoryStock_[i + 1].front() : BASE::SveTrajectoryStock_[i][k + 1];
+        error_equation_element_t element;
+        getErrorEquationStep(n, element);
+        BASE::SveTrajectoryStock_[i][k] = element.t;
+        BASE::SveTrajectoryStock_[i][k].noalias() += element.T * SveNext;
+      });
+}
+
 /******************************************************************************************************/
 /******************************************************************************************************/
 /***************************************************************************************************** */
@@ -735,16 +1096,6 @@ void SLQ<STATE_DIM, INPUT_DIM>::errorRiccatiEquationWorker(size_t workerIndex, s
   const auto& SsTimeTrajectory = BASE::SsTimeTrajectoryStock_[partitionIndex];
   const auto& SmTrajectory = BASE::SmTrajectoryStock_[partitionIndex];
 
-  // const Data
-  const auto& PmTrajectory = BASE::PmTrajectoryStock_[partitionIndex];
-  const auto& BmTrajectory = BASE::BmTrajectoryStock_[partitionIndex];
-  const auto& AmTrajectory = AmConstrainedTrajectoryStock_[partitionIndex];
-  const auto& RmInvCholTrajectory = RmInvConstrainedCholTrajectoryStock_[partitionIndex];
-  const auto& RmTrajectory = BASE::RmTrajectoryStock_[partitionIndex];
-  const auto& RmInvTrajectory = RmInverseTrajectoryStock_[partitionIndex];
-  const auto& EvTrajectory = EvProjectedTrajectoryStock_[partitionIndex];
-  const auto& CmTrajectory = CmProjectedTrajectoryStock_[partitionIndex];
-
   // Modified partition containers
   auto& SveTrajectory = BASE::SveTrajectoryStock_[partitionIndex];
 
@@ -758,26 +1109,33 @@ void SLQ<STATE_DIM, INPUT_DIM>::errorRiccatiEquationWorker(size_t workerIndex, s
   /*
    * Calculating the coefficients of the error equation
    */
-  state_vector_array_t GvTrajectory(nominalTimeSize);
-  state_matrix_array_t GmTrajectory(nominalTimeSize);
+  auto& GvTrajectory = GvTrajectoryStock_[partitionIndex];
+  auto& GmTrajectory = GmTrajectoryStock_[partitionIndex];
+  GvTrajectory.resize(nominalTimeSize);
+  GmTrajectory.resize(nominalTimeSize);
   state_matrix_t Sm;
-  input_state_matrix_t Lm;
-  input_vector_t RmEv;
   for (int k = nominalTimeSize - 1; k >= 0; k--) {
     // Sm
-    EigenLinearInterpolation<state_matrix_t>::interpolate(nominalTimeTrajectory[k], Sm, &SsTimeTrajectory, &SmTrajectory);
-    // Lm
-    Lm = PmTrajectory[k];
-    Lm.noalias() += BmTrajectory[k].transpose() * Sm;
-
-    GmTrajectory[k] = AmTrajectory[k];
-    GmTrajectory[k].noalias() -= (BmTrajectory[k] * RmInvCholTrajectory[k]) * (RmInvCholTrajectory[k].transpose() * Lm);
-
-    RmEv.noalias() = RmTrajectory[k] * EvTrajectory[k];
-    GvTrajectory[k].noalias() = CmTrajectory[k].transpose() * RmEv;
-    GvTrajectory[k].noalias() -= Lm.transpose() * (RmInvTrajectory[k].transpose() * RmEv);
+    if (settings_.useDiscreteTimeRiccati_) {
+      Sm = SmTrajectory[k];
+    } else {
+      EigenLinearInterpolation<state_matrix_t>::interpolate(nominalTimeTrajectory[k], Sm, &SsTimeTrajectory, &SmTrajectory);
+    }
+    computeErrorEquationCoefficients(partitionIndex, k, Sm, GmTrajectory[k], GvTrajectory[k]);
   }  // end of k loop
 
+  // the discrete-time counterpart of the error equation on the nominal time trajectory, it has no jumps
+  if (settings_.useDiscreteTimeRiccati_) {
+    SveTrajectory.resize(nominalTimeSize);
+    SveTrajectory.back() = SveFinal;
+    for (int k = nominalTimeSize - 2; k >= 0; k--) {
+      const scalar_t dt = nominalTimeTrajectory[k + 1] - nominalTimeTrajectory[k];
+      SveTrajectory[k] = SveTrajectory[k + 1] + dt * GvTrajectory[k];
+      SveTrajectory[k].noalias() += dt * GmTrajectory[k].transpose() * SveTrajectory[k + 1];
+    }
+    return;
+  }
+
   // set data for error equations
   errorEquationPtrStock_[workerIndex]->resetNumFunctionCalls();
   errorEquationPtrStock_[workerIndex]->setData(&nominalTimeTrajectory, &GvTrajectory, &GmTrajectory);
@@ -829,4 +1187,27 @@ void SLQ<STATE_DIM, INPUT_DIM>::errorRiccatiEquationWorker(size_t workerIndex, s
   std::reverse(SveTrajectory.begin(), SveTrajectory.end());
 }
 
+/******************************************************************************************************/
+/******************************************************************************************************/
+/***************************************************************************************************** */
+template <size_t STATE_DIM, size_t INPUT_DIM>
+void SLQ<STATE_DIM, INPUT_DIM>::computeErrorEquationCoefficients(size_t partitionIndex, size_t k, const state_matrix_t& Sm,
+                                                                 state_matrix_t& Gm, state_vector_t& Gv) const {
+  const auto& Bm = BASE::BmTrajectoryStock_[partitionIndex][k];
+  const auto& RmInvChol = RmInvConstrainedCholTrajectoryStock_[partitionIndex][k];
+  const auto& RmInv = RmInverseTrajectoryStock_[partitionIndex][k];
+
+  // Lm
+  input_state_matrix_t Lm = BASE::PmTrajectoryStock_[partitionIndex][k];
+  Lm.noalias() += Bm.transpose() * Sm;
+
+  Gm = AmConstrainedTrajectoryStock_[partitionIndex][k];
+  Gm.noalias() -= (Bm * RmInvChol) * (RmInvChol.transpose() * Lm);
+
+  input_vector_t RmEv;
+  RmEv.noalias() = BASE::RmTrajectoryStock_[partitionIndex][k] * EvProjectedTrajectoryStock_[partitionIndex][k];
+  Gv.noalias() = CmProjectedTrajectoryStock_[partitionIndex][k].transpose() * RmEv;
+  Gv.noalias() -= Lm.transpose() * (RmInv.transpose() * RmEv);
+}
+
 }  // namespace ocs2
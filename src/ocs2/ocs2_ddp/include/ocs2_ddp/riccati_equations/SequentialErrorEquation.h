@@ -82,6 +82,8 @@ class SequentialErrorEquation final : public OdeBase<STATE_DIM> {
     timeStampPtr_ = timeStampPtr;
     GvPtr_ = GvPtr;
     GmPtr_ = GmPtr;
+    // the integration runs backward in time
+    timeIndexHint_ = timeStampPtr->size();
   }
 
   /**
@@ -106,7 +108,8 @@ class SequentialErrorEquation final : public OdeBase<STATE_DIM> {
     // normal time
     const scalar_t t = -z;
 
-    const auto indexAlpha = EigenLinearInterpolation<state_matrix_t>::interpolate(t, Gm_, timeStampPtr_, GmPtr_);
+    const auto indexAlpha = EigenLinearInterpolation<state_matrix_t>::timeSegment(t, timeStampPtr_, timeIndexHint_);
+    EigenLinearInterpolation<state_matrix_t>::interpolate(indexAlpha, Gm_, GmPtr_);
 
     // derivatives = Gv + Gm*Sve
     EigenLinearInterpolation<state_vector_t>::interpolate(indexAlpha, derivatives, GvPtr_);
@@ -117,6 +120,7 @@ class SequentialErrorEquation final : public OdeBase<STATE_DIM> {
   const scalar_array_t* timeStampPtr_;
   const state_vector_array_t* GvPtr_;
   const state_matrix_array_t* GmPtr_;
+  int timeIndexHint_ = 0;
 
   // members required in computeFlowMap
   state_matrix_t Gm_;
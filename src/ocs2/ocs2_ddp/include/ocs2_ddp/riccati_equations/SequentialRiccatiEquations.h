@@ -173,13 +173,17 @@ class SequentialRiccatiEquations final : public OdeBase<s_vector_dim(STATE_DIM)>
   const state_matrix_array_t* AmPtr_;
   const state_input_matrix_array_t* BmPtr_;
 
-  // Arrays to store precomputation
+  // Arrays to store precomputation. RinvChol is padded with zero columns to the input dimension, so all terms have fixed size.
   state_matrix_array_t Qm_minus_P_Rinv_P_array_;
   state_vector_array_t Qv_minus_P_Rinv_Rv_array_;
   eigen_scalar_array_t q_minus_half_Rv_Rinv_Rv_array_;
   state_matrix_array_t AmT_minus_P_Rinv_B_array_;
-  dynamic_matrix_array_t B_RinvChol_array_;
-  dynamic_vector_array_t RinvCholT_Rv_array_;
+  state_input_matrix_array_t B_RinvChol_array_;
+  input_vector_array_t RinvCholT_Rv_array_;
+  input_matrix_array_t RinvChol_array_;  // only without precomputation
+
+  // interpolation index of the previous computeFlowMap() call
+  int timeIndexHint_;
 
   // members required only in computeFlowMap()
   state_matrix_t Sm_;
@@ -189,14 +193,15 @@ class SequentialRiccatiEquations final : public OdeBase<s_vector_dim(STATE_DIM)>
   state_vector_t Qv_;
   eigen_scalar_t q_;
   state_matrix_t AmT_minus_P_Rinv_Bm_;
-  dynamic_matrix_t B_RinvChol_;
-  dynamic_vector_t RinvCholT_Rv_;
-  dynamic_matrix_t SmT_B_RinvChol_;
+  state_input_matrix_t B_RinvChol_;
+  input_vector_t RinvCholT_Rv_;
+  state_input_matrix_t SmT_B_RinvChol_;
+  input_state_matrix_t RinvCholT_Pm_;
   state_matrix_t AmT_Sm_;
   state_matrix_t Am_;
   state_input_matrix_t Bm_;
   input_vector_t Rv_;
-  dynamic_matrix_t RinvChol_;
+  input_matrix_t RinvChol_;
   input_state_matrix_t Pm_;
 
   scalar_array_t eventTimes_;
@@ -0,0 +1,238 @@
+/******************************************************************************
+Copyright (c) 2017, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <Eigen/StdVector>
+
+#include <ocs2_core/misc/ThreadPool.h>
+
+namespace ocs2 {
+
+/**
+ * Conditional value function of a sequence of discrete-time LQ steps, i.e. the optimal cost to go from state z to state y
+ *
+ *    V(z, y) = max_lambda [ 0.5 z' J z + eta' z + c + lambda' (y - A z - b) - 0.5 lambda' C lambda ].
+ *
+ * The conditional value functions of two consecutive sequences combine into the one of the joined sequence with an associative
+ * operation, which allows to compute the value function of all time nodes with a parallel scan. A value function
+ * 0.5 x' Sm x + Sv' x + s is the special case A = 0, b = 0, C = 0.
+ *
+ * @tparam STATE_DIM: Dimension of the state space.
+ */
+template <size_t STATE_DIM>
+struct ConditionalValueFunction {
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  using scalar_t = double;
+  using state_vector_t = Eigen::Matrix<scalar_t, STATE_DIM, 1>;
+  using state_matrix_t = Eigen::Matrix<scalar_t, STATE_DIM, STATE_DIM>;
+
+  state_matrix_t A;
+  state_vector_t b;
+  state_matrix_t C;
+  state_matrix_t J;
+  state_vector_t eta;
+  scalar_t c;
+
+  /** Sets the element of a sequence without steps, y = z at no cost. */
+  void setIdentity() {
+    A.setIdentity();
+    b.setZero();
+    C.setZero();
+    J.setZero();
+    eta.setZero();
+    c = 0.0;
+  }
+
+  /** Sets the element to the value function 0.5 x' Sm x + Sv' x + s. */
+  void setValueFunction(const state_matrix_t& Sm, const state_vector_t& Sv, scalar_t s) {
+    A.setZero();
+    b.setZero();
+    C.setZero();
+    J = Sm;
+    eta = Sv;
+    c = s;
+  }
+
+  /**
+   * Combines the conditional value function of the earlier sequence with the one of the later sequence. With
+   * M = (I + C_left J_right)^-1 it is:
+   *  A   = A_right M A_left
+   *  b   = A_right M (b_left - C_left eta_right) + b_right
+   *  C   = A_right M C_left A_right' + C_right
+   *  J   = A_left' M' J_right A_left + J_left
+   *  eta = A_left' M' (J_right b_left + eta_right) + eta_left
+   *  c   = c_left + c_right + 0.5 b_left' M' J_right b_left + eta_right' M b_left - 0.5 eta_right' M C_left eta_right
+   *
+   * @param [in] left: Element of the earlier sequence.
+   * @param [in] right: Element of the later sequence.
+   * @return Element of the joined sequence.
+   */
+  static ConditionalValueFunction combine(const ConditionalValueFunction& left, const ConditionalValueFunction& right) {
+    state_matrix_t I_plus_CJ = left.C * right.J;
+    I_plus_CJ.diagonal().array() += 1.0;
+    const Eigen::PartialPivLU<state_matrix_t> lu(I_plus_CJ);
+    const state_matrix_t M_A = lu.solve(left.A);
+    const state_matrix_t M_C = lu.solve(left.C);
+    const state_vector_t M_b = lu.solve(left.b);
+    const state_vector_t M_b_minus_M_C_eta = M_b - M_C * right.eta;
+    const state_vector_t J_b_plus_eta = right.J * left.b + right.eta;
+
+    ConditionalValueFunction result;
+    result.A.noalias() = right.A * M_A;
+    result.b = right.b;
+    result.b.noalias() += right.A * M_b_minus_M_C_eta;
+    const state_matrix_t A_M_C = right.A * M_C;
+    result.C = right.C;
+    result.C.noalias() += 0.5 * A_M_C * right.A.transpose();
+    result.C.noalias() += 0.5 * right.A * A_M_C.transpose();
+    const state_matrix_t AT_MT_J = M_A.transpose() * right.J;
+    result.J = left.J;
+    result.J.noalias() += 0.5 * AT_MT_J * left.A;
+    result.J.noalias() += 0.5 * left.A.transpose() * AT_MT_J.transpose();
+    result.eta = left.eta;
+    result.eta.noalias() += M_A.transpose() * J_b_plus_eta;
+    result.c = left.c + right.c + 0.5 * M_b.dot(right.J * left.b) + right.eta.dot(M_b) - 0.5 * right.eta.dot(M_C * right.eta);
+    return result;
+  }
+};
+
+/**
+ * Affine map of a sequence of steps of the linear backward recursion v_k = T_k v_{k+1} + t_k.
+ *
+ * @tparam STATE_DIM: Dimension of the state space.
+ */
+template <size_t STATE_DIM>
+struct AffineBackwardMap {
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  using scalar_t = double;
+  using state_vector_t = Eigen::Matrix<scalar_t, STATE_DIM, 1>;
+  using state_matrix_t = Eigen::Matrix<scalar_t, STATE_DIM, STATE_DIM>;
+
+  state_matrix_t T;
+  state_vector_t t;
+
+  /** Sets the element to the value v at the end of the recursion. */
+  void setValue(const state_vector_t& v) {
+    T.setZero();
+    t = v;
+  }
+
+  /** Combines the map of the earlier sequence with the one of the later sequence. */
+  static AffineBackwardMap combine(const AffineBackwardMap& left, const AffineBackwardMap& right) {
+    AffineBackwardMap result;
+    result.T.noalias() = left.T * right.T;
+    result.t = left.t;
+    result.t.noalias() += left.T * right.t;
+    return result;
+  }
+};
+
+/**
+ * Solves a backward recursion V_k = e_k (x) V_{k+1} over the time nodes [0, numNodes) in parallel over time, where e_k is the element of
+ * the step from node k to node k + 1 and (x) is an associative combination, e.g. ConditionalValueFunction::combine. The nodes are split
+ * into one block per thread:
+ *  1) every block but the first combines its elements into one element (in parallel),
+ *  2) the values at the block boundaries follow from the combined elements (sequentially, one combination per block),
+ *  3) every block runs the ordinary backward recursion from the value at its end (in parallel).
+ * The work per thread is independent of how the time nodes are partitioned otherwise.
+ *
+ * @tparam ELEMENT: Element type with a static ELEMENT combine(const ELEMENT& left, const ELEMENT& right).
+ */
+template <class ELEMENT>
+class TimeParallelBackwardRecursion {
+ public:
+  /**
+   * Solves the recursion. The value at node numNodes - 1 has to be set before.
+   *
+   * @param [in] threadPool: The thread pool which runs the blocks.
+   * @param [in] numBlocks: Number of blocks, usually the number of threads.
+   * @param [in] numNodes: Number of time nodes.
+   * @param [in] getStepElement: Callable as getStepElement(size_t k, ELEMENT& element), the element of the step from node k to k + 1.
+   * @param [in] getValue: Callable as getValue(size_t k, ELEMENT& value), the value at node k as an element.
+   * @param [in] setValue: Callable as setValue(size_t k, const ELEMENT& value), sets the value at node k.
+   * @param [in] step: Callable as step(size_t k), computes the value at node k from the one at node k + 1.
+   */
+  template <class GetStepElement, class GetValue, class SetValue, class Step>
+  void solve(ThreadPool& threadPool, size_t numBlocks, size_t numNodes, GetStepElement&& getStepElement, GetValue&& getValue,
+             SetValue&& setValue, Step&& step) {
+    if (numNodes < 2) {
+      return;
+    }
+
+    // block p covers the steps [blockStarts_[p], blockStarts_[p + 1])
+    const size_t numSteps = numNodes - 1;
+    numBlocks = std::max(std::min(numBlocks, numSteps), size_t(1));
+    blockStarts_.resize(numBlocks + 1);
+    for (size_t p = 0; p <= numBlocks; p++) {
+      blockStarts_[p] = p * numSteps / numBlocks;
+    }
+    blockElements_.resize(numBlocks);
+
+    // combine the elements of each block, the first one is not needed
+    threadPool.parallelFor(1, numBlocks, 1, [&](int, size_t p) {
+      ELEMENT element;
+      ELEMENT& blockElement = blockElements_[p];
+      getStepElement(blockStarts_[p + 1] - 1, blockElement);
+      for (size_t k = blockStarts_[p + 1] - 1; k-- > blockStarts_[p];) {
+        getStepElement(k, element);
+        blockElement = ELEMENT::combine(element, blockElement);
+      }
+    });
+
+    // values at the block boundaries
+    ELEMENT value;
+    getValue(numNodes - 1, value);
+    for (size_t p = numBlocks - 1; p > 0; p--) {
+      value = ELEMENT::combine(blockElements_[p], value);
+      setValue(blockStarts_[p], value);
+    }
+
+    // the recursion inside the blocks, the values at the block starts are already set except for the first one
+    threadPool.parallelFor(0, numBlocks, 1, [&](int, size_t p) {
+      const size_t blockFirstNode = (p == 0) ? 0 : blockStarts_[p] + 1;
+      for (size_t k = blockStarts_[p + 1]; k-- > blockFirstNode;) {
+        step(k);
+      }
+    });
+  }
+
+ private:
+  std::vector<size_t> blockStarts_;
+  std::vector<ELEMENT, Eigen::aligned_allocator<ELEMENT>> blockElements_;
+};
+
+}  // namespace ocs2
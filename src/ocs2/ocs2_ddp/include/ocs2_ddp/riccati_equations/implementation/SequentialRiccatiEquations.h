@@ -37,7 +37,7 @@ namespace ocs2 {
 /******************************************************************************************************/
 template <int STATE_DIM, int INPUT_DIM>
 SequentialRiccatiEquations<STATE_DIM, INPUT_DIM>::SequentialRiccatiEquations(bool useMakePSD, bool preComputeRiccatiTerms)
-    : useMakePSD_(useMakePSD), preComputeRiccatiTerms_(preComputeRiccatiTerms) {}
+    : useMakePSD_(useMakePSD), preComputeRiccatiTerms_(preComputeRiccatiTerms), timeIndexHint_(0) {}
 
 /******************************************************************************************************/
 /******************************************************************************************************/
@@ -118,6 +118,7 @@ void SequentialRiccatiEquations<STATE_DIM, INPUT_DIM>::setData(
   Bm_.resize(state_dim, input_dim);
   Rv_.resize(input_dim);
   Pm_.resize(input_dim, state_dim);
+  RinvChol_.resize(input_dim, input_dim);
 
   eventTimes_.clear();
   eventTimes_.reserve(postEventIndicesPtr->size());
@@ -139,9 +140,18 @@ void SequentialRiccatiEquations<STATE_DIM, INPUT_DIM>::setData(
   QvFinalPtr_ = QvFinalPtr;
   QmFinalPtr_ = QmFinalPtr;
 
+  // the integration runs backward in time
+  timeIndexHint_ = timeStampPtr->size();
+
+  // RinvChol padded with zero columns, the padded inputs do not contribute to any of the terms
+  const size_t N = AmPtr->size();
+  auto paddedRinvChol = [&](size_t i, input_matrix_t& RinvChol) {
+    RinvChol.setZero(input_dim, input_dim);
+    RinvChol.leftCols((*RinvCholPtr)[i].cols()) = (*RinvCholPtr)[i];
+  };
+
   if (preComputeRiccatiTerms_) {
     // Initialize all arrays that will store the precomputation
-    const size_t N = AmPtr->size();
     B_RinvChol_array_.clear();
     B_RinvChol_array_.reserve(N);
     RinvCholT_Rv_array_.clear();
@@ -155,21 +165,29 @@ void SequentialRiccatiEquations<STATE_DIM, INPUT_DIM>::setData(
     q_minus_half_Rv_Rinv_Rv_array_ = *qPtr;
 
     // Precompute all terms for all interpolation nodes
-    dynamic_matrix_t PmT_RinvChol;
+    input_matrix_t RinvChol;
+    state_input_matrix_t PmT_RinvChol;
     for (size_t i = 0; i < N; i++) {
+      paddedRinvChol(i, RinvChol);
+
       // Emplace back on first touch of the array in this loop
-      B_RinvChol_array_.emplace_back((*BmPtr)[i] * (*RinvCholPtr)[i]);
-      RinvCholT_Rv_array_.emplace_back((*RinvCholPtr)[i].transpose() * (*RvPtr)[i]);
+      B_RinvChol_array_.emplace_back((*BmPtr)[i] * RinvChol);
+      RinvCholT_Rv_array_.emplace_back(RinvChol.transpose() * (*RvPtr)[i]);
       AmT_minus_P_Rinv_B_array_.emplace_back((*AmPtr)[i].transpose());
 
       // Modify AmT_minus_P_Rinv_B_array_ in place + store temporary computation
-      PmT_RinvChol.noalias() = (*PmPtr)[i].transpose() * (*RinvCholPtr)[i];
+      PmT_RinvChol.noalias() = (*PmPtr)[i].transpose() * RinvChol;
       AmT_minus_P_Rinv_B_array_[i].noalias() -= PmT_RinvChol * B_RinvChol_array_[i].transpose();
 
       // Modify the constraints in place
       Qm_minus_P_Rinv_P_array_[i].noalias() -= PmT_RinvChol * PmT_RinvChol.transpose();
       Qv_minus_P_Rinv_Rv_array_[i].noalias() -= PmT_RinvChol * RinvCholT_Rv_array_[i];
     }
+  } else {
+    RinvChol_array_.resize(N);
+    for (size_t i = 0; i < N; i++) {
+      paddedRinvChol(i, RinvChol_array_[i]);
+    }
   }
 }
 
@@ -214,14 +232,21 @@ void SequentialRiccatiEquations<STATE_DIM, INPUT_DIM>::computeFlowMap(const scal
     LinearAlgebra::makePSD(Sm_);
   }
 
-  const auto indexAlpha = EigenLinearInterpolation<state_matrix_t>::timeSegment(t, timeStampPtr_);
+  const auto indexAlpha = EigenLinearInterpolation<state_matrix_t>::timeSegment(t, timeStampPtr_, timeIndexHint_);
+
+  // Terms of RinvChol snap to the closest node if the dimension of the constrained input space changes
+  auto indexAlphaRinvChol = indexAlpha;
+  if (RinvCholPtr_->size() > 1 && (*RinvCholPtr_)[indexAlpha.first].cols() != (*RinvCholPtr_)[indexAlpha.first + 1].cols()) {
+    indexAlphaRinvChol.second = (indexAlpha.second > 0.5) ? 1.0 : 0.0;
+  }
+
   if (preComputeRiccatiTerms_) {
     EigenLinearInterpolation<state_matrix_t>::interpolate(indexAlpha, Qm_, &Qm_minus_P_Rinv_P_array_);
     EigenLinearInterpolation<state_vector_t>::interpolate(indexAlpha, Qv_, &Qv_minus_P_Rinv_Rv_array_);
     EigenLinearInterpolation<eigen_scalar_t>::interpolate(indexAlpha, q_, &q_minus_half_Rv_Rinv_Rv_array_);
     EigenLinearInterpolation<state_matrix_t>::interpolate(indexAlpha, AmT_minus_P_Rinv_Bm_, &AmT_minus_P_Rinv_B_array_);
-    EigenLinearInterpolation<dynamic_vector_t>::interpolate(indexAlpha, RinvCholT_Rv_, &RinvCholT_Rv_array_);
-    EigenLinearInterpolation<dynamic_matrix_t>::interpolate(indexAlpha, B_RinvChol_, &B_RinvChol_array_);
+    EigenLinearInterpolation<input_vector_t>::interpolate(indexAlphaRinvChol, RinvCholT_Rv_, &RinvCholT_Rv_array_);
+    EigenLinearInterpolation<state_input_matrix_t>::interpolate(indexAlphaRinvChol, B_RinvChol_, &B_RinvChol_array_);
 
     // dSmdt,  Qm_ used instead of temporary
     AmT_Sm_.noalias() = AmT_minus_P_Rinv_Bm_ * Sm_;
@@ -242,12 +267,12 @@ void SequentialRiccatiEquations<STATE_DIM, INPUT_DIM>::computeFlowMap(const scal
     EigenLinearInterpolation<eigen_scalar_t>::interpolate(indexAlpha, q_, qPtr_);
     EigenLinearInterpolation<state_matrix_t>::interpolate(indexAlpha, Am_, AmPtr_);
     EigenLinearInterpolation<state_input_matrix_t>::interpolate(indexAlpha, Bm_, BmPtr_);
-    EigenLinearInterpolation<dynamic_matrix_t>::interpolate(indexAlpha, RinvChol_, RinvCholPtr_);
+    EigenLinearInterpolation<input_matrix_t>::interpolate(indexAlphaRinvChol, RinvChol_, &RinvChol_array_);
     EigenLinearInterpolation<input_state_matrix_t>::interpolate(indexAlpha, Pm_, PmPtr_);
     EigenLinearInterpolation<input_vector_t>::interpolate(indexAlpha, Rv_, RvPtr_);
 
     Pm_.noalias() += Bm_.transpose() * Sm_;  // ! Pm is changed to avoid an extra temporary
-    SmT_B_RinvChol_.noalias() = RinvChol_.transpose() * Pm_;
+    RinvCholT_Pm_.noalias() = RinvChol_.transpose() * Pm_;
     Rv_.noalias() += Bm_.transpose() * Sv_;  // ! Rv is changed to avoid an extra temporary
     RinvCholT_Rv_.noalias() = RinvChol_.transpose() * Rv_;
 
@@ -255,11 +280,11 @@ void SequentialRiccatiEquations<STATE_DIM, INPUT_DIM>::computeFlowMap(const scal
 
     // dSmdt,  Qm_ used instead of temporary
     Qm_ += AmT_Sm_ + AmT_Sm_.transpose();
-    Qm_.noalias() -= SmT_B_RinvChol_.transpose() * SmT_B_RinvChol_;
+    Qm_.noalias() -= RinvCholT_Pm_.transpose() * RinvCholT_Pm_;
 
     // dSvdt,  Qv_ used instead of temporary
     Qv_.noalias() += Am_.transpose() * Sv_;
-    Qv_.noalias() -= SmT_B_RinvChol_.transpose() * RinvCholT_Rv_;
+    Qv_.noalias() -= RinvCholT_Pm_.transpose() * RinvCholT_Rv_;
 
     // dsdt,   q_ used instead of temporary
     q_.noalias() -= 0.5 * RinvCholT_Rv_.transpose() * RinvCholT_Rv_;
@@ -31,6 +31,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <cstdlib>
 #include <ctime>
 #include <iostream>
+#include <numeric>
 
 #include <ocs2_oc/rollout/TimeTriggeredRollout.h>
 
@@ -159,6 +160,11 @@ TEST(exp1_slq_test, exp1_slq_test) {
   ASSERT_LT(fabs(performanceIndecesMT.stateEqConstraintISE - expectedISE2), 10 * slqSettings.ddpSettings_.minRelConstraint1ISE_)
       << "MESSAGE: multi-threaded SLQ failed in the EXP1's type-2 constraint ISE test!";
 
+  const auto& numLQNodesPerWorker = slqMT.getNumLQNodesPerWorker();
+  ASSERT_EQ(numLQNodesPerWorker.size(), slqSettings.ddpSettings_.nThreads_);
+  ASSERT_GT(std::accumulate(numLQNodesPerWorker.begin(), numLQNodesPerWorker.end(), size_t(0)), 0)
+      << "MESSAGE: multi-threaded SLQ did not approximate any time node!";
+
   double ctrlFinalTime;
   if (slqSettings.ddpSettings_.useFeedbackPolicy_) {
     ctrlFinalTime = dynamic_cast<slq_t::linear_controller_t*>(solutionST.controllerPtr_.get())->timeStamp_.back();
@@ -169,6 +175,267 @@ TEST(exp1_slq_test, exp1_slq_test) {
   ASSERT_DOUBLE_EQ(ctrlFinalTime, finalTime) << "MESSAGE: SLQ_ST failed in policy final time of controller!";
 }
 
+TEST(exp1_slq_test, discrete_time_riccati_test) {
+  using slq_t = SLQ<STATE_DIM, INPUT_DIM>;
+
+  SLQ_Settings slqSettings;
+  slqSettings.useNominalTimeForBackwardPass_ = true;
+  slqSettings.useDiscreteTimeRiccati_ = true;
+  slqSettings.ddpSettings_.displayInfo_ = false;
+  slqSettings.ddpSettings_.displayShortSummary_ = true;
+  slqSettings.ddpSettings_.maxNumIterations_ = 30;
+  slqSettings.ddpSettings_.checkNumericalStability_ = true;
+  slqSettings.ddpSettings_.absTolODE_ = 1e-10;
+  slqSettings.ddpSettings_.relTolODE_ = 1e-7;
+  slqSettings.ddpSettings_.maxNumStepsPerSecond_ = 10000;
+  slqSettings.ddpSettings_.useFeedbackPolicy_ = true;
+  slqSettings.ddpSettings_.debugPrintRollout_ = false;
+
+  Rollout_Settings rolloutSettings;
+  rolloutSettings.absTolODE_ = 1e-10;
+  rolloutSettings.relTolODE_ = 1e-7;
+  rolloutSettings.maxNumStepsPerSecond_ = 10000;
+
+  // event times
+  std::vector<double> eventTimes{0.2262, 1.0176};
+  std::vector<size_t> subsystemsSequence{0, 1, 2};
+  std::shared_ptr<ModeScheduleManager<STATE_DIM, INPUT_DIM>> modeScheduleManagerPtr(
+      new ModeScheduleManager<STATE_DIM, INPUT_DIM>({eventTimes, subsystemsSequence}));
+
+  double startTime = 0.0;
+  double finalTime = 3.0;
+
+  // partitioning times
+  std::vector<double> partitioningTimes{startTime, eventTimes[0], eventTimes[1], finalTime};
+
+  EXP1_System::state_vector_t initState(2.0, 3.0);
+
+  EXP1_System systemDynamics(modeScheduleManagerPtr);
+  TimeTriggeredRollout<STATE_DIM, INPUT_DIM> timeTriggeredRollout(systemDynamics, rolloutSettings);
+  EXP1_SystemDerivative systemDerivative(modeScheduleManagerPtr);
+  EXP1_SystemConstraint systemConstraint;
+  EXP1_CostFunction systemCostFunction(modeScheduleManagerPtr);
+  Eigen::Matrix<double, STATE_DIM, 1> stateOperatingPoint = Eigen::Matrix<double, STATE_DIM, 1>::Zero();
+  Eigen::Matrix<double, INPUT_DIM, 1> inputOperatingPoint = Eigen::Matrix<double, INPUT_DIM, 1>::Zero();
+  EXP1_SystemOperatingTrajectories operatingTrajectories(stateOperatingPoint, inputOperatingPoint);
+
+  slqSettings.ddpSettings_.nThreads_ = 3;
+  slq_t slq(&timeTriggeredRollout, &systemDerivative, &systemConstraint, &systemCostFunction, &operatingTrajectories, slqSettings);
+  slq.setModeScheduleManager(modeScheduleManagerPtr);
+  slq.run(startTime, initState, finalTime, partitioningTimes);
+
+  // the discretization of the backward pass only changes the search direction, the cost is evaluated by the rollout
+  const double expectedCost = 5.4399;
+  ASSERT_LT(fabs(slq.getPerformanceIndeces().totalCost - expectedCost), 10 * slqSettings.ddpSettings_.minRelCost_)
+      << "MESSAGE: SLQ with discrete-time Riccati recursion failed in the EXP1's cost test!";
+}
+
+TEST(exp1_slq_test, line_search_merit_bound_test) {
+  using slq_t = SLQ<STATE_DIM, INPUT_DIM>;
+
+  SLQ_Settings slqSettings;
+  slqSettings.ddpSettings_.displayInfo_ = false;
+  slqSettings.ddpSettings_.displayShortSummary_ = true;
+  slqSettings.ddpSettings_.maxNumIterations_ = 30;
+  slqSettings.ddpSettings_.absTolODE_ = 1e-10;
+  slqSettings.ddpSettings_.relTolODE_ = 1e-7;
+  slqSettings.ddpSettings_.maxNumStepsPerSecond_ = 10000;
+  slqSettings.ddpSettings_.useFeedbackPolicy_ = true;
+  slqSettings.ddpSettings_.useLineSearchMeritBound_ = true;
+
+  Rollout_Settings rolloutSettings;
+  rolloutSettings.absTolODE_ = 1e-10;
+  rolloutSettings.relTolODE_ = 1e-7;
+  rolloutSettings.maxNumStepsPerSecond_ = 10000;
+
+  // event times
+  std::vector<double> eventTimes{0.2262, 1.0176};
+  std::vector<size_t> subsystemsSequence{0, 1, 2};
+  std::shared_ptr<ModeScheduleManager<STATE_DIM, INPUT_DIM>> modeScheduleManagerPtr(
+      new ModeScheduleManager<STATE_DIM, INPUT_DIM>({eventTimes, subsystemsSequence}));
+
+  double startTime = 0.0;
+  double finalTime = 3.0;
+
+  // partitioning times
+  std::vector<double> partitioningTimes{startTime, eventTimes[0], eventTimes[1], finalTime};
+
+  EXP1_System::state_vector_t initState(2.0, 3.0);
+
+  EXP1_System systemDynamics(modeScheduleManagerPtr);
+  TimeTriggeredRollout<STATE_DIM, INPUT_DIM> timeTriggeredRollout(systemDynamics, rolloutSettings);
+  EXP1_SystemDerivative systemDerivative(modeScheduleManagerPtr);
+  EXP1_SystemConstraint systemConstraint;
+  EXP1_CostFunction systemCostFunction(modeScheduleManagerPtr);
+  Eigen::Matrix<double, STATE_DIM, 1> stateOperatingPoint = Eigen::Matrix<double, STATE_DIM, 1>::Zero();
+  Eigen::Matrix<double, INPUT_DIM, 1> inputOperatingPoint = Eigen::Matrix<double, INPUT_DIM, 1>::Zero();
+  EXP1_SystemOperatingTrajectories operatingTrajectories(stateOperatingPoint, inputOperatingPoint);
+
+  // the costs of EXP1 are non-negative, so stopping the rejected rollouts early does not change the solution
+  const double expectedCost = 5.4399;
+  for (size_t nThreads : {1, 3}) {
+    slqSettings.ddpSettings_.nThreads_ = nThreads;
+    slq_t slq(&timeTriggeredRollout, &systemDerivative, &systemConstraint, &systemCostFunction, &operatingTrajectories, slqSettings);
+    slq.setModeScheduleManager(modeScheduleManagerPtr);
+    slq.run(startTime, initState, finalTime, partitioningTimes);
+
+    ASSERT_LT(fabs(slq.getPerformanceIndeces().totalCost - expectedCost), 10 * slqSettings.ddpSettings_.minRelCost_)
+        << "MESSAGE: SLQ with the line-search merit bound failed in the EXP1's cost test with " << nThreads << " threads!";
+  }
+}
+
+TEST(exp1_slq_test, time_parallel_riccati_test) {
+  using slq_t = SLQ<STATE_DIM, INPUT_DIM>;
+
+  SLQ_Settings slqSettings;
+  slqSettings.useNominalTimeForBackwardPass_ = true;
+  slqSettings.useDiscreteTimeRiccati_ = true;
+  slqSettings.ddpSettings_.displayInfo_ = false;
+  slqSettings.ddpSettings_.displayShortSummary_ = false;
+  slqSettings.ddpSettings_.maxNumIterations_ = 30;
+  slqSettings.ddpSettings_.checkNumericalStability_ = true;
+  slqSettings.ddpSettings_.absTolODE_ = 1e-10;
+  slqSettings.ddpSettings_.relTolODE_ = 1e-7;
+  slqSettings.ddpSettings_.maxNumStepsPerSecond_ = 10000;
+  slqSettings.ddpSettings_.useFeedbackPolicy_ = true;
+  slqSettings.ddpSettings_.nThreads_ = 4;
+
+  Rollout_Settings rolloutSettings;
+  rolloutSettings.absTolODE_ = 1e-10;
+  rolloutSettings.relTolODE_ = 1e-7;
+  rolloutSettings.maxNumStepsPerSecond_ = 10000;
+
+  // event times
+  std::vector<double> eventTimes{0.2262, 1.0176};
+  std::vector<size_t> subsystemsSequence{0, 1, 2};
+  std::shared_ptr<ModeScheduleManager<STATE_DIM, INPUT_DIM>> modeScheduleManagerPtr(
+      new ModeScheduleManager<STATE_DIM, INPUT_DIM>({eventTimes, subsystemsSequence}));
+
+  double startTime = 0.0;
+  double finalTime = 3.0;
+
+  EXP1_System::state_vector_t initState(2.0, 3.0);
+
+  EXP1_System systemDynamics(modeScheduleManagerPtr);
+  TimeTriggeredRollout<STATE_DIM, INPUT_DIM> timeTriggeredRollout(systemDynamics, rolloutSettings);
+  EXP1_SystemDerivative systemDerivative(modeScheduleManagerPtr);
+  EXP1_SystemConstraint systemConstraint;
+  EXP1_CostFunction systemCostFunction(modeScheduleManagerPtr);
+  Eigen::Matrix<double, STATE_DIM, 1> stateOperatingPoint = Eigen::Matrix<double, STATE_DIM, 1>::Zero();
+  Eigen::Matrix<double, INPUT_DIM, 1> inputOperatingPoint = Eigen::Matrix<double, INPUT_DIM, 1>::Zero();
+  EXP1_SystemOperatingTrajectories operatingTrajectories(stateOperatingPoint, inputOperatingPoint);
+
+  // a single partition with the events inside and partitions which do not match the events
+  const std::vector<std::vector<double>> partitioningTimesSet{{startTime, finalTime}, {startTime, 0.5, 1.5, 2.0, finalTime}};
+  for (const auto& partitioningTimes : partitioningTimesSet) {
+    slqSettings.useTimeParallelRiccati_ = false;
+    slq_t slqSequential(&timeTriggeredRollout, &systemDerivative, &systemConstraint, &systemCostFunction, &operatingTrajectories,
+                        slqSettings);
+    slqSequential.setModeScheduleManager(modeScheduleManagerPtr);
+    slqSequential.run(startTime, initState, finalTime, partitioningTimes);
+
+    slqSettings.useTimeParallelRiccati_ = true;
+    slq_t slqTimeParallel(&timeTriggeredRollout, &systemDerivative, &systemConstraint, &systemCostFunction, &operatingTrajectories,
+                          slqSettings);
+    slqTimeParallel.setModeScheduleManager(modeScheduleManagerPtr);
+    slqTimeParallel.run(startTime, initState, finalTime, partitioningTimes);
+
+    // the value functions only differ by round-off errors, which may still change when the iterations stop
+    ASSERT_NEAR(slqTimeParallel.getPerformanceIndeces().totalCost, slqSequential.getPerformanceIndeces().totalCost,
+                10 * slqSettings.ddpSettings_.minRelCost_)
+        << "MESSAGE: SLQ with time-parallel Riccati recursion failed in the EXP1's cost test!";
+  }
+}
+
+TEST(exp1_slq_test, rewind_test) {
+  using slq_t = SLQ<STATE_DIM, INPUT_DIM>;
+
+  SLQ_Settings slqSettings;
+  slqSettings.ddpSettings_.displayInfo_ = false;
+  slqSettings.ddpSettings_.displayShortSummary_ = false;
+  slqSettings.ddpSettings_.maxNumIterations_ = 30;
+  slqSettings.ddpSettings_.absTolODE_ = 1e-10;
+  slqSettings.ddpSettings_.relTolODE_ = 1e-7;
+  slqSettings.ddpSettings_.maxNumStepsPerSecond_ = 10000;
+  slqSettings.ddpSettings_.useFeedbackPolicy_ = true;
+  slqSettings.ddpSettings_.nThreads_ = 1;
+
+  Rollout_Settings rolloutSettings;
+  rolloutSettings.absTolODE_ = 1e-10;
+  rolloutSettings.relTolODE_ = 1e-7;
+  rolloutSettings.maxNumStepsPerSecond_ = 10000;
+
+  // event times
+  std::vector<double> eventTimes{0.2262, 1.0176};
+  std::vector<size_t> subsystemsSequence{0, 1, 2};
+  std::shared_ptr<ModeScheduleManager<STATE_DIM, INPUT_DIM>> modeScheduleManagerPtr(
+      new ModeScheduleManager<STATE_DIM, INPUT_DIM>({eventTimes, subsystemsSequence}));
+
+  double startTime = 0.0;
+  double finalTime = 3.0;
+
+  // partitioning times
+  std::vector<double> partitioningTimes{startTime, eventTimes[0], eventTimes[1], finalTime};
+  const size_t numPartitions = partitioningTimes.size() - 1;
+
+  EXP1_System::state_vector_t initState(2.0, 3.0);
+
+  EXP1_System systemDynamics(modeScheduleManagerPtr);
+  TimeTriggeredRollout<STATE_DIM, INPUT_DIM> timeTriggeredRollout(systemDynamics, rolloutSettings);
+  EXP1_SystemDerivative systemDerivative(modeScheduleManagerPtr);
+  EXP1_SystemConstraint systemConstraint;
+  EXP1_CostFunction systemCostFunction(modeScheduleManagerPtr);
+  Eigen::Matrix<double, STATE_DIM, 1> stateOperatingPoint = Eigen::Matrix<double, STATE_DIM, 1>::Zero();
+  Eigen::Matrix<double, INPUT_DIM, 1> inputOperatingPoint = Eigen::Matrix<double, INPUT_DIM, 1>::Zero();
+  EXP1_SystemOperatingTrajectories operatingTrajectories(stateOperatingPoint, inputOperatingPoint);
+
+  for (size_t firstIndex = 1; firstIndex <= numPartitions; firstIndex++) {
+    slq_t slq(&timeTriggeredRollout, &systemDerivative, &systemConstraint, &systemCostFunction, &operatingTrajectories, slqSettings);
+    slq.setModeScheduleManager(modeScheduleManagerPtr);
+    slq.run(startTime, initState, finalTime, partitioningTimes);
+
+    const slq_t::scalar_array2_t* timeTrajectoriesStockPtr;
+    const slq_t::state_vector_array2_t* stateTrajectoriesStockPtr;
+    const slq_t::input_vector_array2_t* inputTrajectoriesStockPtr;
+    slq.getNominalTrajectoriesPtr(timeTrajectoriesStockPtr, stateTrajectoriesStockPtr, inputTrajectoriesStockPtr);
+    const slq_t::scalar_array2_t timeTrajectoriesStock = *timeTrajectoriesStockPtr;
+    const slq_t::state_vector_array2_t stateTrajectoriesStock = *stateTrajectoriesStockPtr;
+    const slq_t::input_vector_array2_t inputTrajectoriesStock = *inputTrajectoriesStockPtr;
+    ASSERT_EQ(timeTrajectoriesStock.size(), numPartitions);
+    for (size_t i = 0; i < numPartitions; i++) {
+      ASSERT_FALSE(timeTrajectoriesStock[i].empty()) << "MESSAGE: SLQ did not fill partition " << i << "!";
+    }
+
+    const auto rewindCounter = slq.getRewindCounter();
+    slq.rewindOptimizer(firstIndex);
+    ASSERT_EQ(slq.getRewindCounter(), rewindCounter + firstIndex);
+
+    // the partitions move to the front along with their nominal trajectories, the trailing ones are cleared
+    slq.getNominalTrajectoriesPtr(timeTrajectoriesStockPtr, stateTrajectoriesStockPtr, inputTrajectoriesStockPtr);
+    ASSERT_EQ(timeTrajectoriesStockPtr->size(), numPartitions);
+    for (size_t i = 0; i < numPartitions; i++) {
+      if (i + firstIndex < numPartitions) {
+        ASSERT_EQ((*timeTrajectoriesStockPtr)[i], timeTrajectoriesStock[i + firstIndex])
+            << "MESSAGE: partition " << i << " after rewinding by " << firstIndex << " has the wrong time trajectory!";
+        ASSERT_TRUE((*stateTrajectoriesStockPtr)[i] == stateTrajectoriesStock[i + firstIndex])
+            << "MESSAGE: partition " << i << " after rewinding by " << firstIndex << " has the wrong state trajectory!";
+        ASSERT_TRUE((*inputTrajectoriesStockPtr)[i] == inputTrajectoriesStock[i + firstIndex])
+            << "MESSAGE: partition " << i << " after rewinding by " << firstIndex << " has the wrong input trajectory!";
+      } else {
+        ASSERT_TRUE((*timeTrajectoriesStockPtr)[i].empty())
+            << "MESSAGE: partition " << i << " after rewinding by " << firstIndex << " was not cleared!";
+        ASSERT_TRUE((*stateTrajectoriesStockPtr)[i].empty());
+        ASSERT_TRUE((*inputTrajectoriesStockPtr)[i].empty());
+      }
+    }
+  }
+
+  slq_t slq(&timeTriggeredRollout, &systemDerivative, &systemConstraint, &systemCostFunction, &operatingTrajectories, slqSettings);
+  slq.setModeScheduleManager(modeScheduleManagerPtr);
+  slq.run(startTime, initState, finalTime, partitioningTimes);
+  ASSERT_THROW(slq.rewindOptimizer(numPartitions + 1), std::runtime_error);
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
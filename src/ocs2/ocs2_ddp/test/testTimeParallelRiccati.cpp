@@ -0,0 +1,219 @@
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+#include <ocs2_core/misc/Benchmark.h>
+#include <ocs2_core/misc/randomMatrices.h>
+#include <ocs2_ddp/riccati_equations/TimeParallelBackwardRecursion.h>
+
+/**
+ * Discrete-time LQ problem with normalized inputs, x[k+1] = (I + dt * Am) x[k] + dt * Bm u[k] with the stage cost
+ * dt * (q + Qv' x + 0.5 x' Qm x + Rv' u + 0.5 u' u + u' Pm x) and the terminal value function 0.5 x' Sm x + Sv' x + s.
+ */
+template <size_t STATE_DIM, size_t INPUT_DIM>
+class DiscreteLqProblem {
+ public:
+  using element_t = ocs2::ConditionalValueFunction<STATE_DIM>;
+  using state_matrix_t = Eigen::Matrix<double, STATE_DIM, STATE_DIM>;
+  using state_vector_t = Eigen::Matrix<double, STATE_DIM, 1>;
+  using input_matrix_t = Eigen::Matrix<double, INPUT_DIM, INPUT_DIM>;
+  using input_vector_t = Eigen::Matrix<double, INPUT_DIM, 1>;
+  using state_input_matrix_t = Eigen::Matrix<double, STATE_DIM, INPUT_DIM>;
+  using input_state_matrix_t = Eigen::Matrix<double, INPUT_DIM, STATE_DIM>;
+  template <class T>
+  using array_t = std::vector<T, Eigen::aligned_allocator<T>>;
+
+  DiscreteLqProblem(size_t numNodes, double dt)
+      : dt_(dt), Am_(numNodes), Bm_(numNodes), Qm_(numNodes), Qv_(numNodes), q_(numNodes), Pm_(numNodes), Rv_(numNodes) {
+    for (size_t k = 0; k < numNodes; k++) {
+      Am_[k] = 0.5 * state_matrix_t::Random();
+      Bm_[k] = state_input_matrix_t::Random();
+      Qm_[k] = ocs2::LinearAlgebra::generateSPDmatrix<state_matrix_t>(STATE_DIM);
+      Qv_[k] = state_vector_t::Random();
+      q_[k] = std::abs(Eigen::Matrix<double, 1, 1>::Random()(0));
+      Pm_[k] = 0.1 * input_state_matrix_t::Random();
+      Rv_[k] = input_vector_t::Random();
+    }
+    Sm_.resize(numNodes);
+    Sv_.resize(numNodes);
+    s_.resize(numNodes);
+    Sm_.back() = ocs2::LinearAlgebra::generateSPDmatrix<state_matrix_t>(STATE_DIM);
+    Sv_.back() = state_vector_t::Random();
+    s_.back() = 1.0;
+  }
+
+  size_t numNodes() const { return Sm_.size(); }
+
+  void getStepElement(size_t k, element_t& element) const {
+    element.A = dt_ * Am_[k];
+    element.A.diagonal().array() += 1.0;
+    element.A.noalias() -= dt_ * Bm_[k] * Pm_[k];
+    element.b.noalias() = -dt_ * Bm_[k] * Rv_[k];
+    element.C.noalias() = dt_ * Bm_[k] * Bm_[k].transpose();
+    element.J = dt_ * Qm_[k];
+    element.J.noalias() -= dt_ * Pm_[k].transpose() * Pm_[k];
+    element.eta = dt_ * Qv_[k];
+    element.eta.noalias() -= dt_ * Pm_[k].transpose() * Rv_[k];
+    element.c = dt_ * (q_[k] - 0.5 * Rv_[k].squaredNorm());
+  }
+
+  void getValue(size_t k, element_t& value) const { value.setValueFunction(Sm_[k], Sv_[k], s_[k]); }
+
+  void setValue(size_t k, const element_t& value) {
+    Sm_[k] = value.J;
+    Sv_[k] = value.eta;
+    s_[k] = value.c;
+  }
+
+  /** The sequential Riccati recursion. */
+  void step(size_t k) {
+    state_matrix_t Ad = dt_ * Am_[k];
+    Ad.diagonal().array() += 1.0;
+    const state_input_matrix_t Sm_Bm = Sm_[k + 1] * Bm_[k];
+
+    input_matrix_t Hm = input_matrix_t::Identity();
+    Hm.noalias() += dt_ * Bm_[k].transpose() * Sm_Bm;
+    input_state_matrix_t Gm = Pm_[k];
+    Gm.noalias() += Sm_Bm.transpose() * Ad;
+    input_vector_t gv = Rv_[k];
+    gv.noalias() += Bm_[k].transpose() * Sv_[k + 1];
+
+    const Eigen::LLT<input_matrix_t> HmLlt(Hm);
+    const input_state_matrix_t Hinv_Gm = HmLlt.solve(Gm);
+    const input_vector_t Hinv_gv = HmLlt.solve(gv);
+
+    state_matrix_t Sm = dt_ * Qm_[k];
+    Sm.noalias() += Ad.transpose() * (Sm_[k + 1] * Ad);
+    Sm.noalias() -= dt_ * Gm.transpose() * Hinv_Gm;
+    Sm_[k] = 0.5 * (Sm + Sm.transpose());
+    Sv_[k] = dt_ * Qv_[k];
+    Sv_[k].noalias() += Ad.transpose() * Sv_[k + 1];
+    Sv_[k].noalias() -= dt_ * Gm.transpose() * Hinv_gv;
+    s_[k] = s_[k + 1] + dt_ * q_[k] - 0.5 * dt_ * gv.dot(Hinv_gv);
+  }
+
+  void solveSequential() {
+    for (size_t k = numNodes() - 1; k-- > 0;) {
+      step(k);
+    }
+  }
+
+  void solveTimeParallel(ocs2::ThreadPool& threadPool, size_t numBlocks) {
+    recursion_.solve(
+        threadPool, numBlocks, numNodes(), [this](size_t k, element_t& element) { getStepElement(k, element); },
+        [this](size_t k, element_t& value) { getValue(k, value); }, [this](size_t k, const element_t& value) { setValue(k, value); },
+        [this](size_t k) { step(k); });
+  }
+
+  double dt_;
+  array_t<state_matrix_t> Am_;
+  array_t<state_input_matrix_t> Bm_;
+  array_t<state_matrix_t> Qm_;
+  array_t<state_vector_t> Qv_;
+  std::vector<double> q_;
+  array_t<input_state_matrix_t> Pm_;
+  array_t<input_vector_t> Rv_;
+
+  array_t<state_matrix_t> Sm_;
+  array_t<state_vector_t> Sv_;
+  std::vector<double> s_;
+
+  ocs2::TimeParallelBackwardRecursion<element_t> recursion_;
+};
+
+TEST(testTimeParallelRiccati, compareWithSequentialRecursion) {
+  constexpr size_t STATE_DIM = 12;
+  constexpr size_t INPUT_DIM = 6;
+  srand(0);
+
+  DiscreteLqProblem<STATE_DIM, INPUT_DIM> sequential(1001, 0.01);
+  sequential.solveSequential();
+
+  for (size_t numThreads : {1, 2, 3, 4, 8}) {
+    DiscreteLqProblem<STATE_DIM, INPUT_DIM> timeParallel = sequential;
+    ocs2::ThreadPool threadPool(numThreads - 1);
+    timeParallel.solveTimeParallel(threadPool, numThreads);
+
+    for (size_t k = 0; k < sequential.numNodes(); k++) {
+      ASSERT_TRUE(timeParallel.Sm_[k].isApprox(sequential.Sm_[k], 1e-9)) << "threads: " << numThreads << ", node: " << k;
+      ASSERT_TRUE(timeParallel.Sv_[k].isApprox(sequential.Sv_[k], 1e-9)) << "threads: " << numThreads << ", node: " << k;
+      ASSERT_NEAR(timeParallel.s_[k], sequential.s_[k], 1e-9 * std::abs(sequential.s_[k])) << "threads: " << numThreads << ", node: " << k;
+    }
+  }
+}
+
+TEST(testTimeParallelRiccati, affineBackwardRecursion) {
+  constexpr size_t STATE_DIM = 8;
+  using element_t = ocs2::AffineBackwardMap<STATE_DIM>;
+  using state_vector_t = element_t::state_vector_t;
+  srand(0);
+
+  const size_t numNodes = 500;
+  std::vector<element_t, Eigen::aligned_allocator<element_t>> steps(numNodes);
+  for (auto& element : steps) {
+    element.T = element_t::state_matrix_t::Identity() + 0.01 * element_t::state_matrix_t::Random();
+    element.t.setRandom();
+  }
+
+  std::vector<state_vector_t, Eigen::aligned_allocator<state_vector_t>> sequential(numNodes);
+  sequential.back().setRandom();
+  for (size_t k = numNodes - 1; k-- > 0;) {
+    sequential[k] = steps[k].T * sequential[k + 1] + steps[k].t;
+  }
+
+  auto timeParallel = sequential;
+  std::for_each(timeParallel.begin(), timeParallel.end() - 1, [](state_vector_t& v) { v.setZero(); });
+  ocs2::ThreadPool threadPool(3);
+  ocs2::TimeParallelBackwardRecursion<element_t> recursion;
+  recursion.solve(
+      threadPool, 4, numNodes, [&](size_t k, element_t& element) { element = steps[k]; },
+      [&](size_t k, element_t& value) { value.setValue(timeParallel[k]); },
+      [&](size_t k, const element_t& value) { timeParallel[k] = value.t; },
+      [&](size_t k) { timeParallel[k] = steps[k].T * timeParallel[k + 1] + steps[k].t; });
+
+  for (size_t k = 0; k < numNodes; k++) {
+    ASSERT_TRUE(timeParallel[k].isApprox(sequential[k], 1e-9)) << "node: " << k;
+  }
+}
+
+/**
+ * Compares the backward pass time of the sequential recursion with the time-parallel one, for a horizon of 4 [s] with a time step
+ * of 1 [ms] and the state and input dimensions of the mobile manipulator.
+ */
+TEST(testTimeParallelRiccati, benchmark) {
+  constexpr size_t STATE_DIM = 19;
+  constexpr size_t INPUT_DIM = 10;
+  constexpr size_t numRepetitions = 5;
+  srand(0);
+
+  DiscreteLqProblem<STATE_DIM, INPUT_DIM> problem(4001, 0.001);
+
+  ocs2::benchmark::RepeatedTimer sequentialTimer;
+  for (size_t i = 0; i < numRepetitions; i++) {
+    sequentialTimer.startTimer();
+    problem.solveSequential();
+    sequentialTimer.endTimer();
+  }
+  std::cerr << "sequential:\t\t" << sequentialTimer.getAverageInMilliseconds() << " [ms]" << std::endl;
+
+  const size_t maxNumThreads = std::min<size_t>(std::max<unsigned>(std::thread::hardware_concurrency(), 1), 16);
+  for (size_t numThreads = 1; numThreads <= maxNumThreads; numThreads *= 2) {
+    ocs2::ThreadPool threadPool(numThreads - 1);
+    ocs2::benchmark::RepeatedTimer timeParallelTimer;
+    for (size_t i = 0; i < numRepetitions; i++) {
+      timeParallelTimer.startTimer();
+      problem.solveTimeParallel(threadPool, numThreads);
+      timeParallelTimer.endTimer();
+    }
+    std::cerr << "time-parallel, " << numThreads << " threads:\t" << timeParallelTimer.getAverageInMilliseconds() << " [ms], speedup "
+              << sequentialTimer.getAverageInMilliseconds() / timeParallelTimer.getAverageInMilliseconds() << std::endl;
+  }
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -113,6 +113,13 @@ class MPC_BASE {
    */
   virtual bool run(const scalar_t& currentTime, const state_vector_t& currentState);
 
+  /**
+   * Prepares the next call of run() in the real-time iteration mode (see MPC_Settings::realTimeIteration_). It should be called
+   * after the solution of run() is retrieved, such that the preparation does not delay the solution. It does nothing if the
+   * real-time iteration mode is not active or not supported by the solver.
+   */
+  virtual void prepareRealTimeIteration() {}
+
   /**
    * Solves the optimal control problem for the given state and time period ([initTime,finalTime]).
    *
@@ -128,6 +128,8 @@ class MPC_SLQ : public MPC_BASE<STATE_DIM, INPUT_DIM> {
 
   void calculateController(const scalar_t& initTime, const state_vector_t& initState, const scalar_t& finalTime) override;
 
+  void prepareRealTimeIteration() override;
+
  protected:
   /***********
    * Variables
@@ -59,6 +59,7 @@ class MPC_Settings {
         recedingHorizon_(true),
         blockwiseMovingHorizon_(false),
         useParallelRiccatiSolver_(false),
+        realTimeIteration_(false),
         solutionTimeWindow_(-1),    // [s]
         mpcDesiredFrequency_(-1),   // [Hz]
         mrtDesiredFrequency_(100),  // [Hz]
@@ -102,6 +103,10 @@ class MPC_Settings {
   /** If set true, the parallel Riccati solver will be used from the first iteration of SLQ
    * solver. */
   bool useParallelRiccatiSolver_;
+  /** If set true, each MPC call after the initial one performs a single real-time iteration. The LQ approximation and the
+   * controller update are prepared after the previous call (see MPC_BASE::prepareRealTimeIteration()), such that the MPC
+   * call only rolls out the update from the new observation. */
+  bool realTimeIteration_;
   /** The time window for retrieving the optimized output (controller and trajectory). */
   double solutionTimeWindow_;
   /**
@@ -142,6 +147,7 @@ inline void MPC_Settings::loadSettings(const std::string& filename, bool verbose
   loadData::loadPtreeValue(pt, recedingHorizon_, fieldName + ".recedingHorizon", verbose);
   loadData::loadPtreeValue(pt, blockwiseMovingHorizon_, fieldName + ".blockwiseMovingHorizon", verbose);
   loadData::loadPtreeValue(pt, useParallelRiccatiSolver_, fieldName + ".useParallelRiccatiSolver", verbose);
+  loadData::loadPtreeValue(pt, realTimeIteration_, fieldName + ".realTimeIteration", verbose);
   loadData::loadPtreeValue(pt, solutionTimeWindow_, fieldName + ".solutionTimeWindow", verbose);
   loadData::loadPtreeValue(pt, mpcDesiredFrequency_, fieldName + ".mpcDesiredFrequency", verbose);
   loadData::loadPtreeValue(pt, mrtDesiredFrequency_, fieldName + ".mrtDesiredFrequency", verbose);
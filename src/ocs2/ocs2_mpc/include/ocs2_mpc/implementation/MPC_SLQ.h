@@ -115,4 +115,15 @@ void MPC_SLQ<STATE_DIM, INPUT_DIM>::calculateController(const scalar_t& initTime
   }
 }
 
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+template <size_t STATE_DIM, size_t INPUT_DIM>
+void MPC_SLQ<STATE_DIM, INPUT_DIM>::prepareRealTimeIteration() {
+  // the preparation needs the solution of a previous call, and a cold start discards it
+  if (BASE::mpcSettings_.realTimeIteration_ && !BASE::mpcSettings_.coldStart_ && !BASE::initRun_) {
+    slqPtr_->prepareRealTimeIteration();
+  }
+}
+
 }  // namespace ocs2
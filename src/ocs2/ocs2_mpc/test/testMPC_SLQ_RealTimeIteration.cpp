@@ -0,0 +1,198 @@
+/******************************************************************************
+Copyright (c) 2017, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+
+#include <ocs2_core/constraint/ConstraintBase.h>
+#include <ocs2_core/cost/QuadraticCostFunction.h>
+#include <ocs2_core/dynamics/LinearSystemDynamics.h>
+#include <ocs2_core/initialization/SystemOperatingPoint.h>
+#include <ocs2_core/misc/LinearInterpolation.h>
+#include <ocs2_oc/rollout/TimeTriggeredRollout.h>
+
+#include <ocs2_mpc/MPC_SLQ.h>
+
+using namespace ocs2;
+
+constexpr size_t STATE_DIM = 4;
+constexpr size_t INPUT_DIM = 2;
+
+namespace {
+std::atomic<size_t> numLQApproximations{0};
+}  // namespace
+
+/** Quadratic cost which counts the evaluations of its Hessian, i.e. the LQ approximations of the problem. */
+class CountingCostFunction final : public QuadraticCostFunction<STATE_DIM, INPUT_DIM> {
+ public:
+  using BASE = QuadraticCostFunction<STATE_DIM, INPUT_DIM>;
+  using BASE::BASE;
+
+  CountingCostFunction* clone() const override { return new CountingCostFunction(*this); }
+
+  void getIntermediateCostSecondDerivativeState(state_matrix_t& dLdxx) override {
+    numLQApproximations++;
+    BASE::getIntermediateCostSecondDerivativeState(dLdxx);
+  }
+};
+
+class MPC_SLQ_RealTimeIterationTest : public testing::Test {
+ protected:
+  using mpc_t = MPC_SLQ<STATE_DIM, INPUT_DIM>;
+  using dynamics_t = LinearSystemDynamics<STATE_DIM, INPUT_DIM>;
+  using state_vector_t = mpc_t::state_vector_t;
+  using scalar_t = mpc_t::scalar_t;
+
+  MPC_SLQ_RealTimeIterationTest()
+      : dynamics_(getA(), getB()),
+        cost_(CountingCostFunction::state_matrix_t::Identity(), 0.1 * CountingCostFunction::input_matrix_t::Identity(),
+              state_vector_t::Zero(), CountingCostFunction::input_vector_t::Zero(), CountingCostFunction::state_matrix_t::Identity(),
+              state_vector_t::Zero()),
+        rollout_(dynamics_, getRolloutSettings()) {}
+
+  static dynamics_t::state_matrix_t getA() {
+    dynamics_t::state_matrix_t A = dynamics_t::state_matrix_t::Zero();
+    A.topRightCorner<2, 2>().setIdentity();
+    return A;
+  }
+
+  static dynamics_t::state_input_matrix_t getB() {
+    dynamics_t::state_input_matrix_t B = dynamics_t::state_input_matrix_t::Zero();
+    B.bottomRows<2>().setIdentity();
+    return B;
+  }
+
+  static Rollout_Settings getRolloutSettings() {
+    Rollout_Settings rolloutSettings;
+    rolloutSettings.absTolODE_ = 1e-7;
+    rolloutSettings.relTolODE_ = 1e-5;
+    rolloutSettings.maxNumStepsPerSecond_ = 10000;
+    return rolloutSettings;
+  }
+
+  std::unique_ptr<mpc_t> getMpc(bool realTimeIteration) {
+    SLQ_Settings slqSettings;
+    slqSettings.ddpSettings_.nThreads_ = 2;
+    slqSettings.ddpSettings_.absTolODE_ = 1e-7;
+    slqSettings.ddpSettings_.relTolODE_ = 1e-5;
+    slqSettings.ddpSettings_.maxNumStepsPerSecond_ = 10000;
+
+    MPC_Settings mpcSettings;
+    mpcSettings.runtimeMaxNumIterations_ = 4;
+    mpcSettings.initMaxNumIterations_ = 10;
+    mpcSettings.runtimeMinLearningRate_ = 1e-4;
+    mpcSettings.initMinLearningRate_ = 1e-4;
+    mpcSettings.realTimeIteration_ = realTimeIteration;
+
+    const scalar_array_t partitioningTimes{0.0, 0.5, 1.0, 1.5, 2.0};
+    std::unique_ptr<mpc_t> mpcPtr(
+        new mpc_t(&rollout_, &dynamics_, &constraint_, &cost_, &operatingPoint_, partitioningTimes, slqSettings, mpcSettings));
+    mpcPtr->getSolverPtr()->setCostDesiredTrajectories(
+        CostDesiredTrajectories({0.0}, {dynamic_vector_t::Zero(STATE_DIM)}, {dynamic_vector_t::Zero(INPUT_DIM)}));
+    return mpcPtr;
+  }
+
+  /**
+   * Runs the MPC in closed loop with a perfect model of the system, the next state is taken from the optimized trajectory.
+   *
+   * @param [in] mpc: The MPC to run.
+   * @param [out] maxLQApproximationsInRun: The maximum number of LQ approximations within run() after the initial call.
+   * @return The final state.
+   */
+  state_vector_t runClosedLoop(mpc_t& mpc, size_t& maxLQApproximationsInRun) {
+    constexpr scalar_t timeStep = 0.05;
+    constexpr size_t numSteps = 100;
+
+    state_vector_t x;
+    x << 1.0, -1.0, 0.5, 0.0;
+    maxLQApproximationsInRun = 0;
+    double runTime = 0.0;
+    for (size_t k = 0; k < numSteps; k++) {
+      const scalar_t t = k * timeStep;
+
+      numLQApproximations = 0;
+      const auto startTime = std::chrono::steady_clock::now();
+      EXPECT_TRUE(mpc.run(t, x));
+      const auto endTime = std::chrono::steady_clock::now();
+      if (k > 0) {
+        maxLQApproximationsInRun = std::max(maxLQApproximationsInRun, numLQApproximations.load());
+        runTime += std::chrono::duration<double, std::milli>(endTime - startTime).count();
+      }
+
+      const auto primalSolution = mpc.getSolverPtr()->primalSolution(mpc.getSolverPtr()->getFinalTime());
+      mpc.prepareRealTimeIteration();
+
+      EigenLinearInterpolation<state_vector_t>::interpolate(t + timeStep, x, &primalSolution.timeTrajectory_,
+                                                            &primalSolution.stateTrajectory_);
+    }
+
+    std::cerr << "average MPC run time: " << runTime / (numSteps - 1) << " [ms]" << std::endl;
+    return x;
+  }
+
+  dynamics_t dynamics_;
+  CountingCostFunction cost_;
+  ConstraintBase<STATE_DIM, INPUT_DIM> constraint_;
+  SystemOperatingPoint<STATE_DIM, INPUT_DIM> operatingPoint_;
+  TimeTriggeredRollout<STATE_DIM, INPUT_DIM> rollout_;
+};
+
+TEST_F(MPC_SLQ_RealTimeIterationTest, feedbackOnlyRollsOut) {
+  auto mpcPtr = getMpc(true);
+  size_t maxLQApproximationsInRun;
+  runClosedLoop(*mpcPtr, maxLQApproximationsInRun);
+  ASSERT_EQ(maxLQApproximationsInRun, 0);
+
+  // the preparation approximates the LQ problem
+  numLQApproximations = 0;
+  mpcPtr->prepareRealTimeIteration();
+  ASSERT_GT(numLQApproximations.load(), 0);
+}
+
+TEST_F(MPC_SLQ_RealTimeIterationTest, closedLoopAgainstFullIterations) {
+  auto mpcPtr = getMpc(false);
+  size_t maxLQApproximationsInRun;
+  const state_vector_t xFinal = runClosedLoop(*mpcPtr, maxLQApproximationsInRun);
+  ASSERT_GT(maxLQApproximationsInRun, 0);
+
+  auto rtiMpcPtr = getMpc(true);
+  const state_vector_t xFinalRti = runClosedLoop(*rtiMpcPtr, maxLQApproximationsInRun);
+
+  // both converge to the origin
+  ASSERT_LT(xFinal.norm(), 0.05);
+  ASSERT_LT(xFinalRti.norm(), 0.05);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
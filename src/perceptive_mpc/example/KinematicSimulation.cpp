@@ -205,6 +205,9 @@ bool KinematicSimulation::trackerLoop(ros::Rate rate) {
         mpcInterface_->updatePolicy();
         mpcInterface_->evaluatePolicy(observation.time(), observation.state(), optimalState, controlInput, subsystem);
         // TODO: for integration on hardware, send the computed control inputs to the motor controllers
+        if (mpcInterface_->policyHorizonExceeded()) {
+          ROS_WARN_STREAM_THROTTLE(1.0, "The requested time is beyond the horizon of the received MPC policy.");
+        }
       } catch (const std::runtime_error& ex) {
         ROS_ERROR_STREAM("runtime_error occured!");
         ROS_ERROR_STREAM("Caught exception while calling [mpcInterface_->evaluatePolicy]. Message: " << ex.what());
@@ -257,6 +260,9 @@ bool KinematicSimulation::mpcUpdate(ros::Rate rate) {
       {
         boost::shared_lock<boost::shared_mutex> lockGuard(observationMutex_);
         setCurrentObservation(observation_);
+        if (esdfCachingServer_) {
+          esdfCachingServer_->setRobotPosition(observation_.state().head<Definitions::BASE_STATE_DIM_>().tail<3>());
+        }
       }
       if (esdfCachingServer_) {
         esdfCachingServer_->updateInterpolator();
@@ -542,7 +548,7 @@ std::shared_ptr<VoxbloxCostConfig> KinematicSimulation::configureCollisionAvoida
       voxbloxCostConfig->pointsOnRobot = pointsOnRobot_;
 
       esdfCachingServer_.reset(new voxblox::EsdfCachingServer(ros::NodeHandle(), ros::NodeHandle("~")));
-      voxbloxCostConfig->interpolator = esdfCachingServer_->getInterpolator();
+      voxbloxCostConfig->esdfSnapshots = esdfCachingServer_->getEsdfSnapshots();
 
       pointsOnRobot_->initialize("points_on_robot");
     } else {
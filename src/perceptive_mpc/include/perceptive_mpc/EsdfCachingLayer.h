@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2020 Johannes Pankert <pankertj@ethz.ch>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of this work nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <memory>
+
+// voxblox
+#include <voxblox/core/common.h>
+#include <voxblox/core/layer.h>
+#include <voxblox/core/voxel.h>
+
+namespace perceptive_mpc {
+
+using esdf_caching_layer_ptr = std::shared_ptr<voxblox::Layer<voxblox::EsdfCachingVoxel>>;
+
+// replaces the block of the caching layer by a fresh copy of the esdf block
+void copyEsdfBlock(const voxblox::Layer<voxblox::EsdfVoxel>& esdfLayer, const voxblox::BlockIndex& blockIdx,
+                   voxblox::Layer<voxblox::EsdfCachingVoxel>* layer);
+
+// all allocated esdf blocks within radius blocks of the given ones
+voxblox::IndexSet dilateEsdfBlocks(const voxblox::Layer<voxblox::EsdfVoxel>& esdfLayer,
+                                   const voxblox::BlockIndexList& blocks, voxblox::IndexElement radius);
+
+/**
+ * Converts the esdf layer into a caching layer and caches its gradients, plus the hessians and the trilinear cells if
+ * requested. With a previous layer the result shares all of its blocks except the updated ones and their neighbors,
+ * whose border derivatives change as well. These are copied from the esdf layer again and returned in changedBlocks.
+ * The previous layer is not modified, so it may still be read by published snapshots. Without a previous layer
+ * everything is converted and changedBlocks stays empty.
+ */
+esdf_caching_layer_ptr buildEsdfCachingLayer(
+    const voxblox::Layer<voxblox::EsdfVoxel>& esdfLayer,
+    const std::shared_ptr<const voxblox::Layer<voxblox::EsdfCachingVoxel>>& previousLayer,
+    const voxblox::BlockIndexList& updatedBlocks, bool cacheHessians, bool cacheTrilinearCells,
+    voxblox::BlockIndexList* changedBlocks);
+
+}  // namespace perceptive_mpc
@@ -29,24 +29,72 @@
 
 #pragma once
 
+#include <mutex>
+
+#include <Eigen/Core>
+
 // voxblox
+#include <voxblox/core/compact_esdf_layer.h>
+#include <voxblox/core/esdf_window.h>
 #include <voxblox_ros/esdf_server.h>
 
+#include <perceptive_mpc/EsdfCachingLayer.h>
+#include <perceptive_mpc/EsdfCachingSnapshot.h>
+
 namespace voxblox {
 
 class EsdfCachingServer : virtual public EsdfServer {
  public:
   EsdfCachingServer(const ros::NodeHandle& nh, const ros::NodeHandle& nh_private);
   void esdfMapCallback(const voxblox_msgs::Layer& layer_msg) override;
-  std::shared_ptr<voxblox::Interpolator<voxblox::EsdfCachingVoxel>> getInterpolator();
+  std::shared_ptr<const perceptive_mpc::EsdfCachingSnapshotBuffer> getEsdfSnapshots();
+  // publishes the latest map received by esdfMapCallback, call between mpc iterations. Also recenters the esdf window
+  // on the robot position once it moved away by more than the margin.
   void updateInterpolator();
+  // the esdf window is centered on this position when the next map arrives or the margin is exceeded
+  void setRobotPosition(const Eigen::Vector3d& position);
 
  private:
   using esdf_caching_layer_ptr = std::shared_ptr<voxblox::Layer<voxblox::EsdfCachingVoxel>>;
+  using compact_layer_ptr = std::shared_ptr<voxblox::CompactEsdfLayer>;
+  using window_ptr = std::shared_ptr<voxblox::EsdfWindow>;
+
+  // incremental unless reset or nothing was built yet
+  perceptive_mpc::EsdfCachingSnapshot::ConstPtr buildCachingSnapshot(const BlockIndexList& updatedBlocks, bool reset);
+  perceptive_mpc::EsdfCachingSnapshot::ConstPtr buildCompactSnapshot(const BlockIndexList& updatedBlocks, bool reset);
+  // moves a copy of the last window to the robot and refreshes the changed blocks
+  window_ptr buildWindow(const Layer<EsdfCachingVoxel>& layer, const BlockIndexList& changedBlocks, bool reset);
+  // snapshot with the layer of the given one and its window moved to the robot, nullptr if the robot is still within
+  // the margin around the window center
+  perceptive_mpc::EsdfCachingSnapshot::ConstPtr recenterWindow(const perceptive_mpc::EsdfCachingSnapshot& snapshot);
+  Eigen::Vector3d getRobotPosition();
 
-  std::mutex cacheMutex_;
-  esdf_caching_layer_ptr currentCachingLayer_ = nullptr;
-  esdf_caching_layer_ptr cachedCachingLayer_ = nullptr;
-  std::shared_ptr<voxblox::Interpolator<voxblox::EsdfCachingVoxel>> interpolator_ = nullptr;
+  // last layer built by esdfMapCallback, only accessed from the callback. Its blocks are shared with the published
+  // snapshots and therefore never written again.
+  esdf_caching_layer_ptr latestCachingLayer_ = nullptr;
+  // last compact layer, only used with compactEsdfLayer_
+  compact_layer_ptr latestCompactLayer_ = nullptr;
+  // precompute the hessians for the second order cost expansion, ros param "cache_hessians"
+  bool cacheHessians_ = false;
+  // hand out the structure-of-arrays layer instead of the caching layer, ros param "compact_esdf_layer"
+  bool compactEsdfLayer_ = false;
+  // store the gradients of the compact layer in half precision, ros param "half_precision_gradients"
+  bool halfPrecisionGradients_ = false;
+  // trilinear interpolation for the first order queries, ros param "trilinear_esdf_interpolation"
+  bool trilinearInterpolation_ = false;
+  // side length in meters of the dense esdf window around the robot, 0 disables it, ros param "esdf_window_size"
+  double esdfWindowSize_ = 0.0;
+  // distance in meters along any axis between the robot and the window center at which updateInterpolator moves the
+  // window, ros param "esdf_window_margin"
+  double esdfWindowMargin_ = 0.25;
+  // last window, written by the callback and by updateInterpolator, copied before it is changed
+  std::mutex windowMutex_;
+  window_ptr latestWindow_ = nullptr;
+  // written by the mpc thread, read by the callback
+  std::mutex robotPositionMutex_;
+  Eigen::Vector3d robotPosition_ = Eigen::Vector3d::Zero();
+  // built but not yet published snapshot, exchanged atomically
+  perceptive_mpc::EsdfCachingSnapshot::ConstPtr pendingSnapshot_ = nullptr;
+  std::shared_ptr<perceptive_mpc::EsdfCachingSnapshotBuffer> esdfSnapshots_ = nullptr;
 };
 } /* namespace voxblox */
\ No newline at end of file
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2020 Johannes Pankert <pankertj@ethz.ch>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of this work nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <memory>
+
+// voxblox
+#include <voxblox/core/compact_esdf_layer.h>
+#include <voxblox/core/esdf_window.h>
+#include <voxblox/core/layer.h>
+#include <voxblox/core/voxel.h>
+#include <voxblox/interpolator/interpolator.h>
+
+namespace perceptive_mpc {
+
+/**
+ * Immutable esdf caching layer together with an interpolator on it, or alternatively a compact structure-of-arrays
+ * layer. The blocks of a published snapshot are never written again, so holding the shared pointer keeps a consistent
+ * map alive while a newer one is being built. The caching layer may come with a dense window around the robot, which
+ * answers the first order queries inside of it.
+ */
+struct EsdfCachingSnapshot {
+  using ConstPtr = std::shared_ptr<const EsdfCachingSnapshot>;
+  using layer_ptr = std::shared_ptr<const voxblox::Layer<voxblox::EsdfCachingVoxel>>;
+  using compact_layer_ptr = voxblox::CompactEsdfLayer::ConstPtr;
+  using window_ptr = voxblox::EsdfWindow::ConstPtr;
+  using interpolator_t = voxblox::Interpolator<voxblox::EsdfCachingVoxel>;
+
+  explicit EsdfCachingSnapshot(layer_ptr layerIn, bool hasHessiansIn = false, window_ptr windowIn = nullptr,
+                               bool trilinearIn = false)
+      : layer(std::move(layerIn)),
+        interpolator(layer.get()),
+        compactLayer(nullptr),
+        window(std::move(windowIn)),
+        hasHessians(hasHessiansIn),
+        trilinear(trilinearIn) {}
+
+  explicit EsdfCachingSnapshot(compact_layer_ptr compactLayerIn)
+      : layer(nullptr),
+        interpolator(nullptr),
+        compactLayer(std::move(compactLayerIn)),
+        window(nullptr),
+        hasHessians(compactLayer->has_hessians()),
+        trilinear(false) {}
+
+  // batched first order query on whichever layer the snapshot holds
+  size_t getDistancesGradients(const voxblox::PointsMatrix& positions, interpolator_t::DistanceVector* distances,
+                               voxblox::PointsMatrix* gradients, interpolator_t::ValidityVector* valid) const {
+    if (compactLayer) {
+      return compactLayer->getInterpolatedDistancesGradients(positions, distances, gradients, valid);
+    }
+    if (window) {
+      size_t numValid = trilinear ? window->getTrilinearDistancesGradients(positions, distances, gradients, valid)
+                                  : window->getInterpolatedDistancesGradients(positions, distances, gradients, valid);
+      // points that left the window since it was built are looked up in the layer
+      for (Eigen::Index i = 0; i < positions.cols(); ++i) {
+        if (!(*valid)(i) && !window->contains(positions.col(i))) {
+          voxblox::FloatingPoint distance;
+          voxblox::Point gradient;
+          const bool pointValid =
+              trilinear ? interpolator.getTrilinearDistanceGradientFromCell(positions.col(i), &distance, &gradient)
+                        : interpolator.getInterpolatedDistanceGradient(positions.col(i), &distance, &gradient);
+          if (pointValid) {
+            (*distances)(i) = distance;
+            gradients->col(i) = gradient;
+            (*valid)(i) = true;
+            ++numValid;
+          }
+        }
+      }
+      return numValid;
+    }
+    if (trilinear) {
+      return interpolator.getTrilinearDistancesGradientsFromCells(positions, distances, gradients, valid);
+    }
+    return interpolator.getInterpolatedDistancesGradients(positions, distances, gradients, valid);
+  }
+
+  // batched second order query, requires hasHessians
+  size_t getDistancesGradientsHessians(const voxblox::PointsMatrix& positions, interpolator_t::DistanceVector* distances,
+                                       voxblox::PointsMatrix* gradients, interpolator_t::SymmetricMatrices* hessians,
+                                       interpolator_t::ValidityVector* valid) const {
+    if (compactLayer) {
+      return compactLayer->getInterpolatedDistancesGradientsFromHessians(positions, distances, gradients, hessians, valid);
+    }
+    return interpolator.getInterpolatedDistancesGradientsFromHessians(positions, distances, gradients, hessians, valid);
+  }
+
+  const layer_ptr layer;
+  const interpolator_t interpolator;
+  const compact_layer_ptr compactLayer;
+  // dense copy of the layer around the robot, only used for the first order queries
+  const window_ptr window;
+  // whether the hessians of the layer are cached in addition to the gradients
+  const bool hasHessians;
+  // trilinear interpolation of the eight surrounding voxels instead of the expansion of the containing one, only used
+  // for the first order queries on the caching layer, which then has to cache its trilinear cells
+  const bool trilinear;
+};
+
+/**
+ * Hands esdf snapshots from the map thread to the MPC. Reading and publishing are single atomic pointer operations, a
+ * reader keeps the snapshot it got until it asks again.
+ */
+class EsdfCachingSnapshotBuffer {
+ public:
+  EsdfCachingSnapshot::ConstPtr getSnapshot() const { return std::atomic_load(&snapshot_); }
+
+  void publish(EsdfCachingSnapshot::ConstPtr snapshot) { std::atomic_store(&snapshot_, std::move(snapshot)); }
+
+ private:
+  EsdfCachingSnapshot::ConstPtr snapshot_ = nullptr;
+};
+
+}  // namespace perceptive_mpc
@@ -66,6 +66,11 @@ class PointsOnRobot {
 
   Eigen::MatrixXd getJacobian(const Eigen::VectorXd& state) const;
 
+  // in-place versions that do not allocate, the outputs must already have the right size
+  void getPoints(Eigen::Ref<const Eigen::VectorXd> state, Eigen::Ref<Eigen::VectorXd> points) const;
+
+  void getJacobian(Eigen::Ref<const Eigen::VectorXd> state, Eigen::Ref<Eigen::MatrixXd> jacobian) const;
+
   Eigen::VectorXd getRadii() const;
 
   int numOfPoints() const;
@@ -36,23 +36,15 @@
 #include "ocs2_core/cost/CostFunctionBase.h"
 #include "perceptive_mpc/Definitions.h"
 
-namespace voxblox {
-class EsdfCachingVoxel;
-
-template <typename VoxelType>
-class Interpolator;
-}  // namespace voxblox
-
 namespace perceptive_mpc {
-using typename voxblox::EsdfCachingVoxel;
-using voxblox::Interpolator;
+class EsdfCachingSnapshotBuffer;
 
 struct VoxbloxCostConfig {
   double mu = 1;
   double delta = 1e-3;
   double maxDistance = 2.0;
   std::shared_ptr<const PointsOnRobot> pointsOnRobot;
-  std::shared_ptr<Interpolator<EsdfCachingVoxel>> interpolator;
+  std::shared_ptr<const EsdfCachingSnapshotBuffer> esdfSnapshots;
 };
 
 class VoxbloxCost : public ocs2::CostFunctionBase<Definitions::STATE_DIM_, Definitions::INPUT_DIM_> {
@@ -70,24 +62,39 @@ class VoxbloxCost : public ocs2::CostFunctionBase<Definitions::STATE_DIM_, Defin
 
   VoxbloxCost(const VoxbloxCostConfig& config)
       : CostFunctionBase(),
-        interpolator_(config.interpolator),
-        maxDistance_(config.maxDistance),
         mu_(config.mu),
         delta_(config.delta),
+        maxDistance_(config.maxDistance),
         pointsOnRobot_(config.pointsOnRobot),
+        esdfSnapshots_(config.esdfSnapshots),
+        radii_(pointsOnRobot_->getRadii()),
+        positionsPointsOnRobot_(3 * pointsOnRobot_->numOfPoints()),
+        jacobianPointsOnRobot_(3 * pointsOnRobot_->numOfPoints(), STATE_DIM_),
+        positionsVoxblox_(3, pointsOnRobot_->numOfPoints()),
+        distancesVoxblox_(pointsOnRobot_->numOfPoints()),
+        gradientsVoxblox3D_(3, pointsOnRobot_->numOfPoints()),
+        hessiansVoxblox_(6, pointsOnRobot_->numOfPoints()),
+        validVoxblox_(pointsOnRobot_->numOfPoints()),
         distances_(pointsOnRobot_->numOfPoints()),
-        gradientsVoxblox_(pointsOnRobot_->numOfPoints(), pointsOnRobot_->numOfPoints() * 3),
-        gradients_(pointsOnRobot_->numOfPoints(), 13) {}
+        gradients_(pointsOnRobot_->numOfPoints(), STATE_DIM_) {}
 
   VoxbloxCost(const VoxbloxCost& rhs)
       : CostFunctionBase(),
-        interpolator_(rhs.interpolator_),
-        maxDistance_(rhs.maxDistance_),
         mu_(rhs.mu_),
         delta_(rhs.delta_),
+        maxDistance_(rhs.maxDistance_),
         pointsOnRobot_(new PointsOnRobot(*rhs.pointsOnRobot_)),
+        esdfSnapshots_(rhs.esdfSnapshots_),
+        radii_(rhs.radii_),
+        positionsPointsOnRobot_(rhs.positionsPointsOnRobot_),
+        jacobianPointsOnRobot_(rhs.jacobianPointsOnRobot_),
+        positionsVoxblox_(rhs.positionsVoxblox_),
+        distancesVoxblox_(rhs.distancesVoxblox_),
+        gradientsVoxblox3D_(rhs.gradientsVoxblox3D_),
+        hessiansVoxblox_(rhs.hessiansVoxblox_),
+        validVoxblox_(rhs.validVoxblox_),
+        hessiansValid_(rhs.hessiansValid_),
         distances_(rhs.distances_),
-        gradientsVoxblox_(rhs.gradientsVoxblox_),
         gradients_(rhs.gradients_) {}
 
   /**
@@ -113,16 +120,39 @@ class VoxbloxCost : public ocs2::CostFunctionBase<Definitions::STATE_DIM_, Defin
 
   void getIntermediateCostDerivativeStateVerbose(state_vector_t& dLdx);
 
+  /**
+   * Adds the curvature of the distance field of one point, penaltyDerivative * J^T * hessian * J, to dLdxx. Only the
+   * positive semidefinite part of penaltyDerivative * hessian is kept: the penalty decreases with the distance, so
+   * the full term is indefinite wherever the distance field is convex and would make dLdxx indefinite near obstacles.
+   */
+  static void addDistanceCurvature(scalar_t penaltyDerivative, const Eigen::Matrix3d& hessian,
+                                   const Eigen::Matrix<scalar_t, 3, STATE_DIM_>& jacobian, state_matrix_t& dLdxx);
+
  private:
   scalar_t mu_;
   scalar_t delta_;
   scalar_t maxDistance_;
 
   std::shared_ptr<const PointsOnRobot> pointsOnRobot_;
-  std::shared_ptr<Interpolator<EsdfCachingVoxel>> interpolator_;
+  std::shared_ptr<const EsdfCachingSnapshotBuffer> esdfSnapshots_;
+
+  Eigen::VectorXd radii_;
+
+  // kinematics of the points on the robot, sized once at construction
+  Eigen::VectorXd positionsPointsOnRobot_;
+  Eigen::MatrixXd jacobianPointsOnRobot_;
+
+  // buffers for the batched esdf query, sized once at construction
+  Eigen::Matrix<float, 3, -1> positionsVoxblox_;
+  Eigen::VectorXf distancesVoxblox_;
+  Eigen::Matrix<float, 3, -1> gradientsVoxblox3D_;
+  // compact symmetric esdf hessians (xx, xy, xz, yy, yz, zz), only filled if the map caches them
+  Eigen::Matrix<float, 6, -1> hessiansVoxblox_;
+  Eigen::Matrix<bool, -1, 1> validVoxblox_;
+  bool hessiansValid_ = false;
 
   Eigen::Matrix<scalar_t, -1, 1> distances_;
-  Eigen::MatrixXd gradientsVoxblox_;
+  // row i is the distance gradient of point i w.r.t. the state
   Eigen::Matrix<scalar_t, -1, STATE_DIM_> gradients_;
 
   scalar_t getPenaltyFunctionValue(scalar_t h) const {
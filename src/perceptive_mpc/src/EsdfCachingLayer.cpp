@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2020 Johannes Pankert <pankertj@ethz.ch>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of this work nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <perceptive_mpc/EsdfCachingLayer.h>
+
+#include <chrono>
+#include <iostream>
+
+using namespace voxblox;
+
+namespace perceptive_mpc {
+
+void copyEsdfBlock(const Layer<EsdfVoxel>& esdfLayer, const BlockIndex& blockIdx, Layer<EsdfCachingVoxel>* layer) {
+  const Block<EsdfVoxel>& esdfBlock = esdfLayer.getBlockByIndex(blockIdx);
+  layer->removeBlock(blockIdx);
+  Block<EsdfCachingVoxel>::Ptr block = layer->allocateNewBlock(blockIdx);
+  for (size_t i = 0u; i < esdfBlock.num_voxels(); ++i) {
+    block->getVoxelByLinearIndex(i) = esdfBlock.getVoxelByLinearIndex(i);
+  }
+  block->has_data() = esdfBlock.has_data();
+}
+
+IndexSet dilateEsdfBlocks(const Layer<EsdfVoxel>& esdfLayer, const BlockIndexList& blocks, IndexElement radius) {
+  IndexSet dilatedBlocks;
+  for (const BlockIndex& blockIdx : blocks) {
+    for (IndexElement x = -radius; x <= radius; ++x) {
+      for (IndexElement y = -radius; y <= radius; ++y) {
+        for (IndexElement z = -radius; z <= radius; ++z) {
+          const BlockIndex neighborIdx = blockIdx + BlockIndex(x, y, z);
+          if (esdfLayer.hasBlock(neighborIdx)) {
+            dilatedBlocks.insert(neighborIdx);
+          }
+        }
+      }
+    }
+  }
+  return dilatedBlocks;
+}
+
+esdf_caching_layer_ptr buildEsdfCachingLayer(const Layer<EsdfVoxel>& esdfLayer,
+                                             const std::shared_ptr<const Layer<EsdfCachingVoxel>>& previousLayer,
+                                             const BlockIndexList& updatedBlocks, bool cacheHessians,
+                                             bool cacheTrilinearCells, BlockIndexList* changedBlocks) {
+  auto start = std::chrono::high_resolution_clock::now();
+  esdf_caching_layer_ptr incomingEsdfCached;
+  const bool incremental = previousLayer != nullptr;
+  changedBlocks->clear();
+  if (incremental) {
+    // The copy shares all blocks with the previous layer. Only the blocks contained in the message and their neighbors,
+    // whose border gradients change as well, are replaced by fresh copies before the gradients are recomputed.
+    incomingEsdfCached = esdf_caching_layer_ptr(new Layer<EsdfCachingVoxel>(*previousLayer));
+    for (const BlockIndex& blockIdx : dilateEsdfBlocks(esdfLayer, updatedBlocks, 1)) {
+      copyEsdfBlock(esdfLayer, blockIdx, incomingEsdfCached.get());
+      changedBlocks->push_back(blockIdx);
+    }
+  } else {
+    incomingEsdfCached = esdf_caching_layer_ptr(new Layer<EsdfCachingVoxel>(esdfLayer));
+  }
+  auto stop = std::chrono::high_resolution_clock::now();
+  using us = std::chrono::microseconds;
+  us elapsedUs = std::chrono::duration_cast<us>(stop - start);
+  std::cout << "create caching layer from incoming esdf: " << elapsedUs.count() << "us" << std::endl;
+
+  start = std::chrono::high_resolution_clock::now();
+  if (incremental) {
+    incomingEsdfCached->cacheGradients(updatedBlocks);
+  } else {
+    incomingEsdfCached->cacheGradients();
+  }
+  stop = std::chrono::high_resolution_clock::now();
+  elapsedUs = std::chrono::duration_cast<us>(stop - start);
+  std::cout << "cache gradients: " << elapsedUs.count() << "us" << std::endl;
+
+  if (cacheHessians) {
+    start = std::chrono::high_resolution_clock::now();
+    if (incremental) {
+      incomingEsdfCached->cacheHessians(updatedBlocks);
+    } else {
+      incomingEsdfCached->cacheHessians();
+    }
+    stop = std::chrono::high_resolution_clock::now();
+    elapsedUs = std::chrono::duration_cast<us>(stop - start);
+    std::cout << "cache hessians: " << elapsedUs.count() << "us" << std::endl;
+  }
+
+  if (cacheTrilinearCells) {
+    start = std::chrono::high_resolution_clock::now();
+    if (incremental) {
+      incomingEsdfCached->cacheTrilinearCells(updatedBlocks);
+    } else {
+      incomingEsdfCached->cacheTrilinearCells();
+    }
+    stop = std::chrono::high_resolution_clock::now();
+    elapsedUs = std::chrono::duration_cast<us>(stop - start);
+    std::cout << "cache trilinear cells: " << elapsedUs.count() << "us" << std::endl;
+  }
+
+  return incomingEsdfCached;
+}
+
+}  // namespace perceptive_mpc
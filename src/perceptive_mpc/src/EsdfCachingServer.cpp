@@ -29,44 +29,213 @@
 
 #include <perceptive_mpc/EsdfCachingServer.hpp>
 
+#include <cmath>
+
+#include <voxblox_ros/conversions.h>
+
 namespace voxblox {
 
 void EsdfCachingServer::esdfMapCallback(const voxblox_msgs::Layer& layer_msg) {
-  EsdfServer::esdfMapCallback(layer_msg);
-  auto start = std::chrono::high_resolution_clock::now();
+  if (!receiveEsdfMap(layer_msg)) {
+    // the esdf layer is left as it was, so the current snapshot still matches it. The blocks of this message are lost
+    // though: the publisher only resends them once they change again or it resets the remote map.
+    ROS_WARN_THROTTLE(10, "Dropped an invalid ESDF map message with %zu blocks, they stay stale until they are resent.",
+                      layer_msg.blocks.size());
+    return;
+  }
+
+  BlockIndexList updatedBlocks;
+  updatedBlocks.reserve(layer_msg.blocks.size());
+  for (const voxblox_msgs::Block& blockMsg : layer_msg.blocks) {
+    updatedBlocks.push_back(BlockIndex(blockMsg.x_index, blockMsg.y_index, blockMsg.z_index));
+  }
+  const bool reset = static_cast<MapDerializationAction>(layer_msg.action) == MapDerializationAction::kReset;
+
+  perceptive_mpc::EsdfCachingSnapshot::ConstPtr snapshot;
+  if (compactEsdfLayer_) {
+    snapshot = buildCompactSnapshot(updatedBlocks, reset);
+  } else {
+    snapshot = buildCachingSnapshot(updatedBlocks, reset);
+  }
+  std::atomic_store(&pendingSnapshot_, snapshot);
+}
+
+perceptive_mpc::EsdfCachingSnapshot::ConstPtr EsdfCachingServer::buildCachingSnapshot(const BlockIndexList& updatedBlocks,
+                                                                                      bool reset) {
+  const Layer<EsdfVoxel>& esdfLayer = getEsdfMapPtr()->getEsdfLayer();
+
+  const bool incremental = latestCachingLayer_ && !reset;
+  BlockIndexList changedBlocks;
   esdf_caching_layer_ptr incomingEsdfCached =
-      esdf_caching_layer_ptr(new voxblox::Layer<voxblox::EsdfCachingVoxel>(getEsdfMapPtr()->getEsdfLayer()));
+      perceptive_mpc::buildEsdfCachingLayer(esdfLayer, incremental ? latestCachingLayer_ : nullptr, updatedBlocks,
+                                            cacheHessians_, trilinearInterpolation_, &changedBlocks);
+
+  window_ptr window;
+  if (esdfWindowSize_ > 0.0) {
+    auto start = std::chrono::high_resolution_clock::now();
+    window = buildWindow(*incomingEsdfCached, changedBlocks, !incremental);
+    auto stop = std::chrono::high_resolution_clock::now();
+    using us = std::chrono::microseconds;
+    ROS_DEBUG_THROTTLE(1.0, "update esdf window: %ldus",
+                       static_cast<long>(std::chrono::duration_cast<us>(stop - start).count()));
+  }
+
+  latestCachingLayer_ = incomingEsdfCached;
+  return std::make_shared<perceptive_mpc::EsdfCachingSnapshot>(incomingEsdfCached, cacheHessians_, window,
+                                                                 trilinearInterpolation_);
+}
+
+EsdfCachingServer::window_ptr EsdfCachingServer::buildWindow(const Layer<EsdfCachingVoxel>& layer,
+                                                             const BlockIndexList& changedBlocks, bool reset) {
+  const Eigen::Vector3d robotPosition = getRobotPosition();
+  window_ptr previousWindow;
+  {
+    std::lock_guard<std::mutex> lock(windowMutex_);
+    previousWindow = latestWindow_;
+  }
+
+  window_ptr window;
+  if (previousWindow && !reset) {
+    // Published windows are read by the mpc, so the changes go to a copy. The copy shares the bricks of the previous
+    // window and only duplicates the ones it writes: the voxels entering the window and the changed blocks.
+    window = window_ptr(new EsdfWindow(*previousWindow));
+    window->moveTo(layer, robotPosition.cast<FloatingPoint>());
+    window->updateBlocks(layer, changedBlocks);
+  } else {
+    const size_t sideVoxels = static_cast<size_t>(std::ceil(esdfWindowSize_ / layer.voxel_size()));
+    window = window_ptr(new EsdfWindow(layer.voxel_size(), sideVoxels));
+    window->moveTo(layer, robotPosition.cast<FloatingPoint>());
+  }
+  {
+    std::lock_guard<std::mutex> lock(windowMutex_);
+    latestWindow_ = window;
+  }
+  return window;
+}
+
+perceptive_mpc::EsdfCachingSnapshot::ConstPtr EsdfCachingServer::recenterWindow(
+    const perceptive_mpc::EsdfCachingSnapshot& snapshot) {
+  const Eigen::Vector3d robotPosition = getRobotPosition();
+  const Point center = robotPosition.cast<FloatingPoint>();
+  if (!snapshot.window || (center - snapshot.window->center()).cwiseAbs().maxCoeff() <= esdfWindowMargin_) {
+    return nullptr;
+  }
+
+  auto start = std::chrono::high_resolution_clock::now();
+  // the layer of the snapshot is immutable, so the moved window stays consistent with it
+  window_ptr window(new EsdfWindow(*snapshot.window));
+  window->moveTo(*snapshot.layer, center);
+  {
+    // the next map message continues from the moved window, unless it already built a newer one
+    std::lock_guard<std::mutex> lock(windowMutex_);
+    if (latestWindow_.get() == snapshot.window.get()) {
+      latestWindow_ = window;
+    }
+  }
   auto stop = std::chrono::high_resolution_clock::now();
   using us = std::chrono::microseconds;
-  us elapsedUs = std::chrono::duration_cast<us>(stop - start);
-  std::cout << "create caching layer from incoming esdf: " << elapsedUs.count() << "us" << std::endl;
+  ROS_DEBUG_THROTTLE(1.0, "recenter esdf window: %ldus",
+                     static_cast<long>(std::chrono::duration_cast<us>(stop - start).count()));
 
-  start = std::chrono::high_resolution_clock::now();
-  incomingEsdfCached->cacheGradients();
-  stop = std::chrono::high_resolution_clock::now();
-  elapsedUs = std::chrono::duration_cast<us>(stop - start);
-  std::cout << "cache gradients: " << elapsedUs.count() << "us" << std::endl;
+  return std::make_shared<perceptive_mpc::EsdfCachingSnapshot>(snapshot.layer, snapshot.hasHessians, window,
+                                                                 snapshot.trilinear);
+}
 
-  //incomingEsdfCached->cacheHessians();
-  {
-    std::lock_guard<std::mutex> lockGuard(cacheMutex_);
-    cachedCachingLayer_ = incomingEsdfCached;
+perceptive_mpc::EsdfCachingSnapshot::ConstPtr EsdfCachingServer::buildCompactSnapshot(const BlockIndexList& updatedBlocks,
+                                                                                      bool reset) {
+  const Layer<EsdfVoxel>& esdfLayer = getEsdfMapPtr()->getEsdfLayer();
+
+  auto start = std::chrono::high_resolution_clock::now();
+  compact_layer_ptr incomingCompact;
+  BlockIndexList changedBlocks;
+  if (latestCompactLayer_ && !reset) {
+    // shares all blocks with the previous layer, only the converted ones are replaced
+    incomingCompact = compact_layer_ptr(new CompactEsdfLayer(*latestCompactLayer_));
+    changedBlocks = updatedBlocks;
+  } else {
+    incomingCompact = compact_layer_ptr(
+        new CompactEsdfLayer(esdfLayer.voxel_size(), esdfLayer.voxels_per_side(), halfPrecisionGradients_, cacheHessians_));
+    esdfLayer.getAllAllocatedBlocks(&changedBlocks);
+  }
+
+  // The gradients of the changed blocks and their neighbors are computed in a temporary caching layer that only holds
+  // the esdf blocks they depend on. The hessians reach one block further.
+  Layer<EsdfCachingVoxel> workLayer(esdfLayer.voxel_size(), esdfLayer.voxels_per_side());
+  const IndexSet workBlocks = perceptive_mpc::dilateEsdfBlocks(esdfLayer, changedBlocks, cacheHessians_ ? 3 : 2);
+  for (const BlockIndex& blockIdx : workBlocks) {
+    perceptive_mpc::copyEsdfBlock(esdfLayer, blockIdx, &workLayer);
+  }
+  BlockIndexList convertedBlocks;
+  for (const BlockIndex& blockIdx : perceptive_mpc::dilateEsdfBlocks(esdfLayer, changedBlocks, 1)) {
+    convertedBlocks.push_back(blockIdx);
+  }
+  if (cacheHessians_) {
+    workLayer.cacheGradients(convertedBlocks);
+    workLayer.cacheHessians(changedBlocks);
+  } else {
+    workLayer.cacheGradients(changedBlocks);
   }
+  incomingCompact->updateBlocks(workLayer, convertedBlocks);
+
+  auto stop = std::chrono::high_resolution_clock::now();
+  using us = std::chrono::microseconds;
+  us elapsedUs = std::chrono::duration_cast<us>(stop - start);
+  std::cout << "build compact layer from incoming esdf: " << elapsedUs.count() << "us" << std::endl;
+
+  latestCompactLayer_ = incomingCompact;
+  return std::make_shared<perceptive_mpc::EsdfCachingSnapshot>(incomingCompact);
 }
-std::shared_ptr<voxblox::Interpolator<voxblox::EsdfCachingVoxel>> EsdfCachingServer::getInterpolator() {
-  return interpolator_;
+
+std::shared_ptr<const perceptive_mpc::EsdfCachingSnapshotBuffer> EsdfCachingServer::getEsdfSnapshots() {
+  return esdfSnapshots_;
 }
 void EsdfCachingServer::updateInterpolator() {
-  std::lock_guard<std::mutex> lockGuard(cacheMutex_);
-  if (cachedCachingLayer_) {
-    currentCachingLayer_ = cachedCachingLayer_;
-    cachedCachingLayer_ = nullptr;
-    *interpolator_ = voxblox::Interpolator<EsdfCachingVoxel>(currentCachingLayer_.get());
+  perceptive_mpc::EsdfCachingSnapshot::ConstPtr snapshot =
+      std::atomic_exchange(&pendingSnapshot_, perceptive_mpc::EsdfCachingSnapshot::ConstPtr());
+  if (esdfWindowSize_ > 0.0) {
+    // the window follows the robot between map messages as well
+    const perceptive_mpc::EsdfCachingSnapshot::ConstPtr current = snapshot ? snapshot : esdfSnapshots_->getSnapshot();
+    perceptive_mpc::EsdfCachingSnapshot::ConstPtr recentered = current ? recenterWindow(*current) : nullptr;
+    if (recentered) {
+      snapshot = std::move(recentered);
+    }
   }
+  if (snapshot) {
+    esdfSnapshots_->publish(std::move(snapshot));
+  }
+}
+void EsdfCachingServer::setRobotPosition(const Eigen::Vector3d& position) {
+  std::lock_guard<std::mutex> lock(robotPositionMutex_);
+  robotPosition_ = position;
+}
+Eigen::Vector3d EsdfCachingServer::getRobotPosition() {
+  std::lock_guard<std::mutex> lock(robotPositionMutex_);
+  return robotPosition_;
 }
 EsdfCachingServer::EsdfCachingServer(const ros::NodeHandle& nh, const ros::NodeHandle& nh_private) : EsdfServer(nh, nh_private) {
-  currentCachingLayer_ = esdf_caching_layer_ptr(new voxblox::Layer<voxblox::EsdfCachingVoxel>(getEsdfMapPtr()->getEsdfLayer()));
-  interpolator_.reset(new voxblox::Interpolator<EsdfCachingVoxel>(currentCachingLayer_.get()));
+  nh_private.param("cache_hessians", cacheHessians_, cacheHessians_);
+  nh_private.param("compact_esdf_layer", compactEsdfLayer_, compactEsdfLayer_);
+  nh_private.param("half_precision_gradients", halfPrecisionGradients_, halfPrecisionGradients_);
+  nh_private.param("esdf_window_size", esdfWindowSize_, esdfWindowSize_);
+  nh_private.param("esdf_window_margin", esdfWindowMargin_, esdfWindowMargin_);
+  nh_private.param("trilinear_esdf_interpolation", trilinearInterpolation_, trilinearInterpolation_);
+  if ((compactEsdfLayer_ || cacheHessians_) && trilinearInterpolation_) {
+    ROS_WARN("Trilinear esdf interpolation only applies to first order queries on the caching layer, it is disabled "
+             "with compact_esdf_layer or cache_hessians.");
+    trilinearInterpolation_ = false;
+  }
+  if ((compactEsdfLayer_ || cacheHessians_) && esdfWindowSize_ > 0.0) {
+    ROS_WARN("The esdf window only serves first order queries on the caching layer, it is disabled with "
+             "compact_esdf_layer or cache_hessians.");
+    esdfWindowSize_ = 0.0;
+  }
+  esdfSnapshots_ = std::make_shared<perceptive_mpc::EsdfCachingSnapshotBuffer>();
+  constexpr bool kReset = true;
+  if (compactEsdfLayer_) {
+    esdfSnapshots_->publish(buildCompactSnapshot(BlockIndexList(), kReset));
+  } else {
+    esdfSnapshots_->publish(buildCachingSnapshot(BlockIndexList(), kReset));
+  }
 }
 
 } /* namespace voxblox */
\ No newline at end of file
@@ -76,6 +76,12 @@ Eigen::VectorXd PointsOnRobot::getPoints(const Eigen::VectorXd& state) const {
 Eigen::MatrixXd PointsOnRobot::getJacobian(const Eigen::VectorXd& state) const {
   return cppAdInterface_->getJacobian(state);
 }
+void PointsOnRobot::getPoints(Eigen::Ref<const Eigen::VectorXd> state, Eigen::Ref<Eigen::VectorXd> points) const {
+  cppAdInterface_->getFunctionValue(state, Eigen::VectorXd(), points);
+}
+void PointsOnRobot::getJacobian(Eigen::Ref<const Eigen::VectorXd> state, Eigen::Ref<Eigen::MatrixXd> jacobian) const {
+  cppAdInterface_->getJacobian(state, Eigen::VectorXd(), jacobian);
+}
 visualization_msgs::MarkerArray PointsOnRobot::getVisualization(const Eigen::VectorXd& state) const {
   visualization_msgs::MarkerArray markerArray;
   markerArray.markers.resize(radii_.size());
@@ -27,7 +27,9 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 #include <perceptive_mpc/costs/VoxbloxCost.h>
-#include <voxblox/interpolator/interpolator.h>
+#include <perceptive_mpc/EsdfCachingSnapshot.h>
+
+#include <Eigen/Eigenvalues>
 
 using namespace ocs2;
 using namespace perceptive_mpc;
@@ -35,26 +37,35 @@ using namespace perceptive_mpc;
 void VoxbloxCost::setCurrentStateAndControl(const VoxbloxCost::scalar_t& t, const VoxbloxCost::state_vector_t& x,
                                             const VoxbloxCost::input_vector_t& u) {
   if (pointsOnRobot_) {
-    gradientsVoxblox_.setZero();
-    Eigen::VectorXd positionsPointsOnRobot = pointsOnRobot_->getPoints(x);
-    Eigen::MatrixXd jacobianPointsOnRobot = pointsOnRobot_->getJacobian(x);
-    Eigen::VectorXd radii = pointsOnRobot_->getRadii();
-    assert(positionsPointsOnRobot.size() % 3 == 0);
+    pointsOnRobot_->getPoints(x, positionsPointsOnRobot_);
+    pointsOnRobot_->getJacobian(x, jacobianPointsOnRobot_);
+    assert(positionsPointsOnRobot_.size() % 3 == 0);
     int numPoints = pointsOnRobot_->numOfPoints();
+    assert(gradients_.rows() == numPoints);
+    assert(gradients_.cols() == jacobianPointsOnRobot_.cols());
+    positionsVoxblox_ = Eigen::Map<const Eigen::Matrix<scalar_t, 3, -1>>(positionsPointsOnRobot_.data(), 3, numPoints).cast<float>();
+    // pin the current map, it stays valid even if a newer one gets published meanwhile
+    const EsdfCachingSnapshot::ConstPtr esdfSnapshot = esdfSnapshots_->getSnapshot();
+    hessiansValid_ = esdfSnapshot && esdfSnapshot->hasHessians;
+    if (hessiansValid_) {
+      esdfSnapshot->getDistancesGradientsHessians(positionsVoxblox_, &distancesVoxblox_, &gradientsVoxblox3D_, &hessiansVoxblox_,
+                                                  &validVoxblox_);
+    } else if (esdfSnapshot) {
+      esdfSnapshot->getDistancesGradients(positionsVoxblox_, &distancesVoxblox_, &gradientsVoxblox3D_, &validVoxblox_);
+    } else {
+      validVoxblox_.setConstant(false);
+    }
     for (int i = 0; i < numPoints; i++) {
-      float distance;
-      Eigen::Vector3f gradientVoxblox;
-      Eigen::Ref<Eigen::Matrix<scalar_t, 3, 1>> position = positionsPointsOnRobot.segment<3>(i * 3);
-      if (interpolator_->getInterpolatedDistanceGradient(position.cast<float>(), &distance, &gradientVoxblox)) {
-        distances_[i] = distance - radii(i);
-        gradientsVoxblox_.block<1, 3>(i, 3 * i) = gradientVoxblox.transpose().cast<double>();
+      if (validVoxblox_(i)) {
+        distances_[i] = distancesVoxblox_(i) - radii_(i);
+        // only the 3 rows of the jacobian belonging to point i contribute to its distance gradient
+        gradients_.row(i).noalias() =
+            gradientsVoxblox3D_.col(i).cast<scalar_t>().transpose() * jacobianPointsOnRobot_.block<3, STATE_DIM_>(3 * i, 0);
       } else {
-        distances_[i] = maxDistance_ - radii(i);
+        distances_[i] = maxDistance_ - radii_(i);
+        gradients_.row(i).setZero();
       }
     }
-    assert(gradients_.rows() == gradientsVoxblox_.rows());
-    assert(gradients_.cols() == jacobianPointsOnRobot.cols());
-    gradients_ = gradientsVoxblox_ * jacobianPointsOnRobot;
   }
 
   BASE::setCurrentStateAndControl(t, x, u);
@@ -72,7 +83,7 @@ void VoxbloxCost::getIntermediateCostDerivativeStateVerbose(VoxbloxCost::state_v
   std::cout << "distances_: " << std::endl << distances_ << std::endl;
   std::cout << "distances penalty_derivative_: " << std::endl << distances_.unaryExpr([this](const auto& x) { return getPenaltyFunctionDerivative(x); }) << std::endl;
   std::cout << "gradients_: " << std::endl << gradients_ << std::endl;
-  std::cout << "gradientsVoxblox_: " << std::endl << gradientsVoxblox_ << std::endl;
+  std::cout << "gradientsVoxblox3D_: " << std::endl << gradientsVoxblox3D_ << std::endl;
   Eigen::MatrixXd jacobianPointsOnRobot = pointsOnRobot_->getJacobian(x_);
   std::cout << "jacobianPointsOnRobot: " << std::endl << jacobianPointsOnRobot << std::endl;
 
@@ -81,6 +92,31 @@ void VoxbloxCost::getIntermediateCostDerivativeStateVerbose(VoxbloxCost::state_v
 void VoxbloxCost::getIntermediateCostSecondDerivativeState(VoxbloxCost::state_matrix_t& dLdxx) {
   dLdxx = gradients_.transpose() *
           distances_.unaryExpr([this](const auto& x) { return getPenaltyFunctionSecondDerivative(x); }).asDiagonal() * gradients_;
+  if (hessiansValid_) {
+    // curvature of the distance field, the second derivative of the forward kinematics is neglected
+    for (int i = 0; i < distances_.size(); i++) {
+      if (!validVoxblox_(i)) {
+        continue;
+      }
+      const auto& h = hessiansVoxblox_.col(i);
+      Eigen::Matrix3d hessian;
+      hessian << h(0), h(1), h(2), h(1), h(3), h(4), h(2), h(4), h(5);
+      const Eigen::Matrix<scalar_t, 3, STATE_DIM_> jacobian = jacobianPointsOnRobot_.block<3, STATE_DIM_>(3 * i, 0);
+      addDistanceCurvature(getPenaltyFunctionDerivative(distances_[i]), hessian, jacobian, dLdxx);
+    }
+  }
+}
+
+void VoxbloxCost::addDistanceCurvature(scalar_t penaltyDerivative, const Eigen::Matrix3d& hessian,
+                                       const Eigen::Matrix<scalar_t, 3, STATE_DIM_>& jacobian, state_matrix_t& dLdxx) {
+  Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eigenSolver;
+  eigenSolver.computeDirect(penaltyDerivative * hessian);
+  const Eigen::Vector3d lambda = eigenSolver.eigenvalues().cwiseMax(0.0);
+  if ((lambda.array() == 0.0).all()) {
+    return;
+  }
+  const Eigen::Matrix<scalar_t, 3, STATE_DIM_> projectedJacobian = eigenSolver.eigenvectors().transpose() * jacobian;
+  dLdxx.noalias() += projectedJacobian.transpose() * lambda.asDiagonal() * projectedJacobian;
 }
 void VoxbloxCost::getIntermediateCostDerivativeInput(VoxbloxCost::input_vector_t& dLdu) {
   dLdu = input_vector_t::Zero();
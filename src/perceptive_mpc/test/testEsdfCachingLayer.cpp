@@ -0,0 +1,136 @@
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include <perceptive_mpc/EsdfCachingLayer.h>
+
+using namespace perceptive_mpc;
+using namespace voxblox;
+
+namespace {
+using caching_layer_t = Layer<EsdfCachingVoxel>;
+
+void expectVoxelsEqual(const EsdfCachingVoxel& voxel, const EsdfCachingVoxel& expected) {
+  EXPECT_EQ(voxel.distance, expected.distance);
+  EXPECT_EQ(voxel.observed, expected.observed);
+  EXPECT_EQ(voxel.gradient_valid, expected.gradient_valid);
+  EXPECT_TRUE(voxel.gradient == expected.gradient)
+      << voxel.gradient.transpose() << ", " << expected.gradient.transpose();
+  EXPECT_TRUE(voxel.hessian == expected.hessian) << voxel.hessian.transpose() << ", " << expected.hessian.transpose();
+}
+
+void expectCellsEqual(const TrilinearCell& cell, const TrilinearCell& expected) {
+  EXPECT_EQ(cell.valid, expected.valid);
+  EXPECT_TRUE((cell.corners == expected.corners).all());
+}
+
+// compares every voxel of two caching layers with the same blocks
+void expectLayersEqual(const caching_layer_t& layer, const caching_layer_t& expected) {
+  BlockIndexList blocks;
+  expected.getAllAllocatedBlocks(&blocks);
+  ASSERT_EQ(layer.getNumberOfAllocatedBlocks(), blocks.size());
+  for (const BlockIndex& blockIdx : blocks) {
+    SCOPED_TRACE(blockIdx.transpose());
+    ASSERT_TRUE(layer.hasBlock(blockIdx));
+    const Block<EsdfCachingVoxel>& block = layer.getBlockByIndex(blockIdx);
+    const Block<EsdfCachingVoxel>& expectedBlock = expected.getBlockByIndex(blockIdx);
+    ASSERT_EQ(block.trilinear_cells() != nullptr, expectedBlock.trilinear_cells() != nullptr);
+    for (size_t i = 0u; i < block.num_voxels(); ++i) {
+      expectVoxelsEqual(block.getVoxelByLinearIndex(i), expectedBlock.getVoxelByLinearIndex(i));
+      if (block.trilinear_cells() != nullptr) {
+        expectCellsEqual(block.trilinear_cells()[i], expectedBlock.trilinear_cells()[i]);
+      }
+      if (::testing::Test::HasFailure()) {
+        return;
+      }
+    }
+  }
+}
+}  // namespace
+
+class EsdfCachingLayerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    esdfLayer_.reset(new Layer<EsdfVoxel>(voxelSize_, voxelsPerSide_));
+    for (IndexElement x = -2; x < 2; ++x) {
+      for (IndexElement y = -2; y < 2; ++y) {
+        for (IndexElement z = -1; z < 1; ++z) {
+          setBlock(BlockIndex(x, y, z), Point::Zero());
+        }
+      }
+    }
+  }
+
+  // distance field of a sphere of radius 0.5 around center
+  void setBlock(const BlockIndex& blockIdx, const Point& center) {
+    Block<EsdfVoxel>::Ptr block = esdfLayer_->allocateBlockPtrByIndex(blockIdx);
+    for (size_t i = 0u; i < block->num_voxels(); ++i) {
+      EsdfVoxel& voxel = block->getVoxelByLinearIndex(i);
+      voxel.distance = (block->computeCoordinatesFromLinearIndex(i) - center).norm() - 0.5f;
+      voxel.observed = true;
+    }
+    block->has_data() = true;
+  }
+
+  esdf_caching_layer_ptr buildFull() const {
+    BlockIndexList changedBlocks;
+    return buildEsdfCachingLayer(*esdfLayer_, nullptr, BlockIndexList(), true, true, &changedBlocks);
+  }
+
+  std::unique_ptr<Layer<EsdfVoxel>> esdfLayer_;
+  const FloatingPoint voxelSize_ = 0.1f;
+  const size_t voxelsPerSide_ = 8u;
+};
+
+TEST_F(EsdfCachingLayerTest, incrementalMatchesFullRebuild) {
+  const esdf_caching_layer_ptr previousLayer = buildFull();
+  // deep copy of the voxels, a copy of the layer would share its blocks
+  caching_layer_t expectedPrevious(voxelSize_, voxelsPerSide_);
+  BlockIndexList allBlocks;
+  previousLayer->getAllAllocatedBlocks(&allBlocks);
+  for (const BlockIndex& blockIdx : allBlocks) {
+    const Block<EsdfCachingVoxel>& block = previousLayer->getBlockByIndex(blockIdx);
+    Block<EsdfCachingVoxel>::Ptr copy = expectedPrevious.allocateBlockPtrByIndex(blockIdx);
+    for (size_t i = 0u; i < block.num_voxels(); ++i) {
+      copy->getVoxelByLinearIndex(i) = block.getVoxelByLinearIndex(i);
+    }
+    if (block.trilinear_cells() != nullptr) {
+      std::copy(block.trilinear_cells(), block.trilinear_cells() + block.num_voxels(), copy->allocateTrilinearCells());
+    }
+  }
+
+  // an obstacle moves inside one block
+  const BlockIndex updatedIdx(0, -1, 0);
+  setBlock(updatedIdx, Point(0.2f, -0.3f, 0.1f));
+  const BlockIndexList updatedBlocks(1, updatedIdx);
+  BlockIndexList changedBlocks;
+  const esdf_caching_layer_ptr layer =
+      buildEsdfCachingLayer(*esdfLayer_, previousLayer, updatedBlocks, true, true, &changedBlocks);
+
+  // the previous layer is still at the old state of the map
+  expectLayersEqual(*previousLayer, expectedPrevious);
+
+  // the neighbors are recomputed as well, their border gradients depend on the updated block
+  expectLayersEqual(*layer, *buildFull());
+
+  const IndexSet expectedChanged = dilateEsdfBlocks(*esdfLayer_, updatedBlocks, 1);
+  EXPECT_EQ(IndexSet(changedBlocks.begin(), changedBlocks.end()), expectedChanged);
+  EXPECT_EQ(changedBlocks.size(), expectedChanged.size());
+  for (const BlockIndex& blockIdx : allBlocks) {
+    const bool shared = layer->getBlockPtrByIndex(blockIdx) == previousLayer->getBlockPtrByIndex(blockIdx);
+    EXPECT_NE(shared, expectedChanged.count(blockIdx) > 0) << blockIdx.transpose();
+  }
+}
+
+TEST_F(EsdfCachingLayerTest, fullBuildLeavesChangedBlocksEmpty) {
+  BlockIndexList changedBlocks(1, BlockIndex::Zero());
+  const esdf_caching_layer_ptr layer =
+      buildEsdfCachingLayer(*esdfLayer_, nullptr, BlockIndexList(), false, false, &changedBlocks);
+  EXPECT_TRUE(changedBlocks.empty());
+  EXPECT_EQ(layer->getNumberOfAllocatedBlocks(), esdfLayer_->getNumberOfAllocatedBlocks());
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <Eigen/Eigenvalues>
+
+#include <perceptive_mpc/costs/VoxbloxCost.h>
+
+using namespace perceptive_mpc;
+
+namespace {
+using state_matrix_t = VoxbloxCost::state_matrix_t;
+using jacobian_t = Eigen::Matrix<double, 3, Definitions::STATE_DIM_>;
+
+double minEigenvalue(const state_matrix_t& matrix) {
+  return Eigen::SelfAdjointEigenSolver<state_matrix_t>(matrix, Eigen::EigenvaluesOnly).eigenvalues().minCoeff();
+}
+}  // namespace
+
+class VoxbloxCostCurvatureTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    srand(0);
+    jacobian_ = jacobian_t::Random();
+    // 5cm from the obstacle with mu = 1 and delta = 1e-3, the log barrier is -log(h)
+    const double distance = 0.05;
+    penaltyDerivative_ = -1.0 / distance;
+    penaltySecondDerivative_ = 1.0 / (distance * distance);
+  }
+
+  // second derivative of the penalty without the curvature of the distance field
+  state_matrix_t gaussNewton(const Eigen::Vector3d& gradient) const {
+    const Eigen::Matrix<double, 1, Definitions::STATE_DIM_> stateGradient = gradient.transpose() * jacobian_;
+    return penaltySecondDerivative_ * stateGradient.transpose() * stateGradient;
+  }
+
+  jacobian_t jacobian_;
+  double penaltyDerivative_;
+  double penaltySecondDerivative_;
+};
+
+TEST_F(VoxbloxCostCurvatureTest, psdNearSphere) {
+  // distance field of a sphere of radius 0.3, the distance is convex around it
+  const Eigen::Vector3d normal = Eigen::Vector3d(1.0, 2.0, -0.5).normalized();
+  const double radius = 0.3;
+  const Eigen::Matrix3d hessian = (Eigen::Matrix3d::Identity() - normal * normal.transpose()) / radius;
+
+  // the full curvature term makes the second derivative indefinite
+  const state_matrix_t full = gaussNewton(normal) + penaltyDerivative_ * jacobian_.transpose() * hessian * jacobian_;
+  EXPECT_LT(minEigenvalue(full), -1e-6);
+
+  state_matrix_t dLdxx = gaussNewton(normal);
+  VoxbloxCost::addDistanceCurvature(penaltyDerivative_, hessian, jacobian_, dLdxx);
+  EXPECT_GT(minEigenvalue(dLdxx), -1e-9 * dLdxx.norm());
+  EXPECT_TRUE(dLdxx.isApprox(gaussNewton(normal)));
+}
+
+TEST_F(VoxbloxCostCurvatureTest, keepsConcaveCurvature) {
+  // saddle of the distance field between two obstacles, concave along one direction
+  const Eigen::Matrix3d rotation = Eigen::AngleAxisd(0.7, Eigen::Vector3d(0.2, -1.0, 0.4).normalized()).toRotationMatrix();
+  const Eigen::Vector3d curvatures(-2.0, 1.5, 0.0);
+  const Eigen::Matrix3d hessian = rotation * curvatures.asDiagonal() * rotation.transpose();
+  const Eigen::Vector3d gradient = rotation.col(2);
+
+  state_matrix_t dLdxx = gaussNewton(gradient);
+  VoxbloxCost::addDistanceCurvature(penaltyDerivative_, hessian, jacobian_, dLdxx);
+  EXPECT_GT(minEigenvalue(dLdxx), -1e-9 * dLdxx.norm());
+
+  // only the concave direction contributes, scaled by the decrease of the penalty
+  const Eigen::Matrix<double, 1, Definitions::STATE_DIM_> concaveDirection = rotation.col(0).transpose() * jacobian_;
+  const state_matrix_t expected =
+      gaussNewton(gradient) + penaltyDerivative_ * curvatures(0) * concaveDirection.transpose() * concaveDirection;
+  EXPECT_TRUE(dLdxx.isApprox(expected));
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
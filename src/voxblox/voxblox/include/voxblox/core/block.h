@@ -9,6 +9,7 @@
 
 #include "./Block.pb.h"
 #include "voxblox/core/common.h"
+#include "voxblox/core/voxel.h"
 
 namespace voxblox {
 
@@ -178,6 +179,23 @@ class Block {
   }
   void set_has_data(bool has_data) { has_data_ = has_data; }
 
+  /**
+   * Trilinear cells of the voxels, with the same linear indices. Only
+   * allocated by allocateTrilinearCells(), which
+   * Layer<EsdfCachingVoxel>::cacheTrilinearCells() calls, null otherwise.
+   */
+  const TrilinearCell* trilinear_cells() const {
+    return trilinear_cells_.get();
+  }
+  TrilinearCell* trilinear_cells() { return trilinear_cells_.get(); }
+  /// Allocates the trilinear cells if they are not allocated yet.
+  TrilinearCell* allocateTrilinearCells() {
+    if (!trilinear_cells_) {
+      trilinear_cells_.reset(new TrilinearCell[num_voxels_]);
+    }
+    return trilinear_cells_.get();
+  }
+
   // Serialization.
   void getProto(BlockProto* proto) const;
   void serializeToIntegers(std::vector<uint32_t>* data) const;
@@ -189,6 +207,7 @@ class Block {
 
  protected:
   std::unique_ptr<VoxelType[]> voxels_;
+  std::unique_ptr<TrilinearCell[]> trilinear_cells_;
 
   // Derived, cached parameters.
   size_t num_voxels_;
@@ -9,6 +9,7 @@
 #include <Eigen/Core>
 
 #include "voxblox/core/common.h"
+#include "voxblox/core/flat_index_hash_map.h"
 
 namespace voxblox {
 
@@ -40,6 +41,19 @@ struct AnyIndexHashMapType {
       type;
 };
 
+/**
+ * Map of the blocks of a layer. Uses the open addressing FlatIndexHashMap,
+ * define VOXBLOX_NODE_BASED_BLOCK_MAP to go back to std::unordered_map.
+ */
+template <typename ValueType>
+struct BlockHashMapType {
+#ifdef VOXBLOX_NODE_BASED_BLOCK_MAP
+  typedef typename AnyIndexHashMapType<ValueType>::type type;
+#else
+  typedef FlatIndexHashMap<ValueType> type;
+#endif
+};
+
 typedef std::unordered_set<AnyIndex, AnyIndexHash, std::equal_to<AnyIndex>,
                            Eigen::aligned_allocator<AnyIndex> >
     IndexSet;
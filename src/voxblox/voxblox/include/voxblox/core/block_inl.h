@@ -146,6 +146,9 @@ size_t Block<VoxelType>::getMemorySize() const {
   if (num_voxels_ > 0u) {
     size += (num_voxels_ * sizeof(voxels_[0]));
   }
+  if (trilinear_cells_) {
+    size += num_voxels_ * sizeof(TrilinearCell);
+  }
   return size;
 }
 
@@ -0,0 +1,209 @@
+#ifndef VOXBLOX_CORE_COMPACT_ESDF_LAYER_H_
+#define VOXBLOX_CORE_COMPACT_ESDF_LAYER_H_
+
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "voxblox/core/block_hash.h"
+#include "voxblox/core/common.h"
+#include "voxblox/core/layer.h"
+#include "voxblox/core/voxel.h"
+
+namespace voxblox {
+
+/// Aligns every allocation to a cache line, so planes never share one.
+template <typename T>
+class CacheLineAlignedAllocator {
+ public:
+  typedef T value_type;
+  static constexpr size_t kCacheLineSize = 64u;
+
+  CacheLineAlignedAllocator() = default;
+  template <typename U>
+  CacheLineAlignedAllocator(const CacheLineAlignedAllocator<U>&) {}  // NOLINT
+
+  T* allocate(size_t n) {
+    if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+      throw std::bad_alloc();
+    }
+    // Over-allocate and keep the original pointer right before the aligned
+    // memory.
+    void* raw = std::malloc(n * sizeof(T) + kCacheLineSize + sizeof(void*));
+    if (raw == nullptr) {
+      throw std::bad_alloc();
+    }
+    const uintptr_t aligned =
+        (reinterpret_cast<uintptr_t>(raw) + sizeof(void*) + kCacheLineSize -
+         1u) &
+        ~static_cast<uintptr_t>(kCacheLineSize - 1u);
+    reinterpret_cast<void**>(aligned)[-1] = raw;
+    return reinterpret_cast<T*>(aligned);
+  }
+
+  void deallocate(T* ptr, size_t /*n*/) {
+    if (ptr != nullptr) {
+      std::free(reinterpret_cast<void**>(ptr)[-1]);
+    }
+  }
+
+  template <typename U>
+  bool operator==(const CacheLineAlignedAllocator<U>&) const {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const CacheLineAlignedAllocator<U>&) const {
+    return false;
+  }
+};
+
+/**
+ * Structure-of-arrays copy of a Block<EsdfCachingVoxel> that only keeps what
+ * the distance queries need: one contiguous plane for the distances, each
+ * gradient component and optionally each of the 6 hessian entries. Like the
+ * caching interpolator, the queries do not look at the observed flags, so they
+ * are not stored. Gradients can be stored in half precision.
+ */
+class CompactEsdfBlock {
+ public:
+  typedef std::shared_ptr<const CompactEsdfBlock> ConstPtr;
+  template <typename T>
+  using Plane = std::vector<T, CacheLineAlignedAllocator<T>>;
+
+  CompactEsdfBlock(const Block<EsdfCachingVoxel>& block,
+                   bool half_precision_gradients, bool with_hessians);
+
+  size_t num_voxels() const { return num_voxels_; }
+  bool has_hessians() const { return !hessians_[0].empty(); }
+
+  /// Same truncation as Block::computeTruncatedVoxelIndexFromCoordinates().
+  inline size_t computeLinearIndexFromCoordinates(const Point& coords,
+                                                  Point* voxel_offset) const {
+    const IndexElement max_value = voxels_per_side_ - 1;
+    VoxelIndex voxel_index =
+        getGridIndexFromPoint<VoxelIndex>(coords - origin_, voxel_size_inv_);
+    voxel_index = voxel_index.cwiseMin(max_value).cwiseMax(0);
+    *voxel_offset = coords - origin_ -
+                    getCenterPointFromGridIndex(voxel_index, voxel_size_);
+    return static_cast<size_t>(
+        voxel_index.x() +
+        voxels_per_side_ *
+            (voxel_index.y() + voxel_index.z() * voxels_per_side_));
+  }
+
+  inline FloatingPoint distance(size_t linear_index) const {
+    return distances_[linear_index];
+  }
+  inline Point gradient(size_t linear_index) const {
+    if (half_gradients_[0].empty()) {
+      return Point(gradients_[0][linear_index], gradients_[1][linear_index],
+                   gradients_[2][linear_index]);
+    }
+    return Point(static_cast<float>(half_gradients_[0][linear_index]),
+                 static_cast<float>(half_gradients_[1][linear_index]),
+                 static_cast<float>(half_gradients_[2][linear_index]));
+  }
+  /// Compact symmetric layout of EsdfCachingVoxel::hessian.
+  inline Eigen::Matrix<float, 6, 1> hessian(size_t linear_index) const {
+    Eigen::Matrix<float, 6, 1> hessian;
+    for (int i = 0; i < 6; ++i) {
+      hessian(i) = hessians_[i][linear_index];
+    }
+    return hessian;
+  }
+
+  size_t getMemorySize() const;
+
+ private:
+  const size_t voxels_per_side_;
+  const size_t num_voxels_;
+  const FloatingPoint voxel_size_;
+  const FloatingPoint voxel_size_inv_;
+  const Point origin_;
+
+  Plane<float> distances_;
+  /// Only one of the two gradient representations is filled.
+  Plane<float> gradients_[3];
+  Plane<Eigen::half> half_gradients_[3];
+  Plane<float> hessians_[6];
+};
+
+/**
+ * Read-only ESDF layer in the compact block layout. Copies share all blocks,
+ * updateBlocks() only replaces the blocks it converts, so a copy can be
+ * updated while the original is still being read.
+ */
+class CompactEsdfLayer {
+ public:
+  typedef std::shared_ptr<const CompactEsdfLayer> ConstPtr;
+  typedef Eigen::Matrix<FloatingPoint, Eigen::Dynamic, 1> DistanceVector;
+  typedef Eigen::Matrix<bool, Eigen::Dynamic, 1> ValidityVector;
+  typedef Eigen::Matrix<FloatingPoint, 6, Eigen::Dynamic> SymmetricMatrices;
+
+  CompactEsdfLayer(FloatingPoint voxel_size, size_t voxels_per_side,
+                   bool half_precision_gradients, bool with_hessians);
+
+  FloatingPoint voxel_size() const { return voxel_size_; }
+  size_t voxels_per_side() const { return voxels_per_side_; }
+  bool has_hessians() const { return with_hessians_; }
+
+  /// Converts the given blocks of the caching layer, replacing old versions.
+  void updateBlocks(const Layer<EsdfCachingVoxel>& layer,
+                    const BlockIndexList& blocks);
+  /// Converts all blocks of the caching layer.
+  void updateAllBlocks(const Layer<EsdfCachingVoxel>& layer);
+
+  void removeBlock(const BlockIndex& index) { block_map_.erase(index); }
+  bool hasBlock(const BlockIndex& index) const {
+    return block_map_.count(index) > 0u;
+  }
+  CompactEsdfBlock::ConstPtr getBlockPtrByIndex(const BlockIndex& index) const;
+  size_t getNumberOfAllocatedBlocks() const { return block_map_.size(); }
+  size_t getMemorySize() const;
+
+  /**
+   * Same semantics as
+   * Interpolator<EsdfCachingVoxel>::getInterpolatedDistancesGradients().
+   */
+  size_t getInterpolatedDistancesGradients(const PointsMatrix& positions,
+                                           DistanceVector* distances,
+                                           PointsMatrix* gradients,
+                                           ValidityVector* valid) const;
+
+  /**
+   * Same semantics as Interpolator<EsdfCachingVoxel>::
+   * getInterpolatedDistancesGradientsFromHessians(). Requires has_hessians().
+   */
+  size_t getInterpolatedDistancesGradientsFromHessians(
+      const PointsMatrix& positions, DistanceVector* distances,
+      PointsMatrix* gradients, SymmetricMatrices* hessians,
+      ValidityVector* valid) const;
+
+ private:
+  typedef BlockHashMapType<CompactEsdfBlock::ConstPtr>::type BlockHashMap;
+
+  /// Shared kernel of the two queries, hessians is ignored without them.
+  template <bool kWithHessians>
+  size_t queryDistancesGradients(const PointsMatrix& positions,
+                                 DistanceVector* distances,
+                                 PointsMatrix* gradients,
+                                 SymmetricMatrices* hessians,
+                                 ValidityVector* valid) const;
+
+  FloatingPoint voxel_size_;
+  size_t voxels_per_side_;
+  FloatingPoint block_size_inv_;
+  bool half_precision_gradients_;
+  bool with_hessians_;
+
+  BlockHashMap block_map_;
+};
+
+}  // namespace voxblox
+
+#endif  // VOXBLOX_CORE_COMPACT_ESDF_LAYER_H_
@@ -0,0 +1,177 @@
+#ifndef VOXBLOX_CORE_ESDF_WINDOW_H_
+#define VOXBLOX_CORE_ESDF_WINDOW_H_
+
+#include <memory>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "voxblox/core/common.h"
+#include "voxblox/core/layer.h"
+#include "voxblox/core/voxel.h"
+
+namespace voxblox {
+
+/**
+ * Dense copy of the distances and gradients of an ESDF caching layer in a
+ * cube of side_voxels^3 voxels around a moving center, e.g. the robot base.
+ * Queries inside the cube index an array directly instead of hashing block
+ * indices, so their cost does not depend on the size of the map.
+ *
+ * The cube is stored toroidally: the voxel with global index g lives in slot
+ * g mod side_voxels along every axis. Moving the window only copies the slabs
+ * of voxels that enter it, the voxels that stay in the window stay in place.
+ *
+ * The slots are grouped into bricks of kBrickVoxels^3 voxels that are shared
+ * between copies of a window and only duplicated when a copy writes them. A
+ * copy that is moved by a few voxels or updated in a few blocks therefore
+ * only allocates the bricks it changed, the original stays untouched.
+ */
+class EsdfWindow {
+ public:
+  typedef std::shared_ptr<const EsdfWindow> ConstPtr;
+  typedef Eigen::Matrix<FloatingPoint, Eigen::Dynamic, 1> DistanceVector;
+  typedef Eigen::Matrix<bool, Eigen::Dynamic, 1> ValidityVector;
+
+  EsdfWindow(FloatingPoint voxel_size, size_t side_voxels);
+
+  FloatingPoint voxel_size() const { return voxel_size_; }
+  size_t side_voxels() const { return side_voxels_; }
+  /// Global index of the voxel in the lower corner of the window.
+  const GlobalIndex& origin() const { return origin_; }
+  /// Center of the voxel the window was last centered on.
+  Point center() const {
+    return getCenterPointFromGridIndex(
+        origin_ + GlobalIndex::Constant(side_voxels_ / 2), voxel_size_);
+  }
+  /// False until the first call to moveTo().
+  bool initialized() const { return initialized_; }
+
+  /// Whether pos falls into a voxel of the window.
+  bool contains(const Point& pos) const {
+    return initialized_ && isInWindow(getGlobalIndex(pos));
+  }
+
+  /**
+   * Centers the window on center and copies the voxels entering it from the
+   * layer. Copies the whole window on the first call or if it moved by more
+   * than its size.
+   */
+  void moveTo(const Layer<EsdfCachingVoxel>& layer, const Point& center);
+  /// Copies the voxels of the given blocks that lie in the window again.
+  void updateBlocks(const Layer<EsdfCachingVoxel>& layer,
+                    const BlockIndexList& blocks);
+  /// Copies all voxels of the window again.
+  void updateAll(const Layer<EsdfCachingVoxel>& layer);
+
+  /**
+   * Same semantics as
+   * Interpolator<EsdfCachingVoxel>::getInterpolatedDistancesGradients(), but
+   * positions outside of the window are invalid too.
+   */
+  size_t getInterpolatedDistancesGradients(const PointsMatrix& positions,
+                                           DistanceVector* distances,
+                                           PointsMatrix* gradients,
+                                           ValidityVector* valid) const;
+
+  /**
+   * Same semantics as
+   * Interpolator<EsdfCachingVoxel>::getTrilinearDistancesGradients(), but
+   * positions outside of the window are invalid too. There are no block
+   * seams in the window, the eight voxels of a cell are always indexed
+   * directly.
+   */
+  size_t getTrilinearDistancesGradients(const PointsMatrix& positions,
+                                        DistanceVector* distances,
+                                        PointsMatrix* gradients,
+                                        ValidityVector* valid) const;
+
+  /// Memory of all bricks, including the ones shared with other windows.
+  size_t getMemorySize() const;
+  /// Number of bricks whose storage this window shares with other.
+  size_t getNumSharedBricks(const EsdfWindow& other) const;
+
+ private:
+  /// A NaN distance marks voxels of unallocated blocks.
+  struct WindowVoxel {
+    float distance;
+    float gradient[3];
+  };
+  typedef std::vector<WindowVoxel> Brick;
+
+  /// Side length of a brick in voxels, a power of two.
+  static constexpr LongIndexElement kBrickVoxels = 8;
+  static constexpr int kBrickShift = 3;
+  static constexpr LongIndexElement kBrickMask = kBrickVoxels - 1;
+
+  inline GlobalIndex getGlobalIndex(const Point& pos) const {
+    return getGridIndexFromPoint<GlobalIndex>(pos, voxel_size_inv_);
+  }
+  inline bool isInWindow(const GlobalIndex& global_index) const {
+    const LongIndexElement side = static_cast<LongIndexElement>(side_voxels_);
+    const GlobalIndex local = global_index - origin_;
+    return local.x() >= 0 && local.x() < side && local.y() >= 0 &&
+           local.y() < side && local.z() >= 0 && local.z() < side;
+  }
+  /// Slot of a voxel along each axis, global_index % side_voxels.
+  inline GlobalIndex getSlot3(const GlobalIndex& global_index) const {
+    const LongIndexElement side = static_cast<LongIndexElement>(side_voxels_);
+    GlobalIndex slot = global_index - origin_ + phase_;
+    for (int dim = 0; dim < 3; ++dim) {
+      if (slot(dim) >= side) {
+        slot(dim) -= side;
+      }
+    }
+    return slot;
+  }
+  /// Index of the brick holding a slot along one axis, times its stride.
+  inline size_t getBrickTerm(LongIndexElement slot, int dim) const {
+    return static_cast<size_t>(slot >> kBrickShift) * brick_strides_[dim];
+  }
+  /// Index of a slot in its brick along one axis, times its stride.
+  static inline size_t getOffsetTerm(LongIndexElement slot, int dim) {
+    return static_cast<size_t>(slot & kBrickMask)
+           << (kBrickShift * static_cast<size_t>(dim));
+  }
+  inline const WindowVoxel& getVoxel(const GlobalIndex& global_index) const {
+    const GlobalIndex slot = getSlot3(global_index);
+    size_t brick = 0u;
+    size_t offset = 0u;
+    for (int dim = 0; dim < 3; ++dim) {
+      brick += getBrickTerm(slot(dim), dim);
+      offset += getOffsetTerm(slot(dim), dim);
+    }
+    return (*bricks_[brick])[offset];
+  }
+  /// Duplicates the brick of the voxel first if it is shared.
+  WindowVoxel& getMutableVoxel(const GlobalIndex& global_index);
+
+  /// Shared kernel of the two queries.
+  template <bool kTrilinear>
+  size_t queryDistancesGradients(const PointsMatrix& positions,
+                                 DistanceVector* distances,
+                                 PointsMatrix* gradients,
+                                 ValidityVector* valid) const;
+
+  /// Copies the voxels in [min_index, max_index), which must be in the window.
+  void copyBox(const Layer<EsdfCachingVoxel>& layer,
+               const GlobalIndex& min_index, const GlobalIndex& max_index);
+
+  FloatingPoint voxel_size_;
+  FloatingPoint voxel_size_inv_;
+  size_t side_voxels_;
+
+  bool initialized_;
+  GlobalIndex origin_;
+  /// origin_ % side_voxels_ per axis, the slot of the origin.
+  GlobalIndex phase_;
+
+  /// Bricks per axis and the strides of the brick index.
+  size_t bricks_per_side_;
+  size_t brick_strides_[3];
+  std::vector<std::shared_ptr<Brick>> bricks_;
+};
+
+}  // namespace voxblox
+
+#endif  // VOXBLOX_CORE_ESDF_WINDOW_H_
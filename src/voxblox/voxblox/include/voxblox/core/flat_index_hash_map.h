@@ -0,0 +1,269 @@
+#ifndef VOXBLOX_CORE_FLAT_INDEX_HASH_MAP_H_
+#define VOXBLOX_CORE_FLAT_INDEX_HASH_MAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+#include <glog/logging.h>
+
+#include "voxblox/core/common.h"
+
+namespace voxblox {
+
+/**
+ * Open addressing hash map from AnyIndex to ValueType with the subset of the
+ * std::unordered_map interface used for the blocks of a layer. Entries live in
+ * one contiguous array and collisions are resolved by linear probing, so a
+ * lookup touches one or two cache lines instead of following the bucket list
+ * of a node based map. Erasing uses backward shifting, no tombstones are left.
+ *
+ * Unlike std::unordered_map, inserting or erasing invalidates references to
+ * all entries, the key of value_type is not const and the iteration order is
+ * arbitrary.
+ */
+template <typename ValueType>
+class FlatIndexHashMap {
+ public:
+  typedef AnyIndex key_type;
+  typedef ValueType mapped_type;
+  typedef std::pair<AnyIndex, ValueType> value_type;
+  typedef size_t size_type;
+
+ private:
+  template <bool kConst>
+  class Iterator {
+   public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef typename FlatIndexHashMap::value_type value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef typename std::conditional<kConst, const value_type*,
+                                      value_type*>::type pointer;
+    typedef typename std::conditional<kConst, const value_type&,
+                                      value_type&>::type reference;
+    typedef typename std::conditional<kConst, const FlatIndexHashMap*,
+                                      FlatIndexHashMap*>::type MapPointer;
+
+    Iterator() : map_(nullptr), slot_(0u) {}
+    Iterator(MapPointer map, size_t slot) : map_(map), slot_(slot) {
+      skipEmptySlots();
+    }
+    /// Conversion from iterator to const_iterator.
+    template <bool kOtherConst,
+              typename = typename std::enable_if<kConst && !kOtherConst>::type>
+    Iterator(const Iterator<kOtherConst>& other)  // NOLINT
+        : map_(other.map_), slot_(other.slot_) {}
+
+    reference operator*() const { return map_->slots_[slot_]; }
+    pointer operator->() const { return &map_->slots_[slot_]; }
+
+    Iterator& operator++() {
+      ++slot_;
+      skipEmptySlots();
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator copy(*this);
+      ++(*this);
+      return copy;
+    }
+
+    bool operator==(const Iterator& other) const {
+      return slot_ == other.slot_;
+    }
+    bool operator!=(const Iterator& other) const {
+      return slot_ != other.slot_;
+    }
+
+   private:
+    friend class FlatIndexHashMap;
+    template <bool>
+    friend class Iterator;
+
+    void skipEmptySlots() {
+      while (slot_ < map_->occupied_.size() && !map_->occupied_[slot_]) {
+        ++slot_;
+      }
+    }
+
+    MapPointer map_;
+    size_t slot_;
+  };
+
+ public:
+  typedef Iterator<false> iterator;
+  typedef Iterator<true> const_iterator;
+
+  FlatIndexHashMap() : size_(0u), shift_(64u) {}
+
+  iterator begin() { return iterator(this, 0u); }
+  iterator end() { return iterator(this, occupied_.size()); }
+  const_iterator begin() const { return const_iterator(this, 0u); }
+  const_iterator end() const { return const_iterator(this, occupied_.size()); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  bool empty() const { return size_ == 0u; }
+  size_t size() const { return size_; }
+  size_t bucket_count() const { return occupied_.size(); }
+
+  iterator find(const AnyIndex& key) { return iterator(this, findSlot(key)); }
+  const_iterator find(const AnyIndex& key) const {
+    return const_iterator(this, findSlot(key));
+  }
+  size_t count(const AnyIndex& key) const {
+    return findSlot(key) != occupied_.size() ? 1u : 0u;
+  }
+
+  /**
+   * Inserts ValueType(args...) under key if the key does not exist yet.
+   * Returns the entry of the key and whether it was inserted.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(const AnyIndex& key, Args&&... args) {
+    const size_t existing_slot = findSlot(key);
+    if (existing_slot != occupied_.size()) {
+      return std::make_pair(iterator(this, existing_slot), false);
+    }
+    if (2u * (size_ + 1u) > occupied_.size()) {
+      rehash(occupied_.empty() ? kMinCapacity : 2u * occupied_.size());
+    }
+    const size_t slot = findEmptySlot(key);
+    slots_[slot].first = key;
+    slots_[slot].second = ValueType(std::forward<Args>(args)...);
+    occupied_[slot] = 1u;
+    ++size_;
+    return std::make_pair(iterator(this, slot), true);
+  }
+
+  template <typename PairType>
+  std::pair<iterator, bool> insert(const PairType& key_value_pair) {
+    return emplace(key_value_pair.first, key_value_pair.second);
+  }
+
+  ValueType& operator[](const AnyIndex& key) {
+    return emplace(key).first->second;
+  }
+
+  size_t erase(const AnyIndex& key) {
+    size_t slot = findSlot(key);
+    if (slot == occupied_.size()) {
+      return 0u;
+    }
+    // Shift the following entries of the probe sequence back into the gap,
+    // unless that would move them in front of their home slot.
+    const size_t mask = occupied_.size() - 1u;
+    for (size_t next = (slot + 1u) & mask; occupied_[next];
+         next = (next + 1u) & mask) {
+      const size_t home = homeSlot(slots_[next].first);
+      if (((next - home) & mask) >= ((next - slot) & mask)) {
+        slots_[slot] = std::move(slots_[next]);
+        slot = next;
+      }
+    }
+    slots_[slot] = value_type();
+    occupied_[slot] = 0u;
+    --size_;
+    return 1u;
+  }
+
+  /// Removes all entries but keeps the capacity.
+  void clear() {
+    for (size_t slot = 0u; slot < occupied_.size(); ++slot) {
+      if (occupied_[slot]) {
+        slots_[slot] = value_type();
+        occupied_[slot] = 0u;
+      }
+    }
+    size_ = 0u;
+  }
+
+  void reserve(size_t num_entries) {
+    size_t capacity = kMinCapacity;
+    while (capacity < 2u * num_entries) {
+      capacity *= 2u;
+    }
+    if (capacity > occupied_.size()) {
+      rehash(capacity);
+    }
+  }
+
+ private:
+  static constexpr size_t kMinCapacity = 16u;
+
+  /// Multiplicative hash of the coordinates, the top bits select the slot.
+  size_t homeSlot(const AnyIndex& key) const {
+    const uint64_t hash =
+        static_cast<uint64_t>(static_cast<uint32_t>(key.x())) *
+            0x9E3779B97F4A7C15ull +
+        static_cast<uint64_t>(static_cast<uint32_t>(key.y())) *
+            0xC2B2AE3D27D4EB4Full +
+        static_cast<uint64_t>(static_cast<uint32_t>(key.z())) *
+            0x165667B19E3779F9ull;
+    return static_cast<size_t>(hash >> shift_);
+  }
+
+  /// Returns the slot of key, or the capacity if it does not exist.
+  size_t findSlot(const AnyIndex& key) const {
+    if (size_ == 0u) {
+      return occupied_.size();
+    }
+    const size_t mask = occupied_.size() - 1u;
+    for (size_t slot = homeSlot(key); occupied_[slot];
+         slot = (slot + 1u) & mask) {
+      if (slots_[slot].first == key) {
+        return slot;
+      }
+    }
+    return occupied_.size();
+  }
+
+  size_t findEmptySlot(const AnyIndex& key) const {
+    const size_t mask = occupied_.size() - 1u;
+    size_t slot = homeSlot(key);
+    while (occupied_[slot]) {
+      slot = (slot + 1u) & mask;
+    }
+    return slot;
+  }
+
+  void rehash(size_t capacity) {
+    DCHECK_EQ(capacity & (capacity - 1u), 0u);
+    DCHECK_GE(capacity, 2u * size_);
+    std::vector<value_type, Eigen::aligned_allocator<value_type> > old_slots(
+        capacity);
+    std::vector<uint8_t> old_occupied(capacity, 0u);
+    old_slots.swap(slots_);
+    old_occupied.swap(occupied_);
+
+    shift_ = 64u;
+    for (size_t c = capacity; c > 1u; c /= 2u) {
+      --shift_;
+    }
+    for (size_t slot = 0u; slot < old_occupied.size(); ++slot) {
+      if (old_occupied[slot]) {
+        const size_t new_slot = findEmptySlot(old_slots[slot].first);
+        slots_[new_slot] = std::move(old_slots[slot]);
+        occupied_[new_slot] = 1u;
+      }
+    }
+  }
+
+  std::vector<value_type, Eigen::aligned_allocator<value_type> > slots_;
+  /// Kept apart from the slots, so probing reads a dense byte array.
+  std::vector<uint8_t> occupied_;
+  size_t size_;
+  /// 64 - log2(capacity).
+  size_t shift_;
+};
+
+template <typename ValueType>
+constexpr size_t FlatIndexHashMap<ValueType>::kMinCapacity;
+
+}  // namespace voxblox
+
+#endif  // VOXBLOX_CORE_FLAT_INDEX_HASH_MAP_H_
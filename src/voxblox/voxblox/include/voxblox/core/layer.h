@@ -4,6 +4,7 @@
 #include <glog/logging.h>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 
 #include "./Block.pb.h"
@@ -26,8 +27,7 @@ class Layer {
 
   typedef std::shared_ptr<Layer> Ptr;
   typedef Block<VoxelType> BlockType;
-  typedef
-      typename AnyIndexHashMapType<typename BlockType::Ptr>::type BlockHashMap;
+  typedef typename BlockHashMapType<typename BlockType::Ptr>::type BlockHashMap;
   typedef typename std::pair<BlockIndex, typename BlockType::Ptr> BlockMapPair;
 
   explicit Layer(FloatingPoint voxel_size, size_t voxels_per_side)
@@ -112,6 +112,40 @@ class Layer {
     return getBlockPtrByIndex(computeBlockIndexFromCoordinates(coords));
   }
 
+  /**
+   * Borrowed pointer to the block, nullptr if it is not allocated. Unlike the
+   * shared pointer getters this leaves the reference count of the block
+   * untouched, so concurrent readers don't contend on it. The pointer is only
+   * valid as long as the block stays in the layer, i.e. the layer must not be
+   * modified while it is in use.
+   */
+  inline const BlockType* getBlockRawPtrByIndex(const BlockIndex& index) const {
+    typename BlockHashMap::const_iterator it = block_map_.find(index);
+    if (it != block_map_.end()) {
+      return it->second.get();
+    } else {
+      return nullptr;
+    }
+  }
+
+  inline BlockType* getBlockRawPtrByIndex(const BlockIndex& index) {
+    typename BlockHashMap::iterator it = block_map_.find(index);
+    if (it != block_map_.end()) {
+      return it->second.get();
+    } else {
+      return nullptr;
+    }
+  }
+
+  inline const BlockType* getBlockRawPtrByCoordinates(
+      const Point& coords) const {
+    return getBlockRawPtrByIndex(computeBlockIndexFromCoordinates(coords));
+  }
+
+  inline BlockType* getBlockRawPtrByCoordinates(const Point& coords) {
+    return getBlockRawPtrByIndex(computeBlockIndexFromCoordinates(coords));
+  }
+
   /**
    * Gets a block by the coordinates it if already exists,
    * otherwise allocates a new one.
@@ -150,9 +184,7 @@ class Layer {
     return allocateNewBlock(computeBlockIndexFromCoordinates(coords));
   }
 
-  inline void insertBlock(
-      const std::pair<const BlockIndex, typename Block<VoxelType>::Ptr>&
-          block_pair) {
+  inline void insertBlock(const BlockMapPair& block_pair) {
     auto insert_status = block_map_.insert(block_pair);
 
     DCHECK(insert_status.second) << "Block already exists when inserting at "
@@ -170,8 +202,7 @@ class Layer {
 
   void removeDistantBlocks(const Point& center, const double max_distance) {
     AlignedVector<BlockIndex> needs_erasing;
-    for (const std::pair<const BlockIndex, typename BlockType::Ptr>& kv :
-         block_map_) {
+    for (const typename BlockHashMap::value_type& kv : block_map_) {
       if ((kv.second->origin() - center).squaredNorm() >
           max_distance * max_distance) {
         needs_erasing.push_back(kv.first);
@@ -186,8 +217,7 @@ class Layer {
     CHECK_NOTNULL(blocks);
     blocks->clear();
     blocks->reserve(block_map_.size());
-    for (const std::pair<const BlockIndex, typename BlockType::Ptr>& kv :
-         block_map_) {
+    for (const typename BlockHashMap::value_type& kv : block_map_) {
       blocks->emplace_back(kv.first);
     }
   }
@@ -195,8 +225,7 @@ class Layer {
   void getAllUpdatedBlocks(Update::Status bit, BlockIndexList* blocks) const {
     CHECK_NOTNULL(blocks);
     blocks->clear();
-    for (const std::pair<const BlockIndex, typename BlockType::Ptr>& kv :
-         block_map_) {
+    for (const typename BlockHashMap::value_type& kv : block_map_) {
       if (kv.second->updated()[bit]) {
         blocks->emplace_back(kv.first);
       }
@@ -217,31 +246,31 @@ class Layer {
       const GlobalIndex& global_voxel_index) const {
     const BlockIndex block_index = getBlockIndexFromGlobalVoxelIndex(
         global_voxel_index, voxels_per_side_inv_);
-    if (!hasBlock(block_index)) {
+    const Block<VoxelType>* block_ptr = getBlockRawPtrByIndex(block_index);
+    if (block_ptr == nullptr) {
       return nullptr;
     }
     const VoxelIndex local_voxel_index =
         getLocalFromGlobalVoxelIndex(global_voxel_index, voxels_per_side_);
-    const Block<VoxelType>& block = getBlockByIndex(block_index);
-    return &block.getVoxelByVoxelIndex(local_voxel_index);
+    return &block_ptr->getVoxelByVoxelIndex(local_voxel_index);
   }
 
   inline VoxelType* getVoxelPtrByGlobalIndex(
       const GlobalIndex& global_voxel_index) {
     const BlockIndex block_index = getBlockIndexFromGlobalVoxelIndex(
         global_voxel_index, voxels_per_side_inv_);
-    if (!hasBlock(block_index)) {
+    Block<VoxelType>* block_ptr = getBlockRawPtrByIndex(block_index);
+    if (block_ptr == nullptr) {
       return nullptr;
     }
     const VoxelIndex local_voxel_index =
         getLocalFromGlobalVoxelIndex(global_voxel_index, voxels_per_side_);
-    Block<VoxelType>& block = getBlockByIndex(block_index);
-    return &block.getVoxelByVoxelIndex(local_voxel_index);
+    return &block_ptr->getVoxelByVoxelIndex(local_voxel_index);
   }
 
   inline const VoxelType* getVoxelPtrByCoordinates(const Point& coords) const {
-    typename Block<VoxelType>::ConstPtr block_ptr =
-        getBlockPtrByIndex(computeBlockIndexFromCoordinates(coords));
+    const Block<VoxelType>* block_ptr =
+        getBlockRawPtrByIndex(computeBlockIndexFromCoordinates(coords));
     if (!block_ptr) {
       return nullptr;
     }
@@ -249,8 +278,8 @@ class Layer {
   }
 
   inline VoxelType* getVoxelPtrByCoordinates(const Point& coords) {
-    typename Block<VoxelType>::Ptr block_ptr =
-        getBlockPtrByIndex(computeBlockIndexFromCoordinates(coords));
+    Block<VoxelType>* block_ptr =
+        getBlockRawPtrByIndex(computeBlockIndexFromCoordinates(coords));
     if (!block_ptr) {
       return nullptr;
     }
@@ -281,8 +310,37 @@ class Layer {
 
   size_t getMemorySize() const;
 
-  void cacheGradients();
-  void cacheHessians();
+  /**
+   * Precomputes the central difference gradient of all voxels in the given
+   * blocks and in their allocated neighbor blocks, whose border voxels depend
+   * on the given blocks. The blocks are distributed over num_threads threads.
+   */
+  void cacheGradients(const BlockIndexList& blocks,
+                      size_t num_threads = std::thread::hardware_concurrency());
+  /// Precomputes the gradients of all allocated blocks.
+  void cacheGradients(
+      size_t num_threads = std::thread::hardware_concurrency());
+  /**
+   * Precomputes the hessians of the given blocks and their allocated neighbors
+   * from the cached gradients, which therefore have to be up to date.
+   */
+  void cacheHessians(const BlockIndexList& blocks,
+                     size_t num_threads = std::thread::hardware_concurrency());
+  /// Precomputes the hessians of all allocated blocks.
+  void cacheHessians(size_t num_threads = std::thread::hardware_concurrency());
+  /**
+   * Stores the distances of the eight voxels of every trilinear cell in the
+   * trilinear cells of the block of the voxel at its lower corner, for the
+   * given blocks and their allocated neighbors. The cells at the upper border
+   * of a block reach into the next blocks. Allocates the cells of the blocks
+   * on the first call, the voxels themselves stay unchanged.
+   */
+  void cacheTrilinearCells(
+      const BlockIndexList& blocks,
+      size_t num_threads = std::thread::hardware_concurrency());
+  /// Precomputes the trilinear cells of all allocated blocks.
+  void cacheTrilinearCells(
+      size_t num_threads = std::thread::hardware_concurrency());
 
  protected:
   FloatingPoint voxel_size_;
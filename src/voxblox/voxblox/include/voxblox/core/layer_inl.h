@@ -116,7 +116,7 @@ bool Layer<VoxelType>::saveSubsetToFile(const std::string& file_path,
   size_t num_blocks_to_write = 0u;
   if ((include_all_blocks && !block_map_.empty()) ||
       !blocks_to_include.empty()) {
-    for (const BlockMapPair& pair : block_map_) {
+    for (const typename BlockHashMap::value_type& pair : block_map_) {
       bool write_block_to_file = include_all_blocks;
 
       if (!write_block_to_file) {
@@ -167,7 +167,7 @@ bool Layer<VoxelType>::saveBlocksToStream(bool include_all_blocks,
                                           BlockIndexList blocks_to_include,
                                           std::fstream* outfile_ptr) const {
   CHECK_NOTNULL(outfile_ptr);
-  for (const BlockMapPair& pair : block_map_) {
+  for (const typename BlockHashMap::value_type& pair : block_map_) {
     bool write_block_to_file = include_all_blocks;
     if (!write_block_to_file) {
       BlockIndexList::const_iterator it = std::find(
@@ -295,10 +295,25 @@ std::string Layer<VoxelType>::getType() const {
 }
 
 template <>
-void Layer<EsdfCachingVoxel>::cacheGradients();
+void Layer<EsdfCachingVoxel>::cacheGradients(const BlockIndexList& blocks,
+                                             size_t num_threads);
 
 template <>
-void Layer<EsdfCachingVoxel>::cacheHessians();
+void Layer<EsdfCachingVoxel>::cacheGradients(size_t num_threads);
+
+template <>
+void Layer<EsdfCachingVoxel>::cacheHessians(const BlockIndexList& blocks,
+                                            size_t num_threads);
+
+template <>
+void Layer<EsdfCachingVoxel>::cacheHessians(size_t num_threads);
+
+template <>
+void Layer<EsdfCachingVoxel>::cacheTrilinearCells(const BlockIndexList& blocks,
+                                                  size_t num_threads);
+
+template <>
+void Layer<EsdfCachingVoxel>::cacheTrilinearCells(size_t num_threads);
 
 }  // namespace voxblox
 
@@ -44,11 +44,41 @@ struct EsdfCachingVoxel : EsdfVoxel {
   }
 
   Eigen::Vector3f gradient = Eigen::Vector3f::Zero();
-  Eigen::Matrix3f hessian = Eigen::Matrix3f::Zero();
+  /// False if the gradient could not be computed and was set to zero.
+  bool gradient_valid = false;
+  /// Upper triangle of the symmetric hessian: xx, xy, xz, yy, yz, zz.
+  Eigen::Matrix<float, 6, 1> hessian = Eigen::Matrix<float, 6, 1>::Zero();
+
+  Eigen::Matrix3f getHessian() const {
+    Eigen::Matrix3f full_hessian;
+    full_hessian << hessian(0), hessian(1), hessian(2), hessian(1), hessian(3),
+        hessian(4), hessian(2), hessian(4), hessian(5);
+    return full_hessian;
+  }
+
+  /// Stores the symmetric part of full_hessian.
+  void setHessian(const Eigen::Matrix3f& full_hessian) {
+    hessian << full_hessian(0, 0),
+        0.5f * (full_hessian(0, 1) + full_hessian(1, 0)),
+        0.5f * (full_hessian(0, 2) + full_hessian(2, 0)), full_hessian(1, 1),
+        0.5f * (full_hessian(1, 2) + full_hessian(2, 1)), full_hessian(2, 2);
+  }
 
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 };
 
+/**
+ * Distances of the eight voxels of the trilinear cell with a voxel in its
+ * lower corner, see CellCorners. Not part of the voxel, the blocks store them
+ * in a separate array, see Block::trilinear_cells(). Only valid if valid,
+ * which is false if one of them lies in an unallocated block.
+ */
+struct TrilinearCell {
+  Eigen::Array<float, 8, 1, Eigen::DontAlign> corners =
+      Eigen::Array<float, 8, 1, Eigen::DontAlign>::Zero();
+  bool valid = false;
+};
+
 struct OccupancyVoxel {
   float probability_log = 0.0f;
   bool observed = false;
@@ -64,6 +94,8 @@ namespace voxel_types {
 const std::string kNotSerializable = "not_serializable";
 const std::string kTsdf = "tsdf";
 const std::string kEsdf = "esdf";
+/// ESDF layer messages whose blocks are encoded with compressEsdfBlock().
+const std::string kCompressedEsdf = "esdf_compressed";
 const std::string kOccupancy = "occupancy";
 const std::string kIntensity = "intensity";
 }  // namespace voxel_types
@@ -129,6 +129,23 @@ class EsdfIntegrator {
    */
   bool updateVoxelFromNeighbors(const GlobalIndex& global_index);
 
+  /**
+   * Voxel at a global index of the ESDF layer, whose block gets flagged with
+   * Update::kMap. Every voxel that the queues change is popped again, so
+   * looking up popped voxels through this marks all blocks the propagation
+   * touched for the next incremental map message.
+   */
+  inline EsdfVoxel* getChangedVoxelPtr(const GlobalIndex& global_index) {
+    Block<EsdfVoxel>* block_ptr = esdf_layer_->getBlockRawPtrByIndex(
+        getBlockIndexFromGlobalVoxelIndex(global_index, voxels_per_side_inv_));
+    if (block_ptr == nullptr) {
+      return nullptr;
+    }
+    block_ptr->updated().set(Update::kMap);
+    return &block_ptr->getVoxelByVoxelIndex(
+        getLocalFromGlobalVoxelIndex(global_index, voxels_per_side_));
+  }
+
   // Convenience functions.
   inline bool isFixed(FloatingPoint dist_m) const {
     return std::abs(dist_m) < config_.min_distance_m;
@@ -172,6 +189,7 @@ class EsdfIntegrator {
   AlignedQueue<GlobalIndex> raise_;
 
   size_t voxels_per_side_;
+  FloatingPoint voxels_per_side_inv_;
   FloatingPoint voxel_size_;
 
   IndexSet updated_blocks_;
@@ -18,6 +18,10 @@ class Interpolator {
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 
   typedef std::shared_ptr<Interpolator> Ptr;
+  typedef Eigen::Matrix<FloatingPoint, Eigen::Dynamic, 1> DistanceVector;
+  typedef Eigen::Matrix<bool, Eigen::Dynamic, 1> ValidityVector;
+  /// Columns in the compact layout of EsdfCachingVoxel::hessian.
+  typedef Eigen::Matrix<FloatingPoint, 6, Eigen::Dynamic> SymmetricMatrices;
 
   explicit Interpolator(const Layer<VoxelType>* layer);
 
@@ -37,6 +41,66 @@ class Interpolator {
   bool getInterpolatedDistanceGradientFromHessian(
       const Point& pos, FloatingPoint* distance, Point* gradient) const;
 
+  /**
+   * Batched version of getInterpolatedDistanceGradient() for all columns of
+   * positions. Points that fall into the same block share a single block
+   * lookup. The outputs are only resized if their size does not match, so
+   * reusing them across calls makes the query allocation free. valid(i) is
+   * false if point i lies outside of the allocated blocks.
+   * Returns the number of valid points.
+   */
+  size_t getInterpolatedDistancesGradients(const PointsMatrix& positions,
+                                           DistanceVector* distances,
+                                           PointsMatrix* gradients,
+                                           ValidityVector* valid) const;
+
+  /**
+   * Second order version of getInterpolatedDistancesGradients(), which
+   * expands distance and gradient with the cached hessian of the nearest
+   * voxel. The hessians are returned in the compact symmetric layout.
+   */
+  size_t getInterpolatedDistancesGradientsFromHessians(
+      const PointsMatrix& positions, DistanceVector* distances,
+      PointsMatrix* gradients, SymmetricMatrices* hessians,
+      ValidityVector* valid) const;
+
+  /**
+   * Trilinear interpolation of the distances of the eight voxels around pos.
+   * Unlike getInterpolatedDistanceGradient(), the distance is continuous
+   * across voxel borders and the gradient is its exact derivative. Falls back
+   * to getInterpolatedDistanceGradient() where some of the eight voxels lie
+   * in unallocated blocks.
+   */
+  bool getTrilinearDistanceGradient(const Point& pos, FloatingPoint* distance,
+                                    Point* gradient) const;
+
+  /**
+   * Batched version of getTrilinearDistanceGradient(), with the conventions
+   * of getInterpolatedDistancesGradients().
+   */
+  size_t getTrilinearDistancesGradients(const PointsMatrix& positions,
+                                        DistanceVector* distances,
+                                        PointsMatrix* gradients,
+                                        ValidityVector* valid) const;
+
+  /**
+   * Same result as getTrilinearDistanceGradient(), but reads the eight
+   * distances from the cell cached for the voxel at its lower corner, so every
+   * query touches a single cell. Requires Layer::cacheTrilinearCells().
+   */
+  bool getTrilinearDistanceGradientFromCell(const Point& pos,
+                                            FloatingPoint* distance,
+                                            Point* gradient) const;
+
+  /**
+   * Batched version of getTrilinearDistanceGradientFromCell(), with the
+   * conventions of getInterpolatedDistancesGradients().
+   */
+  size_t getTrilinearDistancesGradientsFromCells(const PointsMatrix& positions,
+                                                 DistanceVector* distances,
+                                                 PointsMatrix* gradients,
+                                                 ValidityVector* valid) const;
+
   bool getVoxel(const Point& pos, VoxelType* voxel,
                 bool interpolate = false) const;
 
@@ -38,6 +38,36 @@ template <>
 bool Interpolator<EsdfCachingVoxel>::getInterpolatedGradient(const Point& pos,
                                                       Point* grad) const;
 
+template <>
+size_t Interpolator<EsdfCachingVoxel>::getInterpolatedDistancesGradients(
+    const PointsMatrix& positions, DistanceVector* distances,
+    PointsMatrix* gradients, ValidityVector* valid) const;
+
+template <>
+size_t
+Interpolator<EsdfCachingVoxel>::getInterpolatedDistancesGradientsFromHessians(
+    const PointsMatrix& positions, DistanceVector* distances,
+    PointsMatrix* gradients, SymmetricMatrices* hessians,
+    ValidityVector* valid) const;
+
+template <>
+bool Interpolator<EsdfCachingVoxel>::getTrilinearDistanceGradient(
+    const Point& pos, FloatingPoint* distance, Point* gradient) const;
+
+template <>
+size_t Interpolator<EsdfCachingVoxel>::getTrilinearDistancesGradients(
+    const PointsMatrix& positions, DistanceVector* distances,
+    PointsMatrix* gradients, ValidityVector* valid) const;
+
+template <>
+bool Interpolator<EsdfCachingVoxel>::getTrilinearDistanceGradientFromCell(
+    const Point& pos, FloatingPoint* distance, Point* gradient) const;
+
+template <>
+size_t Interpolator<EsdfCachingVoxel>::getTrilinearDistancesGradientsFromCells(
+    const PointsMatrix& positions, DistanceVector* distances,
+    PointsMatrix* gradients, ValidityVector* valid) const;
+
 template <typename VoxelType>
 bool Interpolator<VoxelType>::getVoxel(const Point& pos, VoxelType* voxel,
                                        bool interpolate) const {
@@ -53,8 +83,8 @@ bool Interpolator<VoxelType>::getGradient(const Point& pos, Point* grad,
                                           const bool interpolate) const {
   CHECK_NOTNULL(grad);
 
-  typename Layer<VoxelType>::BlockType::ConstPtr block_ptr =
-      layer_->getBlockPtrByCoordinates(pos);
+  const typename Layer<VoxelType>::BlockType* block_ptr =
+      layer_->getBlockRawPtrByCoordinates(pos);
   if (block_ptr == nullptr) {
     return false;
   }
@@ -85,8 +115,8 @@ bool Interpolator<VoxelType>::getHessian(
     const bool interpolate) const {
   CHECK_NOTNULL(hess);
 
-  typename Layer<VoxelType>::BlockType::ConstPtr block_ptr =
-      layer_->getBlockPtrByCoordinates(pos);
+  const typename Layer<VoxelType>::BlockType* block_ptr =
+      layer_->getBlockRawPtrByCoordinates(pos);
   if (block_ptr == nullptr) {
     return false;
   }
@@ -133,8 +163,8 @@ bool Interpolator<VoxelType>::getAdaptiveDistanceAndGradient(
   // Now try to estimate the gradient. Same general procedure as getGradient()
   // above, but also allow finite difference methods other than central
   // difference (left difference, right difference).
-  typename Layer<VoxelType>::BlockType::ConstPtr block_ptr =
-      layer_->getBlockPtrByCoordinates(pos);
+  const typename Layer<VoxelType>::BlockType* block_ptr =
+      layer_->getBlockRawPtrByCoordinates(pos);
   if (block_ptr == nullptr) {
     return false;
   }
@@ -196,8 +226,8 @@ bool Interpolator<VoxelType>::setIndexes(const Point& pos,
                                          InterpIndexes* voxel_indexes) const {
   // get voxel index
   *block_index = layer_->computeBlockIndexFromCoordinates(pos);
-  typename Layer<VoxelType>::BlockType::ConstPtr block_ptr =
-      layer_->getBlockPtrByIndex(*block_index);
+  const typename Layer<VoxelType>::BlockType* block_ptr =
+      layer_->getBlockRawPtrByIndex(*block_index);
   if (block_ptr == nullptr) {
     return false;
   }
@@ -267,8 +297,8 @@ bool Interpolator<VoxelType>::getVoxelsAndQVector(
 
   // for each voxel index
   for (size_t i = 0; i < static_cast<size_t>(voxel_indexes.cols()); ++i) {
-    typename Layer<VoxelType>::BlockType::ConstPtr block_ptr =
-        layer_->getBlockPtrByIndex(block_index);
+    const typename Layer<VoxelType>::BlockType* block_ptr =
+        layer_->getBlockRawPtrByIndex(block_index);
     if (block_ptr == nullptr) {
       return false;
     }
@@ -284,7 +314,7 @@ bool Interpolator<VoxelType>::getVoxelsAndQVector(
           voxel_index(j) -= block_ptr->voxels_per_side();
         }
       }
-      block_ptr = layer_->getBlockPtrByIndex(new_block_index);
+      block_ptr = layer_->getBlockRawPtrByIndex(new_block_index);
       if (block_ptr == nullptr) {
         return false;
       }
@@ -340,8 +370,8 @@ bool Interpolator<VoxelType>::getNearestDistance(
     const Point& pos, FloatingPoint* distance) const {
   CHECK_NOTNULL(distance);
 
-  typename Layer<VoxelType>::BlockType::ConstPtr block_ptr =
-      layer_->getBlockPtrByCoordinates(pos);
+  const typename Layer<VoxelType>::BlockType* block_ptr =
+      layer_->getBlockRawPtrByCoordinates(pos);
   if (block_ptr == nullptr) {
     return false;
   }
@@ -374,8 +404,8 @@ bool Interpolator<VoxelType>::getNearestVoxel(const Point& pos,
                                               VoxelType* voxel) const {
   CHECK_NOTNULL(voxel);
 
-  typename Layer<VoxelType>::BlockType::ConstPtr block_ptr =
-      layer_->getBlockPtrByCoordinates(pos);
+  const typename Layer<VoxelType>::BlockType* block_ptr =
+      layer_->getBlockRawPtrByCoordinates(pos);
   if (block_ptr == nullptr) {
     return false;
   }
@@ -391,8 +421,8 @@ bool Interpolator<VoxelType>::getNearestDistanceAndWeight(
   CHECK_NOTNULL(distance);
   CHECK_NOTNULL(weight);
 
-  typename Layer<VoxelType>::BlockType::ConstPtr block_ptr =
-      layer_->getBlockPtrByCoordinates(pos);
+  const typename Layer<VoxelType>::BlockType* block_ptr =
+      layer_->getBlockRawPtrByCoordinates(pos);
   if (block_ptr == nullptr) {
     return false;
   }
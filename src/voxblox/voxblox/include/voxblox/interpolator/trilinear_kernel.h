@@ -0,0 +1,55 @@
+#ifndef VOXBLOX_INTERPOLATOR_TRILINEAR_KERNEL_H_
+#define VOXBLOX_INTERPOLATOR_TRILINEAR_KERNEL_H_
+
+#include <Eigen/Core>
+
+#include "voxblox/core/common.h"
+
+namespace voxblox {
+
+/**
+ * Distances at the corners of a cell between eight voxel centers. Corner c
+ * lies at voxel offset (c >> 2, (c >> 1) & 1, c & 1) from the lower corner,
+ * so the head and tail hold the lower and upper face along x. Unaligned, so
+ * it can be stored in TrilinearCell::corners.
+ */
+typedef Eigen::Array<FloatingPoint, 8, 1, Eigen::DontAlign> CellCorners;
+
+/**
+ * Trilinear interpolation of the corner distances of a cell at fraction, the
+ * position relative to the lower corner in voxels. The gradient is the
+ * analytic derivative of the interpolated distance. The four edges along x
+ * are interpolated in one packet, the remaining steps reuse their
+ * differences for the gradient.
+ */
+inline FloatingPoint interpolateTrilinear(const CellCorners& corner_distances,
+                                          const Point& fraction,
+                                          FloatingPoint voxel_size_inv,
+                                          Point* gradient) {
+  typedef Eigen::Array<FloatingPoint, 4, 1> Edges;
+  typedef Eigen::Array<FloatingPoint, 2, 1> Faces;
+
+  // Edges along x, ordered (y, z) = (0, 0), (0, 1), (1, 0), (1, 1).
+  const Edges lower_x = corner_distances.head<4>();
+  const Edges diff_x = corner_distances.tail<4>() - lower_x;
+  const Edges lerp_x = lower_x + fraction.x() * diff_x;
+
+  // Along y, ordered z = 0, 1.
+  const Faces diff_y = lerp_x.tail<2>() - lerp_x.head<2>();
+  const Faces lerp_y = lerp_x.head<2>() + fraction.y() * diff_y;
+  const Faces lerp_diff_x =
+      diff_x.head<2>() + fraction.y() * (diff_x.tail<2>() - diff_x.head<2>());
+
+  const FloatingPoint diff_z = lerp_y(1) - lerp_y(0);
+  gradient->x() =
+      voxel_size_inv *
+      (lerp_diff_x(0) + fraction.z() * (lerp_diff_x(1) - lerp_diff_x(0)));
+  gradient->y() =
+      voxel_size_inv * (diff_y(0) + fraction.z() * (diff_y(1) - diff_y(0)));
+  gradient->z() = voxel_size_inv * diff_z;
+  return lerp_y(0) + fraction.z() * diff_z;
+}
+
+}  // namespace voxblox
+
+#endif  // VOXBLOX_INTERPOLATOR_TRILINEAR_KERNEL_H_
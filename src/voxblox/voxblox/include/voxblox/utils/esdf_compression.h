@@ -0,0 +1,43 @@
+#ifndef VOXBLOX_UTILS_ESDF_COMPRESSION_H_
+#define VOXBLOX_UTILS_ESDF_COMPRESSION_H_
+
+#include <vector>
+
+#include "voxblox/core/block.h"
+#include "voxblox/core/common.h"
+#include "voxblox/core/voxel.h"
+
+namespace voxblox {
+
+/**
+ * Lossy encoding of the distances and observed flags of an ESDF block for
+ * streaming. The first word holds the quantization step of the block as a
+ * float, max |distance| / kMaxEsdfCode. Every voxel then maps to a 16 bit
+ * symbol, the distance in steps shifted left by one with the observed flag in
+ * the lowest bit. Runs of equal symbols in linear voxel order are stored as
+ * one word each, the run length in the upper and the symbol in the lower 16
+ * bits, so free and unobserved space costs a few words per block.
+ *
+ * The parent direction and the hallucinated, in_queue and fixed flags are
+ * only needed by the integrator and are not transmitted.
+ */
+namespace esdf_compression {
+/// Largest magnitude of a quantized distance, 15 bits including the sign.
+constexpr int kMaxEsdfCode = (1 << 14) - 1;
+}  // namespace esdf_compression
+
+/// Replaces data by the compressed voxels of block.
+void compressEsdfBlock(const Block<EsdfVoxel>& block,
+                       std::vector<uint32_t>* data);
+
+/**
+ * Overwrites the distances and observed flags of all voxels of block in
+ * place, the remaining fields are reset. Returns false and leaves the block
+ * partially written if data does not hold exactly one symbol per voxel.
+ */
+bool decompressEsdfBlock(const std::vector<uint32_t>& data,
+                         Block<EsdfVoxel>* block);
+
+}  // namespace voxblox
+
+#endif  // VOXBLOX_UTILS_ESDF_COMPRESSION_H_
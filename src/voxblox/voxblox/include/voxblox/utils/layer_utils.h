@@ -170,7 +170,7 @@ void centerBlocksOfLayer(Layer<VoxelType>* layer, Point* new_layer_origin) {
   CHECK_EQ(layer->getNumberOfAllocatedBlocks(), 0u);
 
   // Insert into layer again.
-  for (const std::pair<const BlockIndex, typename Block<VoxelType>::Ptr>&
+  for (const typename Layer<VoxelType>::BlockHashMap::value_type&
            idx_block_pair : temporary_map) {
     layer->insertBlock(idx_block_pair);
   }
@@ -0,0 +1,194 @@
+#include "voxblox/core/compact_esdf_layer.h"
+
+#include <algorithm>
+
+namespace voxblox {
+
+CompactEsdfBlock::CompactEsdfBlock(const Block<EsdfCachingVoxel>& block,
+                                   bool half_precision_gradients,
+                                   bool with_hessians)
+    : voxels_per_side_(block.voxels_per_side()),
+      num_voxels_(block.num_voxels()),
+      voxel_size_(block.voxel_size()),
+      voxel_size_inv_(block.voxel_size_inv()),
+      origin_(block.origin()) {
+  distances_.resize(num_voxels_);
+  for (int dim = 0; dim < 3; ++dim) {
+    if (half_precision_gradients) {
+      half_gradients_[dim].resize(num_voxels_);
+    } else {
+      gradients_[dim].resize(num_voxels_);
+    }
+  }
+  if (with_hessians) {
+    for (int i = 0; i < 6; ++i) {
+      hessians_[i].resize(num_voxels_);
+    }
+  }
+
+  for (size_t linear_index = 0u; linear_index < num_voxels_; ++linear_index) {
+    const EsdfCachingVoxel& voxel = block.getVoxelByLinearIndex(linear_index);
+    distances_[linear_index] = voxel.distance;
+    for (int dim = 0; dim < 3; ++dim) {
+      if (half_precision_gradients) {
+        half_gradients_[dim][linear_index] = Eigen::half(voxel.gradient(dim));
+      } else {
+        gradients_[dim][linear_index] = voxel.gradient(dim);
+      }
+    }
+    if (with_hessians) {
+      for (int i = 0; i < 6; ++i) {
+        hessians_[i][linear_index] = voxel.hessian(i);
+      }
+    }
+  }
+}
+
+size_t CompactEsdfBlock::getMemorySize() const {
+  size_t size = sizeof(*this);
+  size += distances_.capacity() * sizeof(float);
+  for (int dim = 0; dim < 3; ++dim) {
+    size += gradients_[dim].capacity() * sizeof(float);
+    size += half_gradients_[dim].capacity() * sizeof(Eigen::half);
+  }
+  for (int i = 0; i < 6; ++i) {
+    size += hessians_[i].capacity() * sizeof(float);
+  }
+  return size;
+}
+
+CompactEsdfLayer::CompactEsdfLayer(FloatingPoint voxel_size,
+                                   size_t voxels_per_side,
+                                   bool half_precision_gradients,
+                                   bool with_hessians)
+    : voxel_size_(voxel_size),
+      voxels_per_side_(voxels_per_side),
+      half_precision_gradients_(half_precision_gradients),
+      with_hessians_(with_hessians) {
+  CHECK_GT(voxel_size_, 0.0f);
+  CHECK_GT(voxels_per_side_, 0u);
+  block_size_inv_ = 1.0 / (voxel_size_ * voxels_per_side_);
+}
+
+void CompactEsdfLayer::updateBlocks(const Layer<EsdfCachingVoxel>& layer,
+                                    const BlockIndexList& blocks) {
+  CHECK_EQ(layer.voxels_per_side(), voxels_per_side_);
+  for (const BlockIndex& block_index : blocks) {
+    Layer<EsdfCachingVoxel>::BlockType::ConstPtr block_ptr =
+        layer.getBlockPtrByIndex(block_index);
+    if (block_ptr == nullptr) {
+      block_map_.erase(block_index);
+      continue;
+    }
+    // Replace instead of writing in place, copies of this layer may still
+    // share the old block.
+    block_map_[block_index] = std::make_shared<const CompactEsdfBlock>(
+        *block_ptr, half_precision_gradients_, with_hessians_);
+  }
+}
+
+void CompactEsdfLayer::updateAllBlocks(const Layer<EsdfCachingVoxel>& layer) {
+  BlockIndexList blocks;
+  layer.getAllAllocatedBlocks(&blocks);
+  block_map_.clear();
+  updateBlocks(layer, blocks);
+}
+
+CompactEsdfBlock::ConstPtr CompactEsdfLayer::getBlockPtrByIndex(
+    const BlockIndex& index) const {
+  BlockHashMap::const_iterator it = block_map_.find(index);
+  if (it == block_map_.end()) {
+    return CompactEsdfBlock::ConstPtr();
+  }
+  return it->second;
+}
+
+size_t CompactEsdfLayer::getMemorySize() const {
+  size_t size = sizeof(*this);
+  for (const auto& kv : block_map_) {
+    size += kv.second->getMemorySize();
+  }
+  return size;
+}
+
+template <bool kWithHessians>
+size_t CompactEsdfLayer::queryDistancesGradients(
+    const PointsMatrix& positions, DistanceVector* distances,
+    PointsMatrix* gradients, SymmetricMatrices* hessians,
+    ValidityVector* valid) const {
+  CHECK_NOTNULL(distances);
+  CHECK_NOTNULL(gradients);
+  CHECK_NOTNULL(valid);
+  const Eigen::Index num_points = positions.cols();
+  if (distances->size() != num_points) {
+    distances->resize(num_points);
+  }
+  if (gradients->cols() != num_points) {
+    gradients->resize(Eigen::NoChange, num_points);
+  }
+  if (kWithHessians && hessians->cols() != num_points) {
+    hessians->resize(Eigen::NoChange, num_points);
+  }
+  if (valid->size() != num_points) {
+    valid->resize(num_points);
+  }
+
+  // Consecutive query points usually lie in the same block.
+  BlockIndex last_block_index;
+  const CompactEsdfBlock* block_ptr = nullptr;
+  bool has_last_block = false;
+
+  size_t num_valid = 0u;
+  for (Eigen::Index i = 0; i < num_points; ++i) {
+    const Point pos = positions.col(i);
+    const BlockIndex block_index =
+        getGridIndexFromPoint<BlockIndex>(pos, block_size_inv_);
+    if (!has_last_block || block_index != last_block_index) {
+      BlockHashMap::const_iterator it = block_map_.find(block_index);
+      block_ptr = it == block_map_.end() ? nullptr : it->second.get();
+      last_block_index = block_index;
+      has_last_block = true;
+    }
+    if (block_ptr == nullptr) {
+      (*valid)(i) = false;
+      continue;
+    }
+
+    Point offset;
+    const size_t linear_index =
+        block_ptr->computeLinearIndexFromCoordinates(pos, &offset);
+    const Point gradient = block_ptr->gradient(linear_index);
+    (*distances)(i) = block_ptr->distance(linear_index) + gradient.dot(offset);
+    gradients->col(i) = gradient;
+    if (kWithHessians) {
+      const Eigen::Matrix<float, 6, 1> h = block_ptr->hessian(linear_index);
+      Eigen::Matrix3f hessian;
+      hessian << h(0), h(1), h(2), h(1), h(3), h(4), h(2), h(4), h(5);
+      (*distances)(i) += 0.5f * offset.dot(hessian * offset);
+      gradients->col(i) += hessian * offset;
+      hessians->col(i) = h;
+    }
+    (*valid)(i) = true;
+    ++num_valid;
+  }
+  return num_valid;
+}
+
+size_t CompactEsdfLayer::getInterpolatedDistancesGradients(
+    const PointsMatrix& positions, DistanceVector* distances,
+    PointsMatrix* gradients, ValidityVector* valid) const {
+  return queryDistancesGradients<false>(positions, distances, gradients,
+                                        nullptr, valid);
+}
+
+size_t CompactEsdfLayer::getInterpolatedDistancesGradientsFromHessians(
+    const PointsMatrix& positions, DistanceVector* distances,
+    PointsMatrix* gradients, SymmetricMatrices* hessians,
+    ValidityVector* valid) const {
+  CHECK(with_hessians_) << "The compact layer does not store hessians.";
+  CHECK_NOTNULL(hessians);
+  return queryDistancesGradients<true>(positions, distances, gradients,
+                                       hessians, valid);
+}
+
+}  // namespace voxblox
@@ -0,0 +1,328 @@
+#include "voxblox/core/esdf_window.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "voxblox/interpolator/trilinear_kernel.h"
+
+namespace voxblox {
+
+namespace {
+
+/// Integer division rounding towards negative infinity.
+inline LongIndexElement floorDivide(LongIndexElement value,
+                                    LongIndexElement divisor) {
+  const LongIndexElement quotient = value / divisor;
+  return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+}
+
+}  // namespace
+
+constexpr LongIndexElement EsdfWindow::kBrickVoxels;
+constexpr int EsdfWindow::kBrickShift;
+constexpr LongIndexElement EsdfWindow::kBrickMask;
+
+EsdfWindow::EsdfWindow(FloatingPoint voxel_size, size_t side_voxels)
+    : voxel_size_(voxel_size),
+      side_voxels_(side_voxels),
+      initialized_(false),
+      origin_(GlobalIndex::Zero()),
+      phase_(GlobalIndex::Zero()) {
+  CHECK_GT(voxel_size_, 0.0f);
+  CHECK_GT(side_voxels_, 0u);
+  voxel_size_inv_ = 1.0 / voxel_size_;
+  WindowVoxel unknown_voxel;
+  unknown_voxel.distance = std::numeric_limits<float>::quiet_NaN();
+  unknown_voxel.gradient[0] = 0.0f;
+  unknown_voxel.gradient[1] = 0.0f;
+  unknown_voxel.gradient[2] = 0.0f;
+  bricks_per_side_ = (side_voxels_ + kBrickVoxels - 1) / kBrickVoxels;
+  brick_strides_[0] = 1u;
+  brick_strides_[1] = bricks_per_side_;
+  brick_strides_[2] = bricks_per_side_ * bricks_per_side_;
+  // The bricks at the upper end are only partially used.
+  bricks_.resize(bricks_per_side_ * bricks_per_side_ * bricks_per_side_);
+  for (std::shared_ptr<Brick>& brick : bricks_) {
+    brick = std::make_shared<Brick>(kBrickVoxels * kBrickVoxels * kBrickVoxels,
+                                    unknown_voxel);
+  }
+}
+
+EsdfWindow::WindowVoxel& EsdfWindow::getMutableVoxel(
+    const GlobalIndex& global_index) {
+  const GlobalIndex slot = getSlot3(global_index);
+  size_t brick = 0u;
+  size_t offset = 0u;
+  for (int dim = 0; dim < 3; ++dim) {
+    brick += getBrickTerm(slot(dim), dim);
+    offset += getOffsetTerm(slot(dim), dim);
+  }
+  // Only this window can add owners to a brick it holds alone, other owners
+  // can only let go of it concurrently.
+  std::shared_ptr<Brick>& brick_ptr = bricks_[brick];
+  if (brick_ptr.use_count() > 1) {
+    brick_ptr = std::make_shared<Brick>(*brick_ptr);
+  }
+  return (*brick_ptr)[offset];
+}
+
+void EsdfWindow::moveTo(const Layer<EsdfCachingVoxel>& layer,
+                        const Point& center) {
+  const LongIndexElement side = static_cast<LongIndexElement>(side_voxels_);
+  const GlobalIndex old_origin = origin_;
+  origin_ = getGlobalIndex(center) - GlobalIndex::Constant(side / 2);
+  for (int dim = 0; dim < 3; ++dim) {
+    phase_(dim) = origin_(dim) - floorDivide(origin_(dim), side) * side;
+  }
+
+  if (!initialized_ || (origin_ - old_origin).cwiseAbs().maxCoeff() >= side) {
+    initialized_ = true;
+    updateAll(layer);
+    return;
+  }
+
+  // The voxels entering the window form up to three slabs: the part outside
+  // of the old window along x, then along y within the overlap in x, then
+  // along z within the overlap in x and y.
+  GlobalIndex min_index = origin_;
+  GlobalIndex max_index = origin_ + GlobalIndex::Constant(side);
+  for (int dim = 0; dim < 3; ++dim) {
+    const LongIndexElement overlap_min = std::max(origin_(dim), old_origin(dim));
+    const LongIndexElement overlap_max =
+        std::min(origin_(dim), old_origin(dim)) + side;
+    GlobalIndex slab_min = min_index;
+    GlobalIndex slab_max = max_index;
+    if (origin_(dim) < old_origin(dim)) {
+      slab_max(dim) = overlap_min;
+      copyBox(layer, slab_min, slab_max);
+    } else if (origin_(dim) > old_origin(dim)) {
+      slab_min(dim) = overlap_max;
+      copyBox(layer, slab_min, slab_max);
+    }
+    min_index(dim) = overlap_min;
+    max_index(dim) = overlap_max;
+  }
+}
+
+void EsdfWindow::updateBlocks(const Layer<EsdfCachingVoxel>& layer,
+                              const BlockIndexList& blocks) {
+  if (!initialized_) {
+    return;
+  }
+  const LongIndexElement voxels_per_side =
+      static_cast<LongIndexElement>(layer.voxels_per_side());
+  const GlobalIndex window_max =
+      origin_ + GlobalIndex::Constant(side_voxels_);
+  for (const BlockIndex& block_index : blocks) {
+    const GlobalIndex block_min =
+        block_index.cast<LongIndexElement>() * voxels_per_side;
+    const GlobalIndex min_index = block_min.cwiseMax(origin_);
+    const GlobalIndex max_index =
+        (block_min + GlobalIndex::Constant(voxels_per_side))
+            .cwiseMin(window_max);
+    if ((min_index.array() < max_index.array()).all()) {
+      copyBox(layer, min_index, max_index);
+    }
+  }
+}
+
+void EsdfWindow::updateAll(const Layer<EsdfCachingVoxel>& layer) {
+  if (!initialized_) {
+    return;
+  }
+  copyBox(layer, origin_, origin_ + GlobalIndex::Constant(side_voxels_));
+}
+
+void EsdfWindow::copyBox(const Layer<EsdfCachingVoxel>& layer,
+                         const GlobalIndex& min_index,
+                         const GlobalIndex& max_index) {
+  CHECK_NEAR(layer.voxel_size(), voxel_size_, kEpsilon);
+  GlobalIndex global_index;
+  for (global_index.z() = min_index.z(); global_index.z() < max_index.z();
+       ++global_index.z()) {
+    for (global_index.y() = min_index.y(); global_index.y() < max_index.y();
+         ++global_index.y()) {
+      for (global_index.x() = min_index.x(); global_index.x() < max_index.x();
+           ++global_index.x()) {
+        getMutableVoxel(global_index).distance =
+            std::numeric_limits<float>::quiet_NaN();
+      }
+    }
+  }
+
+  // Then copy block by block, so every block is looked up once.
+  const LongIndexElement voxels_per_side =
+      static_cast<LongIndexElement>(layer.voxels_per_side());
+  GlobalIndex min_block;
+  GlobalIndex max_block;
+  for (int dim = 0; dim < 3; ++dim) {
+    min_block(dim) = floorDivide(min_index(dim), voxels_per_side);
+    max_block(dim) = floorDivide(max_index(dim) - 1, voxels_per_side);
+  }
+  BlockIndex block_index;
+  for (block_index.z() = min_block.z(); block_index.z() <= max_block.z();
+       ++block_index.z()) {
+    for (block_index.y() = min_block.y(); block_index.y() <= max_block.y();
+         ++block_index.y()) {
+      for (block_index.x() = min_block.x(); block_index.x() <= max_block.x();
+           ++block_index.x()) {
+        const Block<EsdfCachingVoxel>* block_ptr =
+            layer.getBlockRawPtrByIndex(block_index);
+        if (block_ptr == nullptr) {
+          continue;
+        }
+        const GlobalIndex block_min =
+            block_index.cast<LongIndexElement>() * voxels_per_side;
+        const GlobalIndex copy_min = block_min.cwiseMax(min_index);
+        const GlobalIndex copy_max =
+            (block_min + GlobalIndex::Constant(voxels_per_side))
+                .cwiseMin(max_index);
+        for (global_index.z() = copy_min.z(); global_index.z() < copy_max.z();
+             ++global_index.z()) {
+          for (global_index.y() = copy_min.y();
+               global_index.y() < copy_max.y(); ++global_index.y()) {
+            for (global_index.x() = copy_min.x();
+                 global_index.x() < copy_max.x(); ++global_index.x()) {
+              const EsdfCachingVoxel& voxel = block_ptr->getVoxelByVoxelIndex(
+                  (global_index - block_min).cast<IndexElement>());
+              WindowVoxel& window_voxel = getMutableVoxel(global_index);
+              window_voxel.distance = voxel.distance;
+              for (int dim = 0; dim < 3; ++dim) {
+                window_voxel.gradient[dim] = voxel.gradient(dim);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+template <bool kTrilinear>
+size_t EsdfWindow::queryDistancesGradients(const PointsMatrix& positions,
+                                           DistanceVector* distances,
+                                           PointsMatrix* gradients,
+                                           ValidityVector* valid) const {
+  CHECK_NOTNULL(distances);
+  CHECK_NOTNULL(gradients);
+  CHECK_NOTNULL(valid);
+  const Eigen::Index num_points = positions.cols();
+  if (distances->size() != num_points) {
+    distances->resize(num_points);
+  }
+  if (gradients->cols() != num_points) {
+    gradients->resize(Eigen::NoChange, num_points);
+  }
+  if (valid->size() != num_points) {
+    valid->resize(num_points);
+  }
+
+  size_t num_valid = 0u;
+  for (Eigen::Index i = 0; i < num_points; ++i) {
+    const Point pos = positions.col(i);
+    if (kTrilinear && initialized_) {
+      // Voxel centers lie at (index + 0.5) * voxel_size.
+      const Point scaled_pos = pos * voxel_size_inv_ - Point::Constant(0.5f);
+      const GlobalIndex lower_index(std::floor(scaled_pos.x()),
+                                    std::floor(scaled_pos.y()),
+                                    std::floor(scaled_pos.z()));
+      if (isInWindow(lower_index) &&
+          isInWindow(lower_index + GlobalIndex::Ones())) {
+        // Brick and offset terms of the lower and upper voxels along each
+        // axis, the upper ones may wrap around.
+        const LongIndexElement side =
+            static_cast<LongIndexElement>(side_voxels_);
+        const GlobalIndex lower_slot = getSlot3(lower_index);
+        size_t brick_terms[3][2];
+        size_t offset_terms[3][2];
+        for (int dim = 0; dim < 3; ++dim) {
+          const LongIndexElement upper_slot =
+              lower_slot(dim) + 1 == side ? 0 : lower_slot(dim) + 1;
+          brick_terms[dim][0] = getBrickTerm(lower_slot(dim), dim);
+          brick_terms[dim][1] = getBrickTerm(upper_slot, dim);
+          offset_terms[dim][0] = getOffsetTerm(lower_slot(dim), dim);
+          offset_terms[dim][1] = getOffsetTerm(upper_slot, dim);
+        }
+        CellCorners corner_distances;
+        for (int c = 0; c < 8; ++c) {
+          const int x = c >> 2;
+          const int y = (c >> 1) & 1;
+          const int z = c & 1;
+          const Brick& brick =
+              *bricks_[brick_terms[0][x] + brick_terms[1][y] +
+                       brick_terms[2][z]];
+          corner_distances(c) =
+              brick[offset_terms[0][x] + offset_terms[1][y] +
+                    offset_terms[2][z]]
+                  .distance;
+        }
+        // NaN marks unknown voxels, fall back to the containing voxel then.
+        if (!corner_distances.isNaN().any()) {
+          Point gradient;
+          (*distances)(i) = interpolateTrilinear(
+              corner_distances, scaled_pos - lower_index.cast<FloatingPoint>(),
+              voxel_size_inv_, &gradient);
+          gradients->col(i) = gradient;
+          (*valid)(i) = true;
+          ++num_valid;
+          continue;
+        }
+      }
+    }
+
+    const GlobalIndex global_index = getGlobalIndex(pos);
+    if (!initialized_ || !isInWindow(global_index)) {
+      (*valid)(i) = false;
+      continue;
+    }
+    const WindowVoxel& voxel = getVoxel(global_index);
+    if (std::isnan(voxel.distance)) {
+      (*valid)(i) = false;
+      continue;
+    }
+    const Eigen::Map<const Point> gradient(voxel.gradient);
+    const Point offset =
+        pos - getCenterPointFromGridIndex(global_index, voxel_size_);
+    (*distances)(i) = voxel.distance + gradient.dot(offset);
+    gradients->col(i) = gradient;
+    (*valid)(i) = true;
+    ++num_valid;
+  }
+  return num_valid;
+}
+
+size_t EsdfWindow::getInterpolatedDistancesGradients(
+    const PointsMatrix& positions, DistanceVector* distances,
+    PointsMatrix* gradients, ValidityVector* valid) const {
+  return queryDistancesGradients<false>(positions, distances, gradients,
+                                        valid);
+}
+
+size_t EsdfWindow::getTrilinearDistancesGradients(
+    const PointsMatrix& positions, DistanceVector* distances,
+    PointsMatrix* gradients, ValidityVector* valid) const {
+  return queryDistancesGradients<true>(positions, distances, gradients, valid);
+}
+
+size_t EsdfWindow::getMemorySize() const {
+  size_t size = sizeof(*this) +
+                bricks_.capacity() * sizeof(std::shared_ptr<Brick>);
+  for (const std::shared_ptr<Brick>& brick : bricks_) {
+    size += sizeof(Brick) + brick->capacity() * sizeof(WindowVoxel);
+  }
+  return size;
+}
+
+size_t EsdfWindow::getNumSharedBricks(const EsdfWindow& other) const {
+  if (other.bricks_.size() != bricks_.size()) {
+    return 0u;
+  }
+  size_t num_shared = 0u;
+  for (size_t i = 0u; i < bricks_.size(); ++i) {
+    num_shared += bricks_[i] == other.bricks_[i] ? 1u : 0u;
+  }
+  return num_shared;
+}
+
+}  // namespace voxblox
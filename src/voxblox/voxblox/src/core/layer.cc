@@ -1,44 +1,288 @@
 //
 // Created by johannes on 19.12.19.
 //
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <thread>
+#include <vector>
+
 #include <voxblox/core/layer.h>
+#include <voxblox/integrator/integrator_utils.h>
 #include <voxblox/interpolator/interpolator.h>
 using namespace voxblox;
 
-template <>
-void Layer<EsdfCachingVoxel>::cacheGradients(){
-  BlockIndexList blocksIdxs;
-  getAllAllocatedBlocks(&blocksIdxs);
-
-  Interpolator<EsdfCachingVoxel> interpolator(this);
-  // precompute gradients
-  for (const BlockIndex& blockIdx : blocksIdxs) {
-    const Block<EsdfCachingVoxel>& block = getBlockByIndex(blockIdx);
-    for (int i = 0; i < block.num_voxels(); i++) {
-      const Point& point = block.computeCoordinatesFromLinearIndex(i);
-      Eigen::Vector3f gradient;
-      if (interpolator.getGradient(point, &gradient)) {
-        getVoxelPtrByCoordinates(point)->gradient = gradient;
+namespace {
+
+/**
+ * Computes the gradients of all voxels of one block. Voxels in the interior
+ * of the block take their central differences directly from the block, only
+ * the border voxels go through the interpolator to reach the neighbor blocks.
+ * Voxels without an observed neighborhood get a zero gradient and are marked
+ * with gradient_valid = false.
+ */
+void cacheBlockGradients(const Interpolator<EsdfCachingVoxel>& interpolator,
+                         Block<EsdfCachingVoxel>* block) {
+  const IndexElement vps = block->voxels_per_side();
+  const FloatingPoint inv_two_voxel_size = 0.5f * block->voxel_size_inv();
+  for (size_t i = 0u; i < block->num_voxels(); ++i) {
+    const VoxelIndex voxel_index = block->computeVoxelIndexFromLinearIndex(i);
+    EsdfCachingVoxel& voxel = block->getVoxelByLinearIndex(i);
+
+    const bool is_interior = (voxel_index.array() > 0).all() &&
+                             (voxel_index.array() < vps - 1).all();
+    if (!is_interior) {
+      const Point point = block->computeCoordinatesFromVoxelIndex(voxel_index);
+      Point gradient;
+      voxel.gradient_valid = interpolator.getGradient(point, &gradient);
+      if (voxel.gradient_valid) {
+        voxel.gradient = gradient;
+      } else {
+        voxel.gradient.setZero();
       }
+      continue;
+    }
+
+    bool all_observed = true;
+    Point gradient;
+    for (unsigned int dim = 0u; dim < 3u; ++dim) {
+      VoxelIndex offset = VoxelIndex::Zero();
+      offset(dim) = 1;
+      const EsdfCachingVoxel& positive =
+          block->getVoxelByVoxelIndex(voxel_index + offset);
+      const EsdfCachingVoxel& negative =
+          block->getVoxelByVoxelIndex(voxel_index - offset);
+      all_observed = all_observed && positive.observed && negative.observed;
+      gradient(dim) =
+          (positive.distance - negative.distance) * inv_two_voxel_size;
+    }
+    voxel.gradient_valid = all_observed;
+    if (all_observed) {
+      voxel.gradient = gradient;
+    } else {
+      voxel.gradient.setZero();
     }
   }
 }
 
-template <>
-void Layer<EsdfCachingVoxel>::cacheHessians(){
-  BlockIndexList blocksIdxs;
-  getAllAllocatedBlocks(&blocksIdxs);
-
-  Interpolator<EsdfCachingVoxel> interpolator(this);
-  // precompute hessians
-  for (const BlockIndex& blockIdx : blocksIdxs) {
-    const Block<EsdfCachingVoxel>& block = getBlockByIndex(blockIdx);
-    for (int i = 0; i < block.num_voxels(); i++) {
-      const Point& point = block.computeCoordinatesFromLinearIndex(i);
-      Eigen::Matrix3f hessian;
-      if (interpolator.getHessian(point, &hessian)) {
-        getVoxelPtrByCoordinates(point)->hessian = hessian;
+/**
+ * Computes the hessians of all voxels of one block as the central difference
+ * of the cached gradients, so the gradients have to be cached before. Border
+ * voxels look up their neighbors in the adjacent blocks. Voxels with a
+ * missing neighbor or a neighbor without a valid gradient get a zero hessian,
+ * like Interpolator::getHessian() fails if a neighbor gradient fails.
+ */
+void cacheBlockHessians(const Layer<EsdfCachingVoxel>& layer,
+                        Block<EsdfCachingVoxel>* block) {
+  const IndexElement vps = block->voxels_per_side();
+  const FloatingPoint inv_two_voxel_size = 0.5f * block->voxel_size_inv();
+  const BlockIndex block_index = block->block_index();
+  for (size_t i = 0u; i < block->num_voxels(); ++i) {
+    const VoxelIndex voxel_index = block->computeVoxelIndexFromLinearIndex(i);
+    const bool is_interior = (voxel_index.array() > 0).all() &&
+                             (voxel_index.array() < vps - 1).all();
+    const GlobalIndex global_index = getGlobalVoxelIndexFromBlockAndVoxelIndex(
+        block_index, voxel_index, vps);
+
+    bool all_valid = true;
+    Eigen::Matrix3f hessian;
+    for (unsigned int dim = 0u; dim < 3u && all_valid; ++dim) {
+      const EsdfCachingVoxel* positive = nullptr;
+      const EsdfCachingVoxel* negative = nullptr;
+      if (is_interior) {
+        VoxelIndex offset = VoxelIndex::Zero();
+        offset(dim) = 1;
+        positive = &block->getVoxelByVoxelIndex(voxel_index + offset);
+        negative = &block->getVoxelByVoxelIndex(voxel_index - offset);
+      } else {
+        GlobalIndex offset = GlobalIndex::Zero();
+        offset(dim) = 1;
+        positive = layer.getVoxelPtrByGlobalIndex(global_index + offset);
+        negative = layer.getVoxelPtrByGlobalIndex(global_index - offset);
+      }
+      all_valid = positive != nullptr && negative != nullptr &&
+                  positive->gradient_valid && negative->gradient_valid;
+      if (all_valid) {
+        hessian.col(dim) =
+            (positive->gradient - negative->gradient) * inv_two_voxel_size;
+      }
+    }
+
+    EsdfCachingVoxel& voxel = block->getVoxelByLinearIndex(i);
+    if (all_valid) {
+      voxel.setHessian(hessian);
+    } else {
+      voxel.hessian.setZero();
+    }
+  }
+}
+
+/**
+ * Copies the distances of the eight voxels of the cell of every voxel of one
+ * block, with the voxel in the lower corner, to the trilinear cells of the
+ * block. Interior cells are read from the block directly, the cells at the
+ * upper border look up their voxels in the next blocks.
+ */
+void cacheBlockTrilinearCells(const Layer<EsdfCachingVoxel>& layer,
+                              Block<EsdfCachingVoxel>* block) {
+  const IndexElement vps = block->voxels_per_side();
+  const size_t stride_y = vps;
+  const size_t stride_z = stride_y * vps;
+  const BlockIndex block_index = block->block_index();
+  TrilinearCell* cells = block->allocateTrilinearCells();
+  for (size_t i = 0u; i < block->num_voxels(); ++i) {
+    const VoxelIndex voxel_index = block->computeVoxelIndexFromLinearIndex(i);
+    TrilinearCell& cell = cells[i];
+
+    if ((voxel_index.array() < vps - 1).all()) {
+      for (int c = 0; c < 8; ++c) {
+        const size_t corner_index =
+            i + (c >> 2) + stride_y * ((c >> 1) & 1) + stride_z * (c & 1);
+        cell.corners(c) = block->getVoxelByLinearIndex(corner_index).distance;
+      }
+      cell.valid = true;
+      continue;
+    }
+
+    const GlobalIndex global_index = getGlobalVoxelIndexFromBlockAndVoxelIndex(
+        block_index, voxel_index, vps);
+    cell.valid = true;
+    for (int c = 0; c < 8 && cell.valid; ++c) {
+      const EsdfCachingVoxel* corner = layer.getVoxelPtrByGlobalIndex(
+          global_index + GlobalIndex(c >> 2, (c >> 1) & 1, c & 1));
+      cell.valid = corner != nullptr;
+      if (cell.valid) {
+        cell.corners(c) = corner->distance;
       }
     }
   }
-}
\ No newline at end of file
+}
+
+/**
+ * Runs cache_block on all given blocks, distributed over num_threads threads.
+ * Every thread only writes the blocks it grabbed, so cache_block may read
+ * anything but the member it writes.
+ */
+void cacheBlocksInParallel(
+    const std::vector<Block<EsdfCachingVoxel>*>& block_ptrs,
+    size_t num_threads,
+    const std::function<void(Block<EsdfCachingVoxel>*)>& cache_block) {
+  if (num_threads == 0u) {
+    LOG(WARNING) << "Automatic core count failed, defaulting to 1 threads";
+    num_threads = 1u;
+  }
+  num_threads = std::min(num_threads, block_ptrs.size());
+
+  MixedThreadSafeIndex index_getter(block_ptrs.size());
+  auto cache_function = [&]() {
+    size_t list_idx;
+    while (index_getter.getNextIndex(&list_idx)) {
+      cache_block(block_ptrs[list_idx]);
+    }
+  };
+
+  std::list<std::thread> cache_threads;
+  for (size_t i = 0u; i < num_threads; ++i) {
+    cache_threads.emplace_back(cache_function);
+  }
+  for (std::thread& thread : cache_threads) {
+    thread.join();
+  }
+}
+
+/// Returns the given blocks and all their allocated neighbors.
+std::vector<Block<EsdfCachingVoxel>*> getBlocksAndNeighbors(
+    Layer<EsdfCachingVoxel>* layer, const BlockIndexList& blocks) {
+  IndexSet blocks_to_update;
+  for (const BlockIndex& block_index : blocks) {
+    for (IndexElement x = -1; x <= 1; ++x) {
+      for (IndexElement y = -1; y <= 1; ++y) {
+        for (IndexElement z = -1; z <= 1; ++z) {
+          const BlockIndex neighbor_index = block_index + BlockIndex(x, y, z);
+          if (layer->hasBlock(neighbor_index)) {
+            blocks_to_update.insert(neighbor_index);
+          }
+        }
+      }
+    }
+  }
+
+  std::vector<Block<EsdfCachingVoxel>*> block_ptrs;
+  block_ptrs.reserve(blocks_to_update.size());
+  for (const BlockIndex& block_index : blocks_to_update) {
+    block_ptrs.push_back(&layer->getBlockByIndex(block_index));
+  }
+  return block_ptrs;
+}
+
+}  // namespace
+
+template <>
+void Layer<EsdfCachingVoxel>::cacheGradients(const BlockIndexList& blocks,
+                                             size_t num_threads) {
+  // The border voxels of the neighbors depend on the given blocks as well.
+  const Interpolator<EsdfCachingVoxel> interpolator(this);
+  cacheBlocksInParallel(getBlocksAndNeighbors(this, blocks), num_threads,
+                        [&](Block<EsdfCachingVoxel>* block) {
+                          cacheBlockGradients(interpolator, block);
+                        });
+}
+
+template <>
+void Layer<EsdfCachingVoxel>::cacheGradients(size_t num_threads) {
+  std::vector<Block<EsdfCachingVoxel>*> block_ptrs;
+  block_ptrs.reserve(block_map_.size());
+  for (const auto& kv : block_map_) {
+    block_ptrs.push_back(kv.second.get());
+  }
+  const Interpolator<EsdfCachingVoxel> interpolator(this);
+  cacheBlocksInParallel(block_ptrs, num_threads,
+                        [&](Block<EsdfCachingVoxel>* block) {
+                          cacheBlockGradients(interpolator, block);
+                        });
+}
+
+template <>
+void Layer<EsdfCachingVoxel>::cacheHessians(const BlockIndexList& blocks,
+                                            size_t num_threads) {
+  cacheBlocksInParallel(getBlocksAndNeighbors(this, blocks), num_threads,
+                        [this](Block<EsdfCachingVoxel>* block) {
+                          cacheBlockHessians(*this, block);
+                        });
+}
+
+template <>
+void Layer<EsdfCachingVoxel>::cacheHessians(size_t num_threads) {
+  std::vector<Block<EsdfCachingVoxel>*> block_ptrs;
+  block_ptrs.reserve(block_map_.size());
+  for (const auto& kv : block_map_) {
+    block_ptrs.push_back(kv.second.get());
+  }
+  cacheBlocksInParallel(block_ptrs, num_threads,
+                        [this](Block<EsdfCachingVoxel>* block) {
+                          cacheBlockHessians(*this, block);
+                        });
+}
+
+template <>
+void Layer<EsdfCachingVoxel>::cacheTrilinearCells(const BlockIndexList& blocks,
+                                                  size_t num_threads) {
+  // The cells at the border of the neighbors reach into the given blocks.
+  cacheBlocksInParallel(getBlocksAndNeighbors(this, blocks), num_threads,
+                        [this](Block<EsdfCachingVoxel>* block) {
+                          cacheBlockTrilinearCells(*this, block);
+                        });
+}
+
+template <>
+void Layer<EsdfCachingVoxel>::cacheTrilinearCells(size_t num_threads) {
+  std::vector<Block<EsdfCachingVoxel>*> block_ptrs;
+  block_ptrs.reserve(block_map_.size());
+  for (const auto& kv : block_map_) {
+    block_ptrs.push_back(kv.second.get());
+  }
+  cacheBlocksInParallel(block_ptrs, num_threads,
+                        [this](Block<EsdfCachingVoxel>* block) {
+                          cacheBlockTrilinearCells(*this, block);
+                        });
+}
@@ -12,6 +12,7 @@ EsdfIntegrator::EsdfIntegrator(const Config& config,
   CHECK(esdf_layer_);
 
   voxels_per_side_ = esdf_layer_->voxels_per_side();
+  voxels_per_side_inv_ = 1.0 / voxels_per_side_;
   voxel_size_ = esdf_layer_->voxel_size();
 
   CHECK_EQ(esdf_layer_->voxels_per_side(), tsdf_layer_->voxels_per_side());
@@ -52,6 +53,7 @@ void EsdfIntegrator::addNewRobotPosition(const Point& position) {
         esdf_voxel.hallucinated = true;
         esdf_voxel.parent.setZero();
         updated_blocks_.insert(kv.first);
+        block_ptr->updated().set(Update::kMap);
       }
     }
   }
@@ -78,6 +80,7 @@ void EsdfIntegrator::addNewRobotPosition(const Point& position) {
         esdf_voxel.hallucinated = true;
         esdf_voxel.parent.setZero();
         updated_blocks_.insert(kv.first);
+        block_ptr->updated().set(Update::kMap);
       } else if (!esdf_voxel.in_queue) {
         GlobalIndex global_index = getGlobalVoxelIndexFromBlockAndVoxelIndex(
             kv.first, voxel_index, voxels_per_side_);
@@ -315,7 +318,7 @@ void EsdfIntegrator::processRaiseSet() {
     const GlobalIndex global_index = raise_.front();
     raise_.pop();
 
-    EsdfVoxel* voxel = esdf_layer_->getVoxelPtrByGlobalIndex(global_index);
+    EsdfVoxel* voxel = getChangedVoxelPtr(global_index);
     CHECK_NOTNULL(voxel);
 
     // Get the global indices of neighbors.
@@ -379,7 +382,7 @@ void EsdfIntegrator::processOpenSet() {
     GlobalIndex global_index = open_.front();
     open_.pop();
 
-    EsdfVoxel* voxel = esdf_layer_->getVoxelPtrByGlobalIndex(global_index);
+    EsdfVoxel* voxel = getChangedVoxelPtr(global_index);
     CHECK_NOTNULL(voxel);
     voxel->in_queue = false;
 
@@ -137,8 +137,8 @@ void TsdfIntegratorBase::updateLayerWithStoredBlocks() {
   BlockIndex last_block_idx;
   Block<TsdfVoxel>::Ptr block = nullptr;
 
-  for (const std::pair<const BlockIndex, Block<TsdfVoxel>::Ptr>&
-           temp_block_pair : temp_block_map_) {
+  for (const Layer<TsdfVoxel>::BlockHashMap::value_type& temp_block_pair :
+       temp_block_map_) {
     layer_->insertBlock(temp_block_pair);
   }
 
@@ -3,13 +3,273 @@
 //
 #include <voxblox/interpolator/interpolator.h>
 
+#include <voxblox/interpolator/trilinear_kernel.h>
+
 using namespace voxblox;
 
+namespace {
+
+/**
+ * Small cache of the blocks looked up so far. The query points of one batched
+ * call are usually clustered in a handful of blocks, so every block is only
+ * looked up once in the hash map. Misses (unallocated blocks) are cached as
+ * well.
+ */
+class BlockLookupCache {
+ public:
+  explicit BlockLookupCache(const Layer<EsdfCachingVoxel>* layer)
+      : layer_(layer) {}
+
+  /// Returns nullptr if the block containing pos is not allocated.
+  const Block<EsdfCachingVoxel>* getBlockPtr(const Point& pos) {
+    return getBlockPtrByIndex(layer_->computeBlockIndexFromCoordinates(pos));
+  }
+
+  const Block<EsdfCachingVoxel>* getBlockPtrByIndex(
+      const BlockIndex& block_index) {
+    for (size_t j = 0u; j < num_cached_; ++j) {
+      if (cached_indexes_[j] == block_index) {
+        return cached_blocks_[j];
+      }
+    }
+    const Block<EsdfCachingVoxel>* block_ptr =
+        layer_->getBlockRawPtrByIndex(block_index);
+    cached_indexes_[next_slot_] = block_index;
+    cached_blocks_[next_slot_] = block_ptr;
+    next_slot_ = (next_slot_ + 1u) % kBlockCacheSize;
+    num_cached_ = std::min(num_cached_ + 1u, kBlockCacheSize);
+    return block_ptr;
+  }
+
+ private:
+  static constexpr size_t kBlockCacheSize = 8u;
+
+  const Layer<EsdfCachingVoxel>* layer_;
+  BlockIndex cached_indexes_[kBlockCacheSize];
+  const Block<EsdfCachingVoxel>* cached_blocks_[kBlockCacheSize];
+  size_t num_cached_ = 0u;
+  size_t next_slot_ = 0u;
+};
+
+constexpr size_t BlockLookupCache::kBlockCacheSize;
+
+/**
+ * Block of a voxel. Computed from the voxel center, which is half a voxel away
+ * from the block borders, so rounding errors can't move it to a neighbor.
+ */
+inline BlockIndex getBlockIndexOfVoxel(const Layer<EsdfCachingVoxel>& layer,
+                                       const GlobalIndex& global_index) {
+  return getGridIndexFromPoint<BlockIndex>(
+      getCenterPointFromGridIndex(global_index, layer.voxel_size()),
+      layer.block_size_inv());
+}
+
+/**
+ * Fetches the distances of the eight voxels of the cell with the given lower
+ * corner. They usually lie in the block of the lower corner and are indexed
+ * directly. At block seams the upper voxels along an axis lie in the next
+ * block, so up to eight blocks are involved. Returns false if one of the
+ * blocks is not allocated.
+ */
+bool getCellCorners(const Layer<EsdfCachingVoxel>& layer,
+                    const GlobalIndex& lower_index,
+                    BlockLookupCache* block_cache,
+                    CellCorners* corner_distances) {
+  const IndexElement voxels_per_side = layer.voxels_per_side();
+  const BlockIndex block_index = getBlockIndexOfVoxel(layer, lower_index);
+  const VoxelIndex voxel_index =
+      (lower_index - block_index.cast<LongIndexElement>() * voxels_per_side)
+          .cast<IndexElement>();
+
+  if ((voxel_index.array() < voxels_per_side - 1).all()) {
+    const Block<EsdfCachingVoxel>* block_ptr =
+        block_cache->getBlockPtrByIndex(block_index);
+    if (block_ptr == nullptr) {
+      return false;
+    }
+    const size_t stride_y = voxels_per_side;
+    const size_t stride_z = stride_y * voxels_per_side;
+    const size_t lower_linear_index = voxel_index.x() +
+                                      stride_y * voxel_index.y() +
+                                      stride_z * voxel_index.z();
+    for (int c = 0; c < 8; ++c) {
+      (*corner_distances)(c) =
+          block_ptr
+              ->getVoxelByLinearIndex(lower_linear_index + (c >> 2) +
+                                      stride_y * ((c >> 1) & 1) +
+                                      stride_z * (c & 1))
+              .distance;
+    }
+    return true;
+  }
+
+  // Linear index offsets of the lower and upper voxel along each axis, and
+  // whether the upper one lies in the next block.
+  size_t offsets[3][2];
+  int next_block[3];
+  size_t stride = 1u;
+  for (int dim = 0; dim < 3; ++dim) {
+    offsets[dim][0] = stride * voxel_index(dim);
+    next_block[dim] = voxel_index(dim) + 1 < voxels_per_side ? 0 : 1;
+    offsets[dim][1] = next_block[dim] ? 0u : offsets[dim][0] + stride;
+    stride *= voxels_per_side;
+  }
+
+  const Block<EsdfCachingVoxel>* blocks[8] = {nullptr};
+  for (int c = 0; c < 8; ++c) {
+    const int x = c >> 2;
+    const int y = (c >> 1) & 1;
+    const int z = c & 1;
+    const int b = ((x & next_block[0]) << 2) | ((y & next_block[1]) << 1) |
+                  (z & next_block[2]);
+    if (blocks[b] == nullptr) {
+      blocks[b] = block_cache->getBlockPtrByIndex(
+          block_index + BlockIndex(b >> 2, (b >> 1) & 1, b & 1));
+      if (blocks[b] == nullptr) {
+        return false;
+      }
+    }
+    (*corner_distances)(c) =
+        blocks[b]
+            ->getVoxelByLinearIndex(offsets[0][x] + offsets[1][y] +
+                                    offsets[2][z])
+            .distance;
+  }
+  return true;
+}
+
+/**
+ * Expansion of the voxel containing pos with its cached gradient, used where
+ * the trilinear cell reaches into unallocated blocks at the border of the map.
+ */
+bool getContainingVoxelDistanceGradient(const Point& pos,
+                                        BlockLookupCache* block_cache,
+                                        FloatingPoint* distance,
+                                        Point* gradient) {
+  const Block<EsdfCachingVoxel>* block_ptr = block_cache->getBlockPtr(pos);
+  if (block_ptr == nullptr) {
+    return false;
+  }
+  const VoxelIndex voxel_index =
+      block_ptr->computeTruncatedVoxelIndexFromCoordinates(pos);
+  const EsdfCachingVoxel& voxel = block_ptr->getVoxelByVoxelIndex(voxel_index);
+  const Point offset =
+      pos - block_ptr->computeCoordinatesFromVoxelIndex(voxel_index);
+  *distance = voxel.distance + voxel.gradient.dot(offset);
+  *gradient = voxel.gradient;
+  return true;
+}
+
+/// Voxel centers lie at (index + 0.5) * voxel_size.
+inline Point getScaledCellPosition(const Layer<EsdfCachingVoxel>& layer,
+                                   const Point& pos, GlobalIndex* lower_index) {
+  const Point scaled_pos =
+      pos * layer.voxel_size_inv() - Point::Constant(0.5f);
+  *lower_index = GlobalIndex(std::floor(scaled_pos.x()),
+                             std::floor(scaled_pos.y()),
+                             std::floor(scaled_pos.z()));
+  return scaled_pos;
+}
+
+bool getTrilinearDistanceGradientFromLayer(
+    const Layer<EsdfCachingVoxel>& layer, const Point& pos,
+    BlockLookupCache* block_cache, FloatingPoint* distance, Point* gradient) {
+  GlobalIndex lower_index;
+  const Point scaled_pos = getScaledCellPosition(layer, pos, &lower_index);
+  CellCorners corner_distances;
+  if (getCellCorners(layer, lower_index, block_cache, &corner_distances)) {
+    *distance = interpolateTrilinear(
+        corner_distances, scaled_pos - lower_index.cast<FloatingPoint>(),
+        layer.voxel_size_inv(), gradient);
+    return true;
+  }
+  return getContainingVoxelDistanceGradient(pos, block_cache, distance,
+                                            gradient);
+}
+
+/**
+ * Same as getTrilinearDistanceGradientFromLayer(), but takes the corners from
+ * the cell cached for the lower corner voxel. That cell and its block are the
+ * only ones read, also at block seams.
+ */
+bool getTrilinearDistanceGradientFromCachedCell(
+    const Layer<EsdfCachingVoxel>& layer, const Point& pos,
+    BlockLookupCache* block_cache, FloatingPoint* distance, Point* gradient) {
+  GlobalIndex lower_index;
+  const Point scaled_pos = getScaledCellPosition(layer, pos, &lower_index);
+  const BlockIndex block_index = getBlockIndexOfVoxel(layer, lower_index);
+  const Block<EsdfCachingVoxel>* block_ptr =
+      block_cache->getBlockPtrByIndex(block_index);
+  if (block_ptr != nullptr && block_ptr->trilinear_cells() != nullptr) {
+    const LongIndexElement vps =
+        static_cast<LongIndexElement>(layer.voxels_per_side());
+    const VoxelIndex voxel_index =
+        (lower_index - block_index.cast<LongIndexElement>() * vps)
+            .cast<IndexElement>();
+    const TrilinearCell& cell =
+        block_ptr->trilinear_cells()[block_ptr->computeLinearIndexFromVoxelIndex(
+            voxel_index)];
+    if (cell.valid) {
+      *distance = interpolateTrilinear(
+          cell.corners, scaled_pos - lower_index.cast<FloatingPoint>(),
+          layer.voxel_size_inv(), gradient);
+      return true;
+    }
+  }
+  return getContainingVoxelDistanceGradient(pos, block_cache, distance,
+                                            gradient);
+}
+
+/**
+ * Runs getTrilinearDistanceGradientFromCachedCell() or
+ * getTrilinearDistanceGradientFromLayer() on all columns of positions.
+ */
+template <bool kFromCells>
+size_t queryTrilinearDistancesGradients(
+    const Layer<EsdfCachingVoxel>& layer, const PointsMatrix& positions,
+    Interpolator<EsdfCachingVoxel>::DistanceVector* distances,
+    PointsMatrix* gradients,
+    Interpolator<EsdfCachingVoxel>::ValidityVector* valid) {
+  CHECK_NOTNULL(distances);
+  CHECK_NOTNULL(gradients);
+  CHECK_NOTNULL(valid);
+  const Eigen::Index num_points = positions.cols();
+  if (distances->size() != num_points) {
+    distances->resize(num_points);
+  }
+  if (gradients->cols() != num_points) {
+    gradients->resize(Eigen::NoChange, num_points);
+  }
+  if (valid->size() != num_points) {
+    valid->resize(num_points);
+  }
+
+  BlockLookupCache block_cache(&layer);
+  size_t num_valid = 0u;
+  for (Eigen::Index i = 0; i < num_points; ++i) {
+    Point gradient;
+    FloatingPoint* distance = &(*distances)(i);
+    (*valid)(i) = kFromCells ? getTrilinearDistanceGradientFromCachedCell(
+                                   layer, positions.col(i), &block_cache,
+                                   distance, &gradient)
+                             : getTrilinearDistanceGradientFromLayer(
+                                   layer, positions.col(i), &block_cache,
+                                   distance, &gradient);
+    if ((*valid)(i)) {
+      gradients->col(i) = gradient;
+      ++num_valid;
+    }
+  }
+  return num_valid;
+}
+
+}  // namespace
+
 template <>
 bool Interpolator<EsdfCachingVoxel>::getInterpolatedDistanceGradient(
     const Point& pos, FloatingPoint* distance, Point* gradient) const {
-  typename Layer<EsdfCachingVoxel>::BlockType::ConstPtr block_ptr =
-      layer_->getBlockPtrByCoordinates(pos);
+  const Block<EsdfCachingVoxel>* block_ptr =
+      layer_->getBlockRawPtrByCoordinates(pos);
   if (block_ptr == nullptr) {
     return false;
   }
@@ -32,8 +292,8 @@ bool Interpolator<EsdfCachingVoxel>::getInterpolatedDistanceGradient(
 template <>
 bool Interpolator<EsdfCachingVoxel>::getInterpolatedDistanceGradientFromHessian(
     const Point& pos, FloatingPoint* distance, Point* gradient) const {
-  typename Layer<EsdfCachingVoxel>::BlockType::ConstPtr block_ptr =
-      layer_->getBlockPtrByCoordinates(pos);
+  const Block<EsdfCachingVoxel>* block_ptr =
+      layer_->getBlockRawPtrByCoordinates(pos);
   if (block_ptr == nullptr) {
     return false;
   }
@@ -46,9 +306,10 @@ bool Interpolator<EsdfCachingVoxel>::getInterpolatedDistanceGradientFromHessian(
   if (voxel_ptr) {
     float_t voxelSizeInv = block_ptr->voxel_size_inv();
     Point offset = (pos - voxel_pos);
+    const Eigen::Matrix3f hessian = voxel_ptr->getHessian();
     *distance = voxel_ptr->distance + voxel_ptr->gradient.dot(offset) +
-                0.5 * offset.dot(voxel_ptr->hessian * offset);
-    *gradient = voxel_ptr->gradient + voxel_ptr->hessian * offset;
+                0.5 * offset.dot(hessian * offset);
+    *gradient = voxel_ptr->gradient + hessian * offset;
     return true;
   }
   return false;
@@ -57,8 +318,8 @@ bool Interpolator<EsdfCachingVoxel>::getInterpolatedDistanceGradientFromHessian(
 template <>
 bool Interpolator<EsdfCachingVoxel>::getInterpolatedGradient(
     const Point& pos, Point* grad) const {
-  typename Layer<EsdfCachingVoxel>::BlockType::ConstPtr block_ptr =
-      layer_->getBlockPtrByCoordinates(pos);
+  const Block<EsdfCachingVoxel>* block_ptr =
+      layer_->getBlockRawPtrByCoordinates(pos);
   if (block_ptr == nullptr) {
     return false;
   }
@@ -71,7 +332,7 @@ bool Interpolator<EsdfCachingVoxel>::getInterpolatedGradient(
   if (voxel_ptr) {
     float_t voxelSizeInv = block_ptr->voxel_size_inv();
     Point offset = (pos - voxel_pos);
-    *grad = voxel_ptr->gradient + voxel_ptr->hessian * offset;
+    *grad = voxel_ptr->gradient + voxel_ptr->getHessian() * offset;
     return true;
   }
   return false;
@@ -80,8 +341,8 @@ bool Interpolator<EsdfCachingVoxel>::getInterpolatedGradient(
 template <>
 bool Interpolator<EsdfCachingVoxel>::getInterpolatedDistance(
     const Point& pos, FloatingPoint* distance) const {
-  typename Layer<EsdfCachingVoxel>::BlockType::ConstPtr block_ptr =
-      layer_->getBlockPtrByCoordinates(pos);
+  const Block<EsdfCachingVoxel>* block_ptr =
+      layer_->getBlockRawPtrByCoordinates(pos);
   if (block_ptr == nullptr) {
     return false;
   }
@@ -98,4 +359,137 @@ bool Interpolator<EsdfCachingVoxel>::getInterpolatedDistance(
     return true;
   }
   return false;
-}
\ No newline at end of file
+}
+
+template <>
+size_t Interpolator<EsdfCachingVoxel>::getInterpolatedDistancesGradients(
+    const PointsMatrix& positions, DistanceVector* distances,
+    PointsMatrix* gradients, ValidityVector* valid) const {
+  CHECK_NOTNULL(distances);
+  CHECK_NOTNULL(gradients);
+  CHECK_NOTNULL(valid);
+  const Eigen::Index num_points = positions.cols();
+  if (distances->size() != num_points) {
+    distances->resize(num_points);
+  }
+  if (gradients->cols() != num_points) {
+    gradients->resize(Eigen::NoChange, num_points);
+  }
+  if (valid->size() != num_points) {
+    valid->resize(num_points);
+  }
+
+  BlockLookupCache block_cache(layer_);
+  size_t num_valid = 0u;
+  for (Eigen::Index i = 0; i < num_points; ++i) {
+    const Point pos = positions.col(i);
+    const Block<EsdfCachingVoxel>* block_ptr = block_cache.getBlockPtr(pos);
+    if (block_ptr == nullptr) {
+      (*valid)(i) = false;
+      continue;
+    }
+
+    const VoxelIndex voxel_index =
+        block_ptr->computeTruncatedVoxelIndexFromCoordinates(pos);
+    const Point voxel_pos =
+        block_ptr->computeCoordinatesFromVoxelIndex(voxel_index);
+    const EsdfCachingVoxel& voxel =
+        block_ptr->getVoxelByVoxelIndex(voxel_index);
+
+    (*distances)(i) = voxel.distance + voxel.gradient.dot(pos - voxel_pos);
+    gradients->col(i) = voxel.gradient;
+    (*valid)(i) = true;
+    ++num_valid;
+  }
+  return num_valid;
+}
+
+template <>
+size_t
+Interpolator<EsdfCachingVoxel>::getInterpolatedDistancesGradientsFromHessians(
+    const PointsMatrix& positions, DistanceVector* distances,
+    PointsMatrix* gradients, SymmetricMatrices* hessians,
+    ValidityVector* valid) const {
+  CHECK_NOTNULL(distances);
+  CHECK_NOTNULL(gradients);
+  CHECK_NOTNULL(hessians);
+  CHECK_NOTNULL(valid);
+  const Eigen::Index num_points = positions.cols();
+  if (distances->size() != num_points) {
+    distances->resize(num_points);
+  }
+  if (gradients->cols() != num_points) {
+    gradients->resize(Eigen::NoChange, num_points);
+  }
+  if (hessians->cols() != num_points) {
+    hessians->resize(Eigen::NoChange, num_points);
+  }
+  if (valid->size() != num_points) {
+    valid->resize(num_points);
+  }
+
+  BlockLookupCache block_cache(layer_);
+  size_t num_valid = 0u;
+  for (Eigen::Index i = 0; i < num_points; ++i) {
+    const Point pos = positions.col(i);
+    const Block<EsdfCachingVoxel>* block_ptr = block_cache.getBlockPtr(pos);
+    if (block_ptr == nullptr) {
+      (*valid)(i) = false;
+      continue;
+    }
+
+    const VoxelIndex voxel_index =
+        block_ptr->computeTruncatedVoxelIndexFromCoordinates(pos);
+    const Point offset =
+        pos - block_ptr->computeCoordinatesFromVoxelIndex(voxel_index);
+    const EsdfCachingVoxel& voxel =
+        block_ptr->getVoxelByVoxelIndex(voxel_index);
+    const Eigen::Matrix3f hessian = voxel.getHessian();
+
+    (*distances)(i) = voxel.distance + voxel.gradient.dot(offset) +
+                      0.5f * offset.dot(hessian * offset);
+    gradients->col(i) = voxel.gradient + hessian * offset;
+    hessians->col(i) = voxel.hessian;
+    (*valid)(i) = true;
+    ++num_valid;
+  }
+  return num_valid;
+}
+
+template <>
+bool Interpolator<EsdfCachingVoxel>::getTrilinearDistanceGradient(
+    const Point& pos, FloatingPoint* distance, Point* gradient) const {
+  CHECK_NOTNULL(distance);
+  CHECK_NOTNULL(gradient);
+  BlockLookupCache block_cache(layer_);
+  return getTrilinearDistanceGradientFromLayer(*layer_, pos, &block_cache,
+                                               distance, gradient);
+}
+
+template <>
+size_t Interpolator<EsdfCachingVoxel>::getTrilinearDistancesGradients(
+    const PointsMatrix& positions, DistanceVector* distances,
+    PointsMatrix* gradients, ValidityVector* valid) const {
+  constexpr bool kFromCells = false;
+  return queryTrilinearDistancesGradients<kFromCells>(
+      *layer_, positions, distances, gradients, valid);
+}
+
+template <>
+bool Interpolator<EsdfCachingVoxel>::getTrilinearDistanceGradientFromCell(
+    const Point& pos, FloatingPoint* distance, Point* gradient) const {
+  CHECK_NOTNULL(distance);
+  CHECK_NOTNULL(gradient);
+  BlockLookupCache block_cache(layer_);
+  return getTrilinearDistanceGradientFromCachedCell(*layer_, pos, &block_cache,
+                                                    distance, gradient);
+}
+
+template <>
+size_t Interpolator<EsdfCachingVoxel>::getTrilinearDistancesGradientsFromCells(
+    const PointsMatrix& positions, DistanceVector* distances,
+    PointsMatrix* gradients, ValidityVector* valid) const {
+  constexpr bool kFromCells = true;
+  return queryTrilinearDistancesGradients<kFromCells>(
+      *layer_, positions, distances, gradients, valid);
+}
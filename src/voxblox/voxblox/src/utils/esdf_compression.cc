@@ -0,0 +1,93 @@
+#include "voxblox/utils/esdf_compression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace voxblox {
+
+namespace {
+
+constexpr size_t kMaxRunLength = 0xFFFFu;
+
+inline uint32_t packRun(uint16_t symbol, size_t run_length) {
+  return (static_cast<uint32_t>(run_length) << 16) | symbol;
+}
+
+}  // namespace
+
+void compressEsdfBlock(const Block<EsdfVoxel>& block,
+                       std::vector<uint32_t>* data) {
+  CHECK_NOTNULL(data);
+  data->clear();
+
+  FloatingPoint max_distance = 0.0f;
+  for (size_t i = 0u; i < block.num_voxels(); ++i) {
+    max_distance = std::max(max_distance,
+                            std::abs(block.getVoxelByLinearIndex(i).distance));
+  }
+  const float step =
+      max_distance > 0.0f ? max_distance / esdf_compression::kMaxEsdfCode
+                          : 1.0f;
+  const float step_inv = 1.0f / step;
+
+  uint32_t step_word;
+  memcpy(&step_word, &step, sizeof(step));
+  data->push_back(step_word);
+
+  uint16_t run_symbol = 0u;
+  size_t run_length = 0u;
+  for (size_t i = 0u; i < block.num_voxels(); ++i) {
+    const EsdfVoxel& voxel = block.getVoxelByLinearIndex(i);
+    int code = static_cast<int>(std::round(voxel.distance * step_inv));
+    code = std::max(-esdf_compression::kMaxEsdfCode,
+                    std::min(esdf_compression::kMaxEsdfCode, code));
+    const uint16_t symbol =
+        static_cast<uint16_t>(2 * code) | (voxel.observed ? 1u : 0u);
+
+    if (run_length > 0u &&
+        (symbol != run_symbol || run_length == kMaxRunLength)) {
+      data->push_back(packRun(run_symbol, run_length));
+      run_length = 0u;
+    }
+    run_symbol = symbol;
+    ++run_length;
+  }
+  if (run_length > 0u) {
+    data->push_back(packRun(run_symbol, run_length));
+  }
+}
+
+bool decompressEsdfBlock(const std::vector<uint32_t>& data,
+                         Block<EsdfVoxel>* block) {
+  CHECK_NOTNULL(block);
+  if (data.empty()) {
+    return false;
+  }
+  float step;
+  memcpy(&step, &data[0], sizeof(step));
+
+  const size_t num_voxels = block->num_voxels();
+  size_t voxel_idx = 0u;
+  bool has_data = false;
+  for (size_t data_idx = 1u; data_idx < data.size(); ++data_idx) {
+    const uint16_t symbol = static_cast<uint16_t>(data[data_idx] & 0xFFFFu);
+    const size_t run_length = data[data_idx] >> 16;
+    if (run_length > num_voxels - voxel_idx) {
+      return false;
+    }
+
+    EsdfVoxel decoded;
+    decoded.distance =
+        step * static_cast<float>(static_cast<int16_t>(symbol & 0xFFFEu) / 2);
+    decoded.observed = (symbol & 1u) != 0u;
+    has_data |= decoded.observed;
+    for (size_t i = 0u; i < run_length; ++i, ++voxel_idx) {
+      block->getVoxelByLinearIndex(voxel_idx) = decoded;
+    }
+  }
+  block->has_data() = has_data;
+  return voxel_idx == num_voxels;
+}
+
+}  // namespace voxblox
@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+
+#include <glog/logging.h>
+
+#include "voxblox/core/block_hash.h"
+#include "voxblox/core/common.h"
+#include "voxblox/core/flat_index_hash_map.h"
+#include "voxblox/core/layer.h"
+#include "voxblox/core/voxel.h"
+#include "voxblox/integrator/esdf_integrator.h"
+#include "voxblox/integrator/tsdf_integrator.h"
+
+using namespace voxblox;  // NOLINT
+
+/**
+ * Compares the block maps and times the block lookups and the integrators of
+ * a layer. The layer uses whichever map BlockHashMapType selects, build with
+ * and without VOXBLOX_NODE_BASED_BLOCK_MAP to compare the integrators.
+ */
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double millisecondsSince(const Clock::time_point& start_time) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start_time)
+      .count();
+}
+
+constexpr int kNumTrials = 5;
+
+/// Looks up all keys num_repetitions times, returns the best Mlookups/s.
+template <typename MapType>
+double measureMapLookups(const MapType& map, const BlockIndexList& keys,
+                         size_t num_repetitions) {
+  double best_rate = 0.0;
+  for (int trial = 0; trial < kNumTrials; ++trial) {
+    size_t num_found = 0u;
+    const Clock::time_point start_time = Clock::now();
+    for (size_t r = 0u; r < num_repetitions; ++r) {
+      for (const BlockIndex& key : keys) {
+        typename MapType::const_iterator it = map.find(key);
+        if (it != map.end() && it->second != nullptr) {
+          ++num_found;
+        }
+      }
+    }
+    const double milliseconds = millisecondsSince(start_time);
+    CHECK_GT(num_found, 0u);
+    best_rate = std::max(
+        best_rate, 1e-3 * num_repetitions * keys.size() / milliseconds);
+  }
+  return best_rate;
+}
+
+/// Same for Layer::getBlockPtrByCoordinates().
+template <typename VoxelType>
+double measureLayerLookups(const Layer<VoxelType>& layer,
+                           const Pointcloud& points, size_t num_repetitions) {
+  double best_rate = 0.0;
+  for (int trial = 0; trial < kNumTrials; ++trial) {
+    size_t num_found = 0u;
+    const Clock::time_point start_time = Clock::now();
+    for (size_t r = 0u; r < num_repetitions; ++r) {
+      for (const Point& point : points) {
+        if (layer.getBlockPtrByCoordinates(point) != nullptr) {
+          ++num_found;
+        }
+      }
+    }
+    const double milliseconds = millisecondsSince(start_time);
+    CHECK_GT(num_found, 0u);
+    best_rate = std::max(
+        best_rate, 1e-3 * num_repetitions * points.size() / milliseconds);
+  }
+  return best_rate;
+}
+
+/// Points on the walls, floor and ceiling of a box shaped room.
+Pointcloud getRoomPointcloud(FloatingPoint half_size, FloatingPoint height,
+                             FloatingPoint spacing) {
+  Pointcloud points;
+  for (FloatingPoint a = -half_size; a <= half_size; a += spacing) {
+    for (FloatingPoint b = -half_size; b <= half_size; b += spacing) {
+      points.emplace_back(a, b, 0.0f);
+      points.emplace_back(a, b, height);
+    }
+    for (FloatingPoint z = 0.0f; z <= height; z += spacing) {
+      points.emplace_back(a, -half_size, z);
+      points.emplace_back(a, half_size, z);
+      points.emplace_back(-half_size, a, z);
+      points.emplace_back(half_size, a, z);
+    }
+  }
+  return points;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+
+  const size_t num_repetitions = argc > 1 ? std::stoul(argv[1]) : 200u;
+
+#ifdef VOXBLOX_NODE_BASED_BLOCK_MAP
+  std::cout << "Layer block map: std::unordered_map" << std::endl;
+#else
+  std::cout << "Layer block map: FlatIndexHashMap" << std::endl;
+#endif
+
+  // Map lookups, half of the queried keys are allocated.
+  typedef std::shared_ptr<Block<EsdfCachingVoxel> > BlockPtr;
+  AnyIndexHashMapType<BlockPtr>::type node_map;
+  FlatIndexHashMap<BlockPtr> flat_map;
+  constexpr IndexElement kHalfBlocks = 8;
+  for (IndexElement x = -kHalfBlocks; x < kHalfBlocks; ++x) {
+    for (IndexElement y = -kHalfBlocks; y < kHalfBlocks; ++y) {
+      for (IndexElement z = -kHalfBlocks; z < kHalfBlocks; z += 2) {
+        BlockPtr block = std::make_shared<Block<EsdfCachingVoxel> >(
+            8u, 0.05, Point::Zero());
+        node_map.emplace(BlockIndex(x, y, z), block);
+        flat_map.emplace(BlockIndex(x, y, z), block);
+      }
+    }
+  }
+  std::mt19937 generator(0u);
+  std::uniform_int_distribution<IndexElement> coordinate(-kHalfBlocks,
+                                                         kHalfBlocks - 1);
+  BlockIndexList keys(4096u);
+  for (BlockIndex& key : keys) {
+    key = BlockIndex(coordinate(generator), coordinate(generator),
+                     coordinate(generator));
+  }
+  std::cout << std::fixed << std::setprecision(2)
+            << "find, std::unordered_map:  "
+            << measureMapLookups(node_map, keys, num_repetitions)
+            << " Mlookups/s" << std::endl
+            << "find, FlatIndexHashMap:    "
+            << measureMapLookups(flat_map, keys, num_repetitions)
+            << " Mlookups/s" << std::endl;
+
+  // Layer lookups by coordinates around the robot.
+  Layer<EsdfCachingVoxel> esdf_layer(0.05, 8u);
+  for (const BlockIndex& key : keys) {
+    esdf_layer.allocateBlockPtrByIndex(key);
+  }
+  std::uniform_real_distribution<FloatingPoint> position(-1.0f, 1.0f);
+  Pointcloud points(4096u);
+  for (Point& point : points) {
+    point = Point(position(generator), position(generator),
+                  position(generator));
+  }
+  std::cout << "Layer::getBlockPtrByCoordinates: "
+            << measureLayerLookups(esdf_layer, points, num_repetitions)
+            << " Mlookups/s" << std::endl;
+
+  // Integrators.
+  Layer<TsdfVoxel> tsdf_layer(0.05, 16u);
+  TsdfIntegratorBase::Config tsdf_config;
+  tsdf_config.max_ray_length_m = 10.0;
+  SimpleTsdfIntegrator tsdf_integrator(tsdf_config, &tsdf_layer);
+  const Pointcloud room = getRoomPointcloud(3.0, 3.0, 0.04);
+  const Colors colors(room.size(), Color::Gray());
+
+  Clock::time_point start_time = Clock::now();
+  constexpr int kNumPoses = 4;
+  for (int i = 0; i < kNumPoses; ++i) {
+    Transformation T_G_C;
+    T_G_C.getPosition() = Point(0.5f * i - 1.0f, 0.2f * i, 1.5f);
+    Pointcloud points_C;
+    transformPointcloud(T_G_C.inverse(), room, &points_C);
+    tsdf_integrator.integratePointCloud(T_G_C, points_C, colors);
+  }
+  std::cout << "SimpleTsdfIntegrator: " << millisecondsSince(start_time) /
+                                               kNumPoses
+            << " ms per cloud of " << room.size() << " points, "
+            << tsdf_layer.getNumberOfAllocatedBlocks() << " blocks"
+            << std::endl;
+
+  Layer<EsdfVoxel> esdf_batch_layer(0.05, 16u);
+  EsdfIntegrator esdf_integrator(EsdfIntegrator::Config(), &tsdf_layer,
+                                 &esdf_batch_layer);
+  start_time = Clock::now();
+  esdf_integrator.updateFromTsdfLayerBatch();
+  std::cout << "EsdfIntegrator::updateFromTsdfLayerBatch: "
+            << millisecondsSince(start_time) << " ms" << std::endl;
+  return 0;
+}
@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "voxblox/core/esdf_window.h"
+#include "voxblox/core/layer.h"
+#include "voxblox/core/voxel.h"
+#include "voxblox/interpolator/interpolator.h"
+
+using namespace voxblox;  // NOLINT
+
+/**
+ * Measures the throughput of concurrent read-only block lookups in an ESDF
+ * caching layer, as done by the SLQ worker threads querying the collision
+ * cost. All threads query points in the same few blocks around the origin.
+ * Compares the shared pointer lookup, the borrowed pointer lookup and the
+ * full interpolated distance and gradient query. Finally compares the batched
+ * first order and trilinear queries of the interpolator, with and without
+ * cached trilinear cells, to the ones of an EsdfWindow around the origin.
+ */
+
+namespace {
+
+constexpr FloatingPoint kVoxelSize = 0.05;
+constexpr size_t kVoxelsPerSide = 16u;
+// Blocks are allocated in [-kHalfBlocks, kHalfBlocks)^3.
+constexpr IndexElement kHalfBlocks = 4;
+
+void setUpLayer(Layer<EsdfCachingVoxel>* layer) {
+  for (IndexElement x = -kHalfBlocks; x < kHalfBlocks; ++x) {
+    for (IndexElement y = -kHalfBlocks; y < kHalfBlocks; ++y) {
+      for (IndexElement z = -kHalfBlocks; z < kHalfBlocks; ++z) {
+        Block<EsdfCachingVoxel>::Ptr block =
+            layer->allocateBlockPtrByIndex(BlockIndex(x, y, z));
+        for (size_t i = 0u; i < block->num_voxels(); ++i) {
+          EsdfCachingVoxel& voxel = block->getVoxelByLinearIndex(i);
+          const Point position = block->computeCoordinatesFromLinearIndex(i);
+          voxel.distance = position.norm() - 0.5f;
+          voxel.gradient = position.normalized();
+          voxel.observed = true;
+        }
+        block->has_data() = true;
+      }
+    }
+  }
+}
+
+/// Runs query(point) on all points from num_threads threads, in Mqueries/s.
+template <typename Query>
+double measureThroughput(const std::vector<Point>& points, size_t num_threads,
+                         size_t num_repetitions, const Query& query) {
+  std::atomic<size_t> num_ready(0u);
+  std::atomic<bool> start(false);
+  std::atomic<FloatingPoint> checksum(0.0f);
+
+  std::vector<std::thread> threads;
+  for (size_t t = 0u; t < num_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      num_ready++;
+      while (!start) {
+      }
+      FloatingPoint sum = 0.0f;
+      for (size_t r = 0u; r < num_repetitions; ++r) {
+        // Offset per thread, so the threads don't walk in lockstep.
+        for (size_t i = 0u; i < points.size(); ++i) {
+          sum += query(points[(i + t * 97u) % points.size()]);
+        }
+      }
+      FloatingPoint expected = checksum.load();
+      while (!checksum.compare_exchange_weak(expected, expected + sum)) {
+      }
+    });
+  }
+  while (num_ready < num_threads) {
+  }
+  const auto start_time = std::chrono::steady_clock::now();
+  start = true;
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start_time)
+                             .count();
+  CHECK(std::isfinite(checksum.load()));
+  return 1e-6 * num_threads * num_repetitions * points.size() / seconds;
+}
+
+/// Runs the batched query(positions) on one thread, in Mqueries/s.
+template <typename BatchQuery>
+double measureBatchThroughput(const PointsMatrix& positions,
+                              size_t num_repetitions,
+                              const BatchQuery& query) {
+  size_t num_valid = 0u;
+  const auto start_time = std::chrono::steady_clock::now();
+  for (size_t r = 0u; r < num_repetitions; ++r) {
+    num_valid += query(positions);
+  }
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start_time)
+                             .count();
+  CHECK_GT(num_valid, 0u);
+  return 1e-6 * num_repetitions * positions.cols() / seconds;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+
+  const size_t max_threads =
+      argc > 1 ? std::stoul(argv[1])
+               : std::max(2u, std::thread::hardware_concurrency());
+  const size_t num_repetitions = argc > 2 ? std::stoul(argv[2]) : 200u;
+
+  Layer<EsdfCachingVoxel> layer(kVoxelSize, kVoxelsPerSide);
+  setUpLayer(&layer);
+  layer.cacheTrilinearCells();
+  const Interpolator<EsdfCachingVoxel> interpolator(&layer);
+
+  // Query points of a robot close to the origin, spread over a few blocks.
+  std::mt19937 generator(0u);
+  std::uniform_real_distribution<FloatingPoint> distribution(-1.0f, 1.0f);
+  std::vector<Point> points(4096u);
+  for (Point& point : points) {
+    point = Point(distribution(generator), distribution(generator),
+                  distribution(generator));
+  }
+
+  const auto shared_lookup = [&layer](const Point& pos) {
+    Block<EsdfCachingVoxel>::ConstPtr block_ptr =
+        layer.getBlockPtrByCoordinates(pos);
+    return block_ptr->getVoxelByCoordinates(pos).distance;
+  };
+  const auto borrowed_lookup = [&layer](const Point& pos) {
+    const Block<EsdfCachingVoxel>* block_ptr =
+        layer.getBlockRawPtrByCoordinates(pos);
+    return block_ptr->getVoxelByCoordinates(pos).distance;
+  };
+  const auto interpolated_query = [&interpolator](const Point& pos) {
+    FloatingPoint distance = 0.0f;
+    Point gradient;
+    interpolator.getInterpolatedDistanceGradient(pos, &distance, &gradient);
+    return distance;
+  };
+
+  std::cout << "threads  shared_ptr  borrowed  interpolated  [Mqueries/s]"
+            << std::endl;
+  for (size_t num_threads = 1u; num_threads <= max_threads;
+       num_threads *= 2u) {
+    std::cout << std::setw(7) << num_threads << std::fixed
+              << std::setprecision(2) << std::setw(12)
+              << measureThroughput(points, num_threads, num_repetitions,
+                                   shared_lookup)
+              << std::setw(10)
+              << measureThroughput(points, num_threads, num_repetitions,
+                                   borrowed_lookup)
+              << std::setw(14)
+              << measureThroughput(points, num_threads, num_repetitions,
+                                   interpolated_query)
+              << std::endl;
+  }
+
+  EsdfWindow window(kVoxelSize, 2u * kHalfBlocks * kVoxelsPerSide);
+  window.moveTo(layer, Point::Zero());
+  PointsMatrix positions(3, points.size());
+  for (size_t i = 0u; i < points.size(); ++i) {
+    positions.col(i) = points[i];
+  }
+  Interpolator<EsdfCachingVoxel>::DistanceVector distances;
+  PointsMatrix gradients;
+  Interpolator<EsdfCachingVoxel>::ValidityVector valid;
+  const auto interpolator_taylor = [&](const PointsMatrix& query_positions) {
+    return interpolator.getInterpolatedDistancesGradients(
+        query_positions, &distances, &gradients, &valid);
+  };
+  const auto interpolator_trilinear =
+      [&](const PointsMatrix& query_positions) {
+        return interpolator.getTrilinearDistancesGradients(
+            query_positions, &distances, &gradients, &valid);
+      };
+  const auto interpolator_cells = [&](const PointsMatrix& query_positions) {
+    return interpolator.getTrilinearDistancesGradientsFromCells(
+        query_positions, &distances, &gradients, &valid);
+  };
+  const auto window_taylor = [&](const PointsMatrix& query_positions) {
+    return window.getInterpolatedDistancesGradients(
+        query_positions, &distances, &gradients, &valid);
+  };
+  const auto window_trilinear = [&](const PointsMatrix& query_positions) {
+    return window.getTrilinearDistancesGradients(query_positions, &distances,
+                                                 &gradients, &valid);
+  };
+  std::cout << "batched, 1 thread      taylor  trilinear  cells  [Mqueries/s]"
+            << std::endl
+            << "interpolator     " << std::setw(12)
+            << measureBatchThroughput(positions, num_repetitions,
+                                      interpolator_taylor)
+            << std::setw(11)
+            << measureBatchThroughput(positions, num_repetitions,
+                                      interpolator_trilinear)
+            << std::setw(7)
+            << measureBatchThroughput(positions, num_repetitions,
+                                      interpolator_cells)
+            << std::endl
+            << "window           " << std::setw(12)
+            << measureBatchThroughput(positions, num_repetitions,
+                                      window_taylor)
+            << std::setw(11)
+            << measureBatchThroughput(positions, num_repetitions,
+                                      window_trilinear)
+            << std::endl;
+  return 0;
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include "voxblox/core/common.h"
+#include "voxblox/core/compact_esdf_layer.h"
+#include "voxblox/core/layer.h"
+#include "voxblox/core/voxel.h"
+#include "voxblox/interpolator/interpolator.h"
+
+using namespace voxblox;  // NOLINT
+
+class CompactEsdfLayerTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    layer_.reset(new Layer<EsdfCachingVoxel>(voxel_size_, voxels_per_side_));
+
+    for (int block_x = 0; block_x < 2; ++block_x) {
+      Block<EsdfCachingVoxel>::Ptr block_ptr =
+          layer_->allocateBlockPtrByIndex(BlockIndex(block_x, 0, 0));
+      for (size_t i = 0u; i < block_ptr->num_voxels(); ++i) {
+        const Point voxel_pos = block_ptr->computeCoordinatesFromLinearIndex(i);
+        EsdfCachingVoxel& voxel = block_ptr->getVoxelByLinearIndex(i);
+        voxel.distance = voxel_pos.x() * voxel_pos.x() +
+                         voxel_pos.y() * voxel_pos.z() + 0.1f;
+        voxel.observed = true;
+      }
+      block_ptr->has_data() = true;
+    }
+    layer_->cacheGradients();
+    layer_->cacheHessians();
+
+    positions_.resize(3, 5);
+    positions_.col(0) = Point(0.23f, 0.41f, 0.37f);
+    positions_.col(1) = Point(0.25f, 0.42f, 0.11f);
+    positions_.col(2) = Point(1.27f, 0.05f, 0.66f);
+    positions_.col(3) = Point(-0.5f, 0.2f, 0.2f);
+    positions_.col(4) = Point(0.77f, 0.33f, 0.42f);
+  }
+
+  std::unique_ptr<Layer<EsdfCachingVoxel>> layer_;
+  PointsMatrix positions_;
+
+  const float voxel_size_ = 0.1f;
+  const size_t voxels_per_side_ = 8u;
+  const float compare_tol_ = 1e-5f;
+};
+
+TEST_F(CompactEsdfLayerTest, MatchesInterpolator) {
+  CompactEsdfLayer compact_layer(voxel_size_, voxels_per_side_, false, true);
+  compact_layer.updateAllBlocks(*layer_);
+  EXPECT_EQ(compact_layer.getNumberOfAllocatedBlocks(), 2u);
+  EXPECT_LT(compact_layer.getMemorySize(), layer_->getMemorySize());
+
+  Interpolator<EsdfCachingVoxel> interpolator(layer_.get());
+  Interpolator<EsdfCachingVoxel>::DistanceVector expected_distances;
+  PointsMatrix expected_gradients;
+  Interpolator<EsdfCachingVoxel>::SymmetricMatrices expected_hessians;
+  Interpolator<EsdfCachingVoxel>::ValidityVector expected_valid;
+  interpolator.getInterpolatedDistancesGradientsFromHessians(
+      positions_, &expected_distances, &expected_gradients, &expected_hessians,
+      &expected_valid);
+
+  CompactEsdfLayer::DistanceVector distances;
+  PointsMatrix gradients;
+  CompactEsdfLayer::SymmetricMatrices hessians;
+  CompactEsdfLayer::ValidityVector valid;
+  EXPECT_EQ(compact_layer.getInterpolatedDistancesGradientsFromHessians(
+                positions_, &distances, &gradients, &hessians, &valid),
+            4u);
+  for (int i = 0; i < positions_.cols(); ++i) {
+    ASSERT_EQ(valid(i), expected_valid(i));
+    if (!valid(i)) {
+      continue;
+    }
+    EXPECT_NEAR(distances(i), expected_distances(i), compare_tol_);
+    EXPECT_NEAR((gradients.col(i) - expected_gradients.col(i)).norm(), 0.0f,
+                compare_tol_);
+    EXPECT_NEAR((hessians.col(i) - expected_hessians.col(i)).norm(), 0.0f,
+                compare_tol_);
+  }
+
+  interpolator.getInterpolatedDistancesGradients(
+      positions_, &expected_distances, &expected_gradients, &expected_valid);
+  EXPECT_EQ(compact_layer.getInterpolatedDistancesGradients(
+                positions_, &distances, &gradients, &valid),
+            4u);
+  for (int i = 0; i < positions_.cols(); ++i) {
+    if (valid(i)) {
+      EXPECT_NEAR(distances(i), expected_distances(i), compare_tol_);
+    }
+  }
+}
+
+TEST_F(CompactEsdfLayerTest, HalfPrecisionGradients) {
+  CompactEsdfLayer compact_layer(voxel_size_, voxels_per_side_, true, false);
+  compact_layer.updateAllBlocks(*layer_);
+  EXPECT_FALSE(compact_layer.has_hessians());
+
+  Interpolator<EsdfCachingVoxel> interpolator(layer_.get());
+  Interpolator<EsdfCachingVoxel>::DistanceVector expected_distances;
+  PointsMatrix expected_gradients;
+  Interpolator<EsdfCachingVoxel>::ValidityVector expected_valid;
+  interpolator.getInterpolatedDistancesGradients(
+      positions_, &expected_distances, &expected_gradients, &expected_valid);
+
+  CompactEsdfLayer::DistanceVector distances;
+  PointsMatrix gradients;
+  CompactEsdfLayer::ValidityVector valid;
+  compact_layer.getInterpolatedDistancesGradients(positions_, &distances,
+                                                  &gradients, &valid);
+  for (int i = 0; i < positions_.cols(); ++i) {
+    ASSERT_EQ(valid(i), expected_valid(i));
+    if (valid(i)) {
+      // Half precision keeps about 3 significant digits.
+      EXPECT_NEAR((gradients.col(i) - expected_gradients.col(i)).norm(), 0.0f,
+                  1e-2f);
+    }
+  }
+}
+
+TEST_F(CompactEsdfLayerTest, CopiesShareUnchangedBlocks) {
+  CompactEsdfLayer compact_layer(voxel_size_, voxels_per_side_, false, false);
+  compact_layer.updateAllBlocks(*layer_);
+
+  CompactEsdfLayer updated_layer(compact_layer);
+  BlockIndexList updated_blocks;
+  updated_blocks.push_back(BlockIndex(1, 0, 0));
+  updated_layer.updateBlocks(*layer_, updated_blocks);
+
+  EXPECT_EQ(updated_layer.getBlockPtrByIndex(BlockIndex(0, 0, 0)),
+            compact_layer.getBlockPtrByIndex(BlockIndex(0, 0, 0)));
+  EXPECT_NE(updated_layer.getBlockPtrByIndex(BlockIndex(1, 0, 0)),
+            compact_layer.getBlockPtrByIndex(BlockIndex(1, 0, 0)));
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  google::InitGoogleLogging(argv[0]);
+
+  int result = RUN_ALL_TESTS();
+
+  return result;
+}
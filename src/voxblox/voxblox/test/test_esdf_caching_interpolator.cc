@@ -0,0 +1,365 @@
+#include <gtest/gtest.h>
+
+#include "voxblox/core/common.h"
+#include "voxblox/core/layer.h"
+#include "voxblox/core/voxel.h"
+#include "voxblox/interpolator/interpolator.h"
+
+using namespace voxblox;  // NOLINT
+
+class EsdfCachingInterpolatorTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    layer_.reset(new Layer<EsdfCachingVoxel>(voxel_size_, voxels_per_side_));
+
+    // Two blocks next to each other along x, distance increases along x.
+    for (int block_x = 0; block_x < 2; ++block_x) {
+      Block<EsdfCachingVoxel>::Ptr block_ptr =
+          layer_->allocateBlockPtrByIndex(BlockIndex(block_x, 0, 0));
+      for (size_t i = 0u; i < block_ptr->num_voxels(); ++i) {
+        const Point voxel_pos = block_ptr->computeCoordinatesFromLinearIndex(i);
+        EsdfCachingVoxel& voxel = block_ptr->getVoxelByLinearIndex(i);
+        voxel.distance = 0.5f * voxel_pos.x() + 0.1f;
+        voxel.observed = true;
+      }
+      block_ptr->has_data() = true;
+    }
+    layer_->cacheGradients();
+  }
+
+  std::unique_ptr<Layer<EsdfCachingVoxel>> layer_;
+
+  const float voxel_size_ = 0.1f;
+  const size_t voxels_per_side_ = 8u;
+  const float compare_tol_ = 1e-5f;
+};
+
+TEST_F(EsdfCachingInterpolatorTest, BatchedMatchesSingleQueries) {
+  Interpolator<EsdfCachingVoxel> interpolator(layer_.get());
+
+  PointsMatrix positions(3, 6);
+  positions.col(0) = Point(0.23f, 0.41f, 0.37f);
+  positions.col(1) = Point(0.25f, 0.42f, 0.11f);
+  positions.col(2) = Point(1.27f, 0.05f, 0.66f);
+  // Outside of the allocated blocks.
+  positions.col(3) = Point(-0.5f, 0.2f, 0.2f);
+  positions.col(4) = Point(0.77f, 0.33f, 0.42f);
+  positions.col(5) = Point(0.3f, 5.0f, 0.2f);
+
+  Interpolator<EsdfCachingVoxel>::DistanceVector distances;
+  PointsMatrix gradients;
+  Interpolator<EsdfCachingVoxel>::ValidityVector valid;
+  const size_t num_valid = interpolator.getInterpolatedDistancesGradients(
+      positions, &distances, &gradients, &valid);
+
+  EXPECT_EQ(num_valid, 4u);
+  ASSERT_EQ(distances.size(), positions.cols());
+  ASSERT_EQ(gradients.cols(), positions.cols());
+  ASSERT_EQ(valid.size(), positions.cols());
+
+  for (int i = 0; i < positions.cols(); ++i) {
+    FloatingPoint distance;
+    Point gradient;
+    const bool single_valid = interpolator.getInterpolatedDistanceGradient(
+        positions.col(i), &distance, &gradient);
+    ASSERT_EQ(valid(i), single_valid) << "point " << i;
+    if (single_valid) {
+      EXPECT_NEAR(distances(i), distance, compare_tol_);
+      EXPECT_NEAR((gradients.col(i) - gradient).norm(), 0.0f, compare_tol_);
+    }
+  }
+}
+
+TEST_F(EsdfCachingInterpolatorTest, BatchedReusesBuffers) {
+  Interpolator<EsdfCachingVoxel> interpolator(layer_.get());
+
+  PointsMatrix positions(3, 2);
+  positions.col(0) = Point(0.23f, 0.41f, 0.37f);
+  positions.col(1) = Point(1.27f, 0.05f, 0.66f);
+
+  Interpolator<EsdfCachingVoxel>::DistanceVector distances(2);
+  PointsMatrix gradients(3, 2);
+  Interpolator<EsdfCachingVoxel>::ValidityVector valid(2);
+  const float* distances_data = distances.data();
+  const float* gradients_data = gradients.data();
+
+  interpolator.getInterpolatedDistancesGradients(positions, &distances,
+                                                 &gradients, &valid);
+  EXPECT_EQ(distances.data(), distances_data);
+  EXPECT_EQ(gradients.data(), gradients_data);
+  EXPECT_TRUE(valid.all());
+}
+
+TEST_F(EsdfCachingInterpolatorTest, IncrementalGradientsMatchFullUpdate) {
+  // Change the distances of the second block only.
+  Block<EsdfCachingVoxel>::Ptr block_ptr =
+      layer_->getBlockPtrByIndex(BlockIndex(1, 0, 0));
+  for (size_t i = 0u; i < block_ptr->num_voxels(); ++i) {
+    const Point voxel_pos = block_ptr->computeCoordinatesFromLinearIndex(i);
+    block_ptr->getVoxelByLinearIndex(i).distance =
+        0.5f * voxel_pos.x() - 0.25f * voxel_pos.z() + 0.1f;
+  }
+
+  // Deep copy, the implicit copy constructor would share the blocks.
+  Layer<EsdfCachingVoxel> full_layer(voxel_size_, voxels_per_side_);
+  BlockIndexList all_blocks;
+  layer_->getAllAllocatedBlocks(&all_blocks);
+  for (const BlockIndex& block_index : all_blocks) {
+    const Block<EsdfCachingVoxel>& block = layer_->getBlockByIndex(block_index);
+    Block<EsdfCachingVoxel>::Ptr full_block_ptr =
+        full_layer.allocateBlockPtrByIndex(block_index);
+    for (size_t i = 0u; i < block.num_voxels(); ++i) {
+      full_block_ptr->getVoxelByLinearIndex(i) =
+          block.getVoxelByLinearIndex(i);
+    }
+  }
+  full_layer.cacheGradients(1u);
+
+  BlockIndexList updated_blocks;
+  updated_blocks.push_back(BlockIndex(1, 0, 0));
+  layer_->cacheGradients(updated_blocks, 4u);
+
+  for (const BlockIndex& block_index : all_blocks) {
+    const Block<EsdfCachingVoxel>& block = layer_->getBlockByIndex(block_index);
+    const Block<EsdfCachingVoxel>& full_block =
+        full_layer.getBlockByIndex(block_index);
+    for (size_t i = 0u; i < block.num_voxels(); ++i) {
+      EXPECT_NEAR((block.getVoxelByLinearIndex(i).gradient -
+                   full_block.getVoxelByLinearIndex(i).gradient)
+                      .norm(),
+                  0.0f, compare_tol_);
+    }
+  }
+
+  // Interior voxels of the changed block see the new slope in z.
+  const EsdfCachingVoxel& voxel =
+      block_ptr->getVoxelByVoxelIndex(VoxelIndex(3, 3, 3));
+  EXPECT_NEAR(voxel.gradient.x(), 0.5f, compare_tol_);
+  EXPECT_NEAR(voxel.gradient.z(), -0.25f, compare_tol_);
+}
+
+TEST_F(EsdfCachingInterpolatorTest, CachedHessians) {
+  // Quadratic distance field, the central differences are exact.
+  BlockIndexList all_blocks;
+  layer_->getAllAllocatedBlocks(&all_blocks);
+  for (const BlockIndex& block_index : all_blocks) {
+    Block<EsdfCachingVoxel>& block = layer_->getBlockByIndex(block_index);
+    for (size_t i = 0u; i < block.num_voxels(); ++i) {
+      const Point voxel_pos = block.computeCoordinatesFromLinearIndex(i);
+      block.getVoxelByLinearIndex(i).distance =
+          voxel_pos.x() * voxel_pos.x() + voxel_pos.y() * voxel_pos.z();
+    }
+  }
+  layer_->cacheGradients();
+  layer_->cacheHessians(2u);
+
+  Eigen::Matrix3f expected_hessian;
+  expected_hessian << 2.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f;
+  // Interior voxel and a voxel on the border between the two blocks.
+  const Block<EsdfCachingVoxel>& block =
+      layer_->getBlockByIndex(BlockIndex(0, 0, 0));
+  EXPECT_TRUE(block.getVoxelByVoxelIndex(VoxelIndex(3, 3, 3))
+                  .getHessian()
+                  .isApprox(expected_hessian, 1e-3f));
+  EXPECT_TRUE(block.getVoxelByVoxelIndex(VoxelIndex(7, 3, 3))
+                  .getHessian()
+                  .isApprox(expected_hessian, 1e-3f));
+  // The outer border has no neighbors.
+  EXPECT_FALSE(block.getVoxelByVoxelIndex(VoxelIndex(0, 3, 3)).gradient_valid);
+  EXPECT_TRUE(block.getVoxelByVoxelIndex(VoxelIndex(0, 3, 3)).hessian.isZero());
+  // Its neighbor is observed, but the zero gradient of the border voxel must
+  // not enter its central difference.
+  EXPECT_TRUE(block.getVoxelByVoxelIndex(VoxelIndex(1, 3, 3)).gradient_valid);
+  EXPECT_TRUE(block.getVoxelByVoxelIndex(VoxelIndex(1, 3, 3)).hessian.isZero());
+
+  Interpolator<EsdfCachingVoxel> interpolator(layer_.get());
+  PointsMatrix positions(3, 3);
+  positions.col(0) = Point(0.34f, 0.36f, 0.33f);
+  positions.col(1) = Point(0.79f, 0.33f, 0.41f);
+  positions.col(2) = Point(-0.5f, 0.2f, 0.2f);
+
+  Interpolator<EsdfCachingVoxel>::DistanceVector distances;
+  PointsMatrix gradients;
+  Interpolator<EsdfCachingVoxel>::SymmetricMatrices hessians;
+  Interpolator<EsdfCachingVoxel>::ValidityVector valid;
+  EXPECT_EQ(interpolator.getInterpolatedDistancesGradientsFromHessians(
+                positions, &distances, &gradients, &hessians, &valid),
+            2u);
+  EXPECT_FALSE(valid(2));
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_TRUE(valid(i));
+    FloatingPoint distance;
+    Point gradient;
+    ASSERT_TRUE(interpolator.getInterpolatedDistanceGradientFromHessian(
+        positions.col(i), &distance, &gradient));
+    EXPECT_NEAR(distances(i), distance, compare_tol_);
+    EXPECT_NEAR((gradients.col(i) - gradient).norm(), 0.0f, compare_tol_);
+    EXPECT_NEAR(hessians(0, i), 2.0f, 1e-3f);
+    EXPECT_NEAR(hessians(4, i), 1.0f, 1e-3f);
+  }
+}
+
+TEST_F(EsdfCachingInterpolatorTest, TrilinearReproducesLinearField) {
+  Interpolator<EsdfCachingVoxel> interpolator(layer_.get());
+
+  PointsMatrix positions(3, 6);
+  positions.col(0) = Point(0.23f, 0.41f, 0.37f);
+  // Cells across the seam of the two blocks.
+  positions.col(1) = Point(0.8f, 0.42f, 0.11f);
+  positions.col(2) = Point(0.83f, 0.15f, 0.55f);
+  positions.col(3) = Point(1.27f, 0.33f, 0.66f);
+  // Border of the map, falls back to the containing voxel.
+  positions.col(4) = Point(0.02f, 0.78f, 0.4f);
+  // Outside of the allocated blocks.
+  positions.col(5) = Point(-0.5f, 0.2f, 0.2f);
+
+  Interpolator<EsdfCachingVoxel>::DistanceVector distances;
+  PointsMatrix gradients;
+  Interpolator<EsdfCachingVoxel>::ValidityVector valid;
+  EXPECT_EQ(interpolator.getTrilinearDistancesGradients(positions, &distances,
+                                                        &gradients, &valid),
+            5u);
+  EXPECT_FALSE(valid(5));
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_TRUE(valid(i)) << "point " << i;
+    FloatingPoint distance;
+    Point gradient;
+    ASSERT_TRUE(interpolator.getTrilinearDistanceGradient(
+        positions.col(i), &distance, &gradient));
+    EXPECT_NEAR(distances(i), distance, compare_tol_);
+    EXPECT_NEAR((gradients.col(i) - gradient).norm(), 0.0f, compare_tol_);
+    if (i == 4) {
+      ASSERT_TRUE(interpolator.getInterpolatedDistanceGradient(
+          positions.col(i), &distance, &gradient));
+    } else {
+      distance = 0.5f * positions(0, i) + 0.1f;
+      gradient = Point(0.5f, 0.0f, 0.0f);
+    }
+    EXPECT_NEAR(distances(i), distance, compare_tol_) << "point " << i;
+    EXPECT_NEAR((gradients.col(i) - gradient).norm(), 0.0f, compare_tol_);
+  }
+}
+
+TEST_F(EsdfCachingInterpolatorTest, TrilinearIsContinuous) {
+  BlockIndexList blocks;
+  layer_->getAllAllocatedBlocks(&blocks);
+  for (const BlockIndex& block_index : blocks) {
+    Block<EsdfCachingVoxel>& block = layer_->getBlockByIndex(block_index);
+    for (size_t i = 0u; i < block.num_voxels(); ++i) {
+      const Point voxel_pos = block.computeCoordinatesFromLinearIndex(i);
+      block.getVoxelByLinearIndex(i).distance =
+          voxel_pos.x() * voxel_pos.x() + voxel_pos.y() * voxel_pos.z();
+    }
+  }
+  layer_->cacheGradients();
+  Interpolator<EsdfCachingVoxel> interpolator(layer_.get());
+
+  // Both sides of voxel faces, of cell faces and of the block seam.
+  const FloatingPoint kStep = 1e-4f;
+  const Point base_points[] = {Point(0.3f, 0.42f, 0.37f),
+                               Point(0.45f, 0.42f, 0.37f),
+                               Point(0.8f, 0.42f, 0.37f),
+                               Point(0.62f, 0.35f, 0.5f)};
+  for (const Point& base_point : base_points) {
+    for (int dim = 0; dim < 3; ++dim) {
+      const Point step = kStep * Point::Unit(dim);
+      FloatingPoint distance_minus, distance_plus;
+      Point gradient_minus, gradient_plus;
+      ASSERT_TRUE(interpolator.getTrilinearDistanceGradient(
+          base_point - step, &distance_minus, &gradient_minus));
+      ASSERT_TRUE(interpolator.getTrilinearDistanceGradient(
+          base_point + step, &distance_plus, &gradient_plus));
+      EXPECT_NEAR(distance_minus, distance_plus, 1e-3f);
+      // The gradient is the derivative of the interpolated distance.
+      EXPECT_NEAR((distance_plus - distance_minus) / (2.0f * kStep),
+                  0.5f * (gradient_minus(dim) + gradient_plus(dim)), 1e-2f);
+    }
+  }
+}
+
+TEST_F(EsdfCachingInterpolatorTest, TrilinearFromCellsMatchesLayer) {
+  BlockIndexList blocks;
+  layer_->getAllAllocatedBlocks(&blocks);
+  for (const BlockIndex& block_index : blocks) {
+    Block<EsdfCachingVoxel>& block = layer_->getBlockByIndex(block_index);
+    for (size_t i = 0u; i < block.num_voxels(); ++i) {
+      const Point voxel_pos = block.computeCoordinatesFromLinearIndex(i);
+      block.getVoxelByLinearIndex(i).distance =
+          voxel_pos.x() * voxel_pos.x() + voxel_pos.y() * voxel_pos.z();
+    }
+  }
+  layer_->cacheGradients();
+  // The cells are only allocated by cacheTrilinearCells().
+  for (const BlockIndex& block_index : blocks) {
+    EXPECT_EQ(layer_->getBlockByIndex(block_index).trilinear_cells(), nullptr);
+  }
+  layer_->cacheTrilinearCells();
+  for (const BlockIndex& block_index : blocks) {
+    EXPECT_NE(layer_->getBlockByIndex(block_index).trilinear_cells(), nullptr);
+  }
+  Interpolator<EsdfCachingVoxel> interpolator(layer_.get());
+
+  PointsMatrix positions(3, 7);
+  positions.col(0) = Point(0.23f, 0.41f, 0.37f);
+  // Cells across the seam of the two blocks, stored in the lower block.
+  positions.col(1) = Point(0.8f, 0.42f, 0.11f);
+  positions.col(2) = Point(0.83f, 0.15f, 0.55f);
+  // Cell with its lower corner in the first block.
+  positions.col(3) = Point(0.77f, 0.33f, 0.66f);
+  // Border of the map, falls back to the containing voxel.
+  positions.col(4) = Point(0.02f, 0.78f, 0.4f);
+  positions.col(5) = Point(1.58f, 0.3f, 0.4f);
+  // Outside of the allocated blocks.
+  positions.col(6) = Point(-0.5f, 0.2f, 0.2f);
+
+  Interpolator<EsdfCachingVoxel>::DistanceVector distances, cell_distances;
+  PointsMatrix gradients, cell_gradients;
+  Interpolator<EsdfCachingVoxel>::ValidityVector valid, cell_valid;
+  EXPECT_EQ(interpolator.getTrilinearDistancesGradients(positions, &distances,
+                                                        &gradients, &valid),
+            6u);
+  EXPECT_EQ(interpolator.getTrilinearDistancesGradientsFromCells(
+                positions, &cell_distances, &cell_gradients, &cell_valid),
+            6u);
+  EXPECT_FALSE(cell_valid(6));
+  for (int i = 0; i < 6; ++i) {
+    ASSERT_TRUE(cell_valid(i)) << "point " << i;
+    EXPECT_NEAR(cell_distances(i), distances(i), compare_tol_) << "point " << i;
+    EXPECT_NEAR((cell_gradients.col(i) - gradients.col(i)).norm(), 0.0f,
+                compare_tol_)
+        << "point " << i;
+    FloatingPoint distance;
+    Point gradient;
+    ASSERT_TRUE(interpolator.getTrilinearDistanceGradientFromCell(
+        positions.col(i), &distance, &gradient));
+    EXPECT_NEAR(distance, distances(i), compare_tol_);
+    EXPECT_NEAR((gradient - gradients.col(i)).norm(), 0.0f, compare_tol_);
+  }
+
+  // Only the cells reaching into a changed block are cached again.
+  Block<EsdfCachingVoxel>& block = layer_->getBlockByIndex(BlockIndex(1, 0, 0));
+  for (size_t i = 0u; i < block.num_voxels(); ++i) {
+    block.getVoxelByLinearIndex(i).distance += 1.0f;
+  }
+  layer_->cacheGradients(BlockIndexList{BlockIndex(1, 0, 0)});
+  layer_->cacheTrilinearCells(BlockIndexList{BlockIndex(1, 0, 0)});
+  interpolator.getTrilinearDistancesGradients(positions, &distances,
+                                              &gradients, &valid);
+  interpolator.getTrilinearDistancesGradientsFromCells(
+      positions, &cell_distances, &cell_gradients, &cell_valid);
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_NEAR(cell_distances(i), distances(i), compare_tol_) << "point " << i;
+    EXPECT_NEAR((cell_gradients.col(i) - gradients.col(i)).norm(), 0.0f,
+                compare_tol_)
+        << "point " << i;
+  }
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  google::InitGoogleLogging(argv[0]);
+
+  int result = RUN_ALL_TESTS();
+
+  return result;
+}
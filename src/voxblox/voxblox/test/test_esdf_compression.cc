@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <random>
+
+#include "voxblox/core/block.h"
+#include "voxblox/core/common.h"
+#include "voxblox/core/voxel.h"
+#include "voxblox/utils/esdf_compression.h"
+
+using namespace voxblox;  // NOLINT
+
+class EsdfCompressionTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    block_.reset(
+        new Block<EsdfVoxel>(voxels_per_side_, voxel_size_, Point::Zero()));
+  }
+
+  /// A sphere of radius 0.2 in a block of free space clamped at max_distance_.
+  void setSphere() {
+    for (size_t i = 0u; i < block_->num_voxels(); ++i) {
+      const Point voxel_pos = block_->computeCoordinatesFromLinearIndex(i);
+      EsdfVoxel& voxel = block_->getVoxelByLinearIndex(i);
+      voxel.distance = std::min(
+          (voxel_pos - Point::Constant(0.4f)).norm() - 0.2f, max_distance_);
+      voxel.observed = voxel_pos.z() < 1.2f;
+      voxel.fixed = true;
+      voxel.parent = Eigen::Vector3i(1, 0, -1);
+    }
+    block_->has_data() = true;
+  }
+
+  /// Round trip into a block with different contents.
+  void expectRoundTrip() {
+    std::vector<uint32_t> data;
+    compressEsdfBlock(*block_, &data);
+
+    Block<EsdfVoxel> decoded(voxels_per_side_, voxel_size_, Point::Zero());
+    decoded.getVoxelByLinearIndex(3u).distance = 7.0f;
+    decoded.getVoxelByLinearIndex(3u).in_queue = true;
+    ASSERT_TRUE(decompressEsdfBlock(data, &decoded));
+
+    float max_distance = 0.0f;
+    bool has_data = false;
+    for (size_t i = 0u; i < block_->num_voxels(); ++i) {
+      max_distance = std::max(
+          max_distance, std::abs(block_->getVoxelByLinearIndex(i).distance));
+      has_data |= block_->getVoxelByLinearIndex(i).observed;
+    }
+    const float tolerance =
+        0.5f * max_distance / esdf_compression::kMaxEsdfCode + 1e-6f;
+    for (size_t i = 0u; i < block_->num_voxels(); ++i) {
+      const EsdfVoxel& voxel = block_->getVoxelByLinearIndex(i);
+      const EsdfVoxel& decoded_voxel = decoded.getVoxelByLinearIndex(i);
+      EXPECT_NEAR(decoded_voxel.distance, voxel.distance, tolerance);
+      EXPECT_EQ(decoded_voxel.observed, voxel.observed);
+      EXPECT_FALSE(decoded_voxel.in_queue);
+      EXPECT_FALSE(decoded_voxel.fixed);
+      EXPECT_EQ(decoded_voxel.parent, Eigen::Vector3i::Zero());
+    }
+    EXPECT_EQ(decoded.has_data(), has_data);
+  }
+
+  std::unique_ptr<Block<EsdfVoxel>> block_;
+
+  const float voxel_size_ = 0.1f;
+  const size_t voxels_per_side_ = 16u;
+  const float max_distance_ = 0.3f;
+};
+
+TEST_F(EsdfCompressionTest, RoundTripSphere) {
+  setSphere();
+  expectRoundTrip();
+
+  // Most of the block is free space, which collapses into runs.
+  std::vector<uint32_t> data;
+  compressEsdfBlock(*block_, &data);
+  std::vector<uint32_t> raw_data;
+  block_->serializeToIntegers(&raw_data);
+  EXPECT_LT(4u * data.size(), raw_data.size());
+}
+
+TEST_F(EsdfCompressionTest, RoundTripRandom) {
+  std::mt19937 generator(0u);
+  std::uniform_real_distribution<float> distance(-3.0f, 3.0f);
+  std::bernoulli_distribution observed(0.7);
+  for (size_t i = 0u; i < block_->num_voxels(); ++i) {
+    EsdfVoxel& voxel = block_->getVoxelByLinearIndex(i);
+    voxel.distance = distance(generator);
+    voxel.observed = observed(generator);
+  }
+  expectRoundTrip();
+}
+
+TEST_F(EsdfCompressionTest, RoundTripConstant) {
+  // An all zero, unobserved block and a constant free block are single runs.
+  std::vector<uint32_t> data;
+  compressEsdfBlock(*block_, &data);
+  EXPECT_EQ(data.size(), 2u);
+  expectRoundTrip();
+
+  for (size_t i = 0u; i < block_->num_voxels(); ++i) {
+    block_->getVoxelByLinearIndex(i).distance = -max_distance_;
+    block_->getVoxelByLinearIndex(i).observed = true;
+  }
+  compressEsdfBlock(*block_, &data);
+  EXPECT_EQ(data.size(), 2u);
+  expectRoundTrip();
+}
+
+TEST_F(EsdfCompressionTest, LongRuns) {
+  // More voxels than fit into the run length of one word.
+  block_.reset(new Block<EsdfVoxel>(48u, voxel_size_, Point::Zero()));
+  for (size_t i = 0u; i < block_->num_voxels(); ++i) {
+    block_->getVoxelByLinearIndex(i).distance = 1.0f;
+  }
+  std::vector<uint32_t> data;
+  compressEsdfBlock(*block_, &data);
+  EXPECT_EQ(data.size(), 3u);
+
+  Block<EsdfVoxel> decoded(48u, voxel_size_, Point::Zero());
+  ASSERT_TRUE(decompressEsdfBlock(data, &decoded));
+  for (size_t i = 0u; i < decoded.num_voxels(); ++i) {
+    EXPECT_NEAR(decoded.getVoxelByLinearIndex(i).distance, 1.0f, 1e-6f);
+  }
+}
+
+TEST_F(EsdfCompressionTest, RejectsMalformedData) {
+  setSphere();
+  std::vector<uint32_t> data;
+  compressEsdfBlock(*block_, &data);
+
+  Block<EsdfVoxel> decoded(voxels_per_side_, voxel_size_, Point::Zero());
+  std::vector<uint32_t> truncated(data.begin(), data.end() - 1);
+  EXPECT_FALSE(decompressEsdfBlock(truncated, &decoded));
+  std::vector<uint32_t> extended = data;
+  extended.push_back(data.back());
+  EXPECT_FALSE(decompressEsdfBlock(extended, &decoded));
+  EXPECT_FALSE(decompressEsdfBlock(std::vector<uint32_t>(), &decoded));
+
+  // Blocks of a different size do not match the run lengths.
+  Block<EsdfVoxel> smaller(8u, voxel_size_, Point::Zero());
+  EXPECT_FALSE(decompressEsdfBlock(data, &smaller));
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  int result = RUN_ALL_TESTS();
+
+  return result;
+}
@@ -0,0 +1,227 @@
+#include <gtest/gtest.h>
+#include <random>
+
+#include "voxblox/core/common.h"
+#include "voxblox/core/esdf_window.h"
+#include "voxblox/core/layer.h"
+#include "voxblox/core/voxel.h"
+#include "voxblox/interpolator/interpolator.h"
+
+using namespace voxblox;  // NOLINT
+
+class EsdfWindowTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    layer_.reset(new Layer<EsdfCachingVoxel>(voxel_size_, voxels_per_side_));
+    // Leave some blocks unallocated.
+    for (int x = -4; x < 4; ++x) {
+      for (int y = -4; y < 4; ++y) {
+        for (int z = -2; z < 2; ++z) {
+          if ((x + y + z) % 5 != 0) {
+            setBlock(BlockIndex(x, y, z), 0.0f);
+          }
+        }
+      }
+    }
+
+    // Voxel centers with an offset of less than half a voxel, so the window
+    // and the layer agree on the voxel of every point.
+    std::mt19937 generator(0u);
+    std::uniform_int_distribution<int> voxel(-40, 40);
+    std::uniform_real_distribution<FloatingPoint> offset(-0.4f, 0.4f);
+    positions_.resize(3, 2000);
+    for (int i = 0; i < positions_.cols(); ++i) {
+      const GlobalIndex global_index(voxel(generator), voxel(generator),
+                                     voxel(generator) / 2);
+      positions_.col(i) =
+          getCenterPointFromGridIndex(global_index, voxel_size_) +
+          voxel_size_ * Point(offset(generator), offset(generator),
+                              offset(generator));
+    }
+  }
+
+  void setBlock(const BlockIndex& index, FloatingPoint shift) {
+    Block<EsdfCachingVoxel>::Ptr block_ptr =
+        layer_->allocateBlockPtrByIndex(index);
+    for (size_t i = 0u; i < block_ptr->num_voxels(); ++i) {
+      const Point voxel_pos = block_ptr->computeCoordinatesFromLinearIndex(i);
+      EsdfCachingVoxel& voxel = block_ptr->getVoxelByLinearIndex(i);
+      voxel.distance = voxel_pos.norm() - 0.5f + shift;
+      voxel.gradient = voxel_pos.normalized();
+      voxel.observed = true;
+    }
+    block_ptr->has_data() = true;
+  }
+
+  /// Compares all points in the window to the interpolator.
+  void expectMatchesLayer(const EsdfWindow& window) {
+    Interpolator<EsdfCachingVoxel> interpolator(layer_.get());
+    Interpolator<EsdfCachingVoxel>::DistanceVector expected_distances;
+    PointsMatrix expected_gradients;
+    Interpolator<EsdfCachingVoxel>::ValidityVector expected_valid;
+    interpolator.getInterpolatedDistancesGradients(
+        positions_, &expected_distances, &expected_gradients, &expected_valid);
+
+    EsdfWindow::DistanceVector distances;
+    PointsMatrix gradients;
+    EsdfWindow::ValidityVector valid;
+    window.getInterpolatedDistancesGradients(positions_, &distances,
+                                             &gradients, &valid);
+    size_t num_in_window = 0u;
+    for (int i = 0; i < positions_.cols(); ++i) {
+      if (!window.contains(positions_.col(i))) {
+        EXPECT_FALSE(valid(i));
+        continue;
+      }
+      ++num_in_window;
+      ASSERT_EQ(valid(i), expected_valid(i)) << positions_.col(i).transpose();
+      if (!valid(i)) {
+        continue;
+      }
+      EXPECT_NEAR(distances(i), expected_distances(i), compare_tol_);
+      EXPECT_NEAR((gradients.col(i) - expected_gradients.col(i)).norm(), 0.0f,
+                  compare_tol_);
+    }
+    EXPECT_GT(num_in_window, 0u);
+  }
+
+  std::unique_ptr<Layer<EsdfCachingVoxel>> layer_;
+  PointsMatrix positions_;
+
+  const float voxel_size_ = 0.1f;
+  const size_t voxels_per_side_ = 8u;
+  const size_t window_side_voxels_ = 30u;
+  const float compare_tol_ = 1e-5f;
+};
+
+TEST_F(EsdfWindowTest, MatchesInterpolator) {
+  EsdfWindow window(voxel_size_, window_side_voxels_);
+  EsdfWindow::DistanceVector distances;
+  PointsMatrix gradients;
+  EsdfWindow::ValidityVector valid;
+  EXPECT_EQ(window.getInterpolatedDistancesGradients(positions_, &distances,
+                                                     &gradients, &valid),
+            0u);
+
+  window.moveTo(*layer_, Point(0.2f, -0.3f, 0.1f));
+  EXPECT_TRUE(window.initialized());
+  EXPECT_TRUE(window.contains(Point(0.2f, -0.3f, 0.1f)));
+  EXPECT_FALSE(window.contains(Point(3.0f, 0.0f, 0.0f)));
+  expectMatchesLayer(window);
+}
+
+TEST_F(EsdfWindowTest, MovesIncrementally) {
+  EsdfWindow window(voxel_size_, window_side_voxels_);
+  window.moveTo(*layer_, Point::Zero());
+
+  // Small steps, a step of more than the window size, and steps back.
+  const Point centers[] = {Point(0.13f, 0.0f, 0.0f),
+                           Point(0.31f, -0.27f, 0.05f),
+                           Point(-0.52f, 0.66f, -0.1f),
+                           Point(3.5f, 3.5f, 0.0f),
+                           Point(2.9f, 3.2f, 0.3f),
+                           Point(-1.0f, -1.2f, -0.2f)};
+  for (const Point& center : centers) {
+    window.moveTo(*layer_, center);
+    SCOPED_TRACE(center.transpose());
+    expectMatchesLayer(window);
+  }
+}
+
+TEST_F(EsdfWindowTest, UpdatesBlocks) {
+  EsdfWindow window(voxel_size_, window_side_voxels_);
+  window.moveTo(*layer_, Point::Zero());
+
+  BlockIndexList updated_blocks;
+  updated_blocks.push_back(BlockIndex(0, 0, 0));
+  updated_blocks.push_back(BlockIndex(-1, 0, -1));
+  updated_blocks.push_back(BlockIndex(3, 3, 1));
+  for (const BlockIndex& index : updated_blocks) {
+    setBlock(index, 0.25f);
+  }
+  // Removed blocks become unknown.
+  updated_blocks.push_back(BlockIndex(1, 0, 0));
+  layer_->removeBlock(BlockIndex(1, 0, 0));
+
+  window.updateBlocks(*layer_, updated_blocks);
+  expectMatchesLayer(window);
+}
+
+TEST_F(EsdfWindowTest, CopiesOnlyChangedBricks) {
+  EsdfWindow window(voxel_size_, window_side_voxels_);
+  window.moveTo(*layer_, Point::Zero());
+  const size_t num_bricks = window.getNumSharedBricks(window);
+
+  // Moving a copy by one voxel along x rewrites one plane of slots.
+  EsdfWindow moved(window);
+  EXPECT_EQ(moved.getNumSharedBricks(window), num_bricks);
+  moved.moveTo(*layer_, Point(voxel_size_, 0.0f, 0.0f));
+  EXPECT_GT(moved.getNumSharedBricks(window), 0u);
+  EXPECT_LT(moved.getNumSharedBricks(window), num_bricks);
+  expectMatchesLayer(moved);
+
+  // Updating a copy leaves the original at the old state of the layer.
+  EsdfWindow updated(window);
+  EsdfWindow::DistanceVector distances_before;
+  PointsMatrix gradients;
+  EsdfWindow::ValidityVector valid;
+  window.getInterpolatedDistancesGradients(positions_, &distances_before,
+                                           &gradients, &valid);
+  setBlock(BlockIndex(0, 0, 0), 0.25f);
+  updated.updateBlocks(*layer_, BlockIndexList(1, BlockIndex(0, 0, 0)));
+  expectMatchesLayer(updated);
+  EXPECT_LT(updated.getNumSharedBricks(window), num_bricks);
+
+  EsdfWindow::DistanceVector distances_after;
+  window.getInterpolatedDistancesGradients(positions_, &distances_after,
+                                           &gradients, &valid);
+  for (int i = 0; i < positions_.cols(); ++i) {
+    if (valid(i)) {
+      EXPECT_EQ(distances_after(i), distances_before(i));
+    }
+  }
+}
+
+TEST_F(EsdfWindowTest, TrilinearMatchesInterpolator) {
+  EsdfWindow window(voxel_size_, window_side_voxels_);
+  window.moveTo(*layer_, Point(0.4f, 0.1f, -0.2f));
+
+  Interpolator<EsdfCachingVoxel> interpolator(layer_.get());
+  Interpolator<EsdfCachingVoxel>::DistanceVector expected_distances;
+  PointsMatrix expected_gradients;
+  Interpolator<EsdfCachingVoxel>::ValidityVector expected_valid;
+  interpolator.getTrilinearDistancesGradients(
+      positions_, &expected_distances, &expected_gradients, &expected_valid);
+
+  EsdfWindow::DistanceVector distances;
+  PointsMatrix gradients;
+  EsdfWindow::ValidityVector valid;
+  window.getTrilinearDistancesGradients(positions_, &distances, &gradients,
+                                        &valid);
+  size_t num_compared = 0u;
+  const Point half_voxel = Point::Constant(0.5f * voxel_size_);
+  for (int i = 0; i < positions_.cols(); ++i) {
+    // Cells crossing the border of the window use the containing voxel only.
+    if (!window.contains(positions_.col(i) - half_voxel) ||
+        !window.contains(positions_.col(i) + half_voxel)) {
+      continue;
+    }
+    ++num_compared;
+    ASSERT_EQ(valid(i), expected_valid(i)) << positions_.col(i).transpose();
+    if (!valid(i)) {
+      continue;
+    }
+    EXPECT_NEAR(distances(i), expected_distances(i), compare_tol_);
+    EXPECT_NEAR((gradients.col(i) - expected_gradients.col(i)).norm(), 0.0f,
+                compare_tol_);
+  }
+  EXPECT_GT(num_compared, 0u);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  int result = RUN_ALL_TESTS();
+
+  return result;
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+
+#include "voxblox/core/block_hash.h"
+#include "voxblox/core/common.h"
+#include "voxblox/core/flat_index_hash_map.h"
+
+using namespace voxblox;  // NOLINT
+
+class FlatIndexHashMapTest : public ::testing::Test {
+ protected:
+  typedef FlatIndexHashMap<std::shared_ptr<int> > FlatMap;
+  typedef AnyIndexHashMapType<std::shared_ptr<int> >::type NodeMap;
+
+  static void expectSameContent(const FlatMap& flat_map,
+                                const NodeMap& node_map) {
+    ASSERT_EQ(flat_map.size(), node_map.size());
+    size_t num_iterated = 0u;
+    for (const FlatMap::value_type& kv : flat_map) {
+      NodeMap::const_iterator it = node_map.find(kv.first);
+      ASSERT_TRUE(it != node_map.end());
+      EXPECT_EQ(kv.second, it->second);
+      ++num_iterated;
+    }
+    EXPECT_EQ(num_iterated, node_map.size());
+    for (const NodeMap::value_type& kv : node_map) {
+      FlatMap::const_iterator it = flat_map.find(kv.first);
+      ASSERT_TRUE(it != flat_map.end());
+      EXPECT_EQ(it->second, kv.second);
+    }
+  }
+};
+
+TEST_F(FlatIndexHashMapTest, InsertFindErase) {
+  FlatMap flat_map;
+  EXPECT_TRUE(flat_map.empty());
+  EXPECT_TRUE(flat_map.find(AnyIndex::Zero()) == flat_map.end());
+  EXPECT_EQ(flat_map.erase(AnyIndex::Zero()), 0u);
+
+  std::shared_ptr<int> value = std::make_shared<int>(1);
+  auto insert_status = flat_map.emplace(AnyIndex(1, 2, 3), value);
+  EXPECT_TRUE(insert_status.second);
+  EXPECT_EQ(insert_status.first->first, AnyIndex(1, 2, 3));
+  EXPECT_EQ(insert_status.first->second, value);
+
+  // Existing keys are not overwritten.
+  insert_status = flat_map.emplace(AnyIndex(1, 2, 3), std::make_shared<int>(2));
+  EXPECT_FALSE(insert_status.second);
+  EXPECT_EQ(insert_status.first->second, value);
+  EXPECT_EQ(flat_map.size(), 1u);
+  EXPECT_EQ(flat_map.count(AnyIndex(1, 2, 3)), 1u);
+
+  EXPECT_EQ(flat_map[AnyIndex(-1, 0, 0)], nullptr);
+  EXPECT_EQ(flat_map.size(), 2u);
+
+  EXPECT_EQ(flat_map.erase(AnyIndex(1, 2, 3)), 1u);
+  EXPECT_EQ(flat_map.count(AnyIndex(1, 2, 3)), 0u);
+  // The map released its reference.
+  EXPECT_EQ(value.use_count(), 1);
+
+  flat_map.clear();
+  EXPECT_TRUE(flat_map.empty());
+  EXPECT_TRUE(flat_map.begin() == flat_map.end());
+}
+
+TEST_F(FlatIndexHashMapTest, RandomOperationsMatchUnorderedMap) {
+  FlatMap flat_map;
+  NodeMap node_map;
+
+  // Keys are drawn from a small volume, so there are plenty of collisions,
+  // re-insertions and erasures in the middle of probe sequences.
+  std::mt19937 generator(1);
+  std::uniform_int_distribution<int> coordinate(-8, 8);
+  std::uniform_int_distribution<int> operation(0, 3);
+  for (int i = 0; i < 20000; ++i) {
+    const AnyIndex key(coordinate(generator), coordinate(generator),
+                       coordinate(generator));
+    if (operation(generator) == 0) {
+      EXPECT_EQ(flat_map.erase(key), node_map.erase(key));
+    } else {
+      std::shared_ptr<int> value = std::make_shared<int>(i);
+      EXPECT_EQ(flat_map.emplace(key, value).second,
+                node_map.emplace(key, value).second);
+    }
+    if (i % 1000 == 0) {
+      expectSameContent(flat_map, node_map);
+    }
+  }
+  expectSameContent(flat_map, node_map);
+
+  // Copies are independent.
+  FlatMap copy = flat_map;
+  copy.clear();
+  expectSameContent(flat_map, node_map);
+
+  flat_map.reserve(4u * node_map.size());
+  expectSameContent(flat_map, node_map);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  int result = RUN_ALL_TESTS();
+
+  return result;
+}
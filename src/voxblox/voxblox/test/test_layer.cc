@@ -50,6 +50,30 @@ TEST_F(OccupancyLayerTest, DeepCopyConstructor) {
   EXPECT_TRUE(voxblox::utils::isSameLayer(new_layer, *layer_));
 }
 
+TEST_F(TsdfLayerTest, BorrowedBlockPointers) {
+  BlockIndexList blocks;
+  layer_->getAllAllocatedBlocks(&blocks);
+  ASSERT_FALSE(blocks.empty());
+
+  const Layer<TsdfVoxel>& const_layer = *layer_;
+  for (const BlockIndex& index : blocks) {
+    const Block<TsdfVoxel>* block_ptr =
+        const_layer.getBlockRawPtrByIndex(index);
+    EXPECT_EQ(block_ptr, const_layer.getBlockPtrByIndex(index).get());
+    EXPECT_EQ(block_ptr, layer_->getBlockRawPtrByIndex(index));
+    EXPECT_EQ(block_ptr, const_layer.getBlockRawPtrByCoordinates(
+                             block_ptr->origin() +
+                             Point::Constant(0.5f * block_ptr->block_size())));
+    // Only the layer owns the block, the lookups above left no references.
+    EXPECT_EQ(layer_->getBlockPtrByIndex(index).use_count(), 2);
+  }
+
+  const BlockIndex unallocated =
+      BlockIndex::Constant(static_cast<IndexElement>(kBlockVolumeDiameter));
+  EXPECT_EQ(const_layer.getBlockRawPtrByIndex(unallocated), nullptr);
+  EXPECT_EQ(layer_->getBlockRawPtrByIndex(unallocated), nullptr);
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   google::InitGoogleLogging(argv[0]);
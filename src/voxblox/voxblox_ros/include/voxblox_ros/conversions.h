@@ -12,6 +12,7 @@
 #include <voxblox/core/layer.h>
 #include <voxblox/mesh/mesh.h>
 #include <voxblox/utils/color_maps.h>
+#include <voxblox/utils/esdf_compression.h>
 #include <voxblox_msgs/Layer.h>
 
 namespace voxblox {
@@ -149,11 +150,22 @@ void serializeLayerAsMsg(
     voxblox_msgs::Layer* msg,
     const MapDerializationAction& action = MapDerializationAction::kUpdate);
 
+/**
+ * Same as serializeLayerAsMsg(), but encodes the blocks with
+ * compressEsdfBlock(). Distances are quantized and only the observed flags are
+ * kept, which is all a remote planning map needs.
+ */
+void serializeCompressedEsdfLayerAsMsg(
+    const Layer<EsdfVoxel>& layer, const bool only_updated,
+    voxblox_msgs::Layer* msg,
+    const MapDerializationAction& action = MapDerializationAction::kUpdate);
+
 /**
  * Returns true if could parse the data into the existing layer (all parameters
- * are compatible), false otherwise.
+ * are compatible), false otherwise. The layer is only changed if all blocks of
+ * the message could be parsed.
  * This function will use the deserialization action suggested by the layer
- * message.
+ * message. ESDF layers also accept compressed messages.
  */
 template <typename VoxelType>
 bool deserializeMsgToLayer(const voxblox_msgs::Layer& msg,
@@ -1,6 +1,8 @@
 #ifndef VOXBLOX_ROS_CONVERSIONS_INL_H_
 #define VOXBLOX_ROS_CONVERSIONS_INL_H_
 
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace voxblox {
@@ -39,6 +41,68 @@ void serializeLayerAsMsg(const Layer<VoxelType>& layer, const bool only_updated,
   }
 }  // namespace voxblox
 
+inline void serializeCompressedEsdfLayerAsMsg(
+    const Layer<EsdfVoxel>& layer, const bool only_updated,
+    voxblox_msgs::Layer* msg, const MapDerializationAction& action) {
+  CHECK_NOTNULL(msg);
+  msg->voxels_per_side = layer.voxels_per_side();
+  msg->voxel_size = layer.voxel_size();
+
+  msg->layer_type = voxel_types::kCompressedEsdf;
+
+  BlockIndexList block_list;
+  if (only_updated) {
+    layer.getAllUpdatedBlocks(Update::kMap, &block_list);
+  } else {
+    layer.getAllAllocatedBlocks(&block_list);
+  }
+
+  msg->action = static_cast<uint8_t>(action);
+
+  msg->blocks.resize(block_list.size());
+  for (size_t i = 0u; i < block_list.size(); ++i) {
+    const BlockIndex& index = block_list[i];
+    voxblox_msgs::Block& block_msg = msg->blocks[i];
+    block_msg.x_index = index.x();
+    block_msg.y_index = index.y();
+    block_msg.z_index = index.z();
+
+    compressEsdfBlock(layer.getBlockByIndex(index), &block_msg.data);
+  }
+}
+
+/// Whether a layer message of the given type can be parsed into the layer.
+template <typename VoxelType>
+inline bool isCompatibleLayerType(const std::string& layer_type) {
+  return getVoxelType<VoxelType>().compare(layer_type) == 0;
+}
+
+template <>
+inline bool isCompatibleLayerType<EsdfVoxel>(const std::string& layer_type) {
+  return getVoxelType<EsdfVoxel>().compare(layer_type) == 0 ||
+         voxel_types::kCompressedEsdf.compare(layer_type) == 0;
+}
+
+/// Overwrites the voxels of block, returns false if the data is malformed.
+template <typename VoxelType>
+inline bool deserializeBlockMsg(const std::string& /*layer_type*/,
+                                const voxblox_msgs::Block& block_msg,
+                                Block<VoxelType>* block) {
+  block->deserializeFromIntegers(block_msg.data);
+  return true;
+}
+
+template <>
+inline bool deserializeBlockMsg<EsdfVoxel>(const std::string& layer_type,
+                                           const voxblox_msgs::Block& block_msg,
+                                           Block<EsdfVoxel>* block) {
+  if (voxel_types::kCompressedEsdf.compare(layer_type) == 0) {
+    return decompressEsdfBlock(block_msg.data, block);
+  }
+  block->deserializeFromIntegers(block_msg.data);
+  return true;
+}
+
 template <typename VoxelType>
 bool deserializeMsgToLayer(const voxblox_msgs::Layer& msg,
                            Layer<VoxelType>* layer) {
@@ -52,7 +116,7 @@ bool deserializeMsgToLayer(const voxblox_msgs::Layer& msg,
                            const MapDerializationAction& action,
                            Layer<VoxelType>* layer) {
   CHECK_NOTNULL(layer);
-  if (getVoxelType<VoxelType>().compare(msg.layer_type) != 0) {
+  if (!isCompatibleLayerType<VoxelType>(msg.layer_type)) {
     return false;
   }
 
@@ -65,38 +129,58 @@ bool deserializeMsgToLayer(const voxblox_msgs::Layer& msg,
     return false;
   }
 
+  // All blocks are decoded into scratch blocks first and only swapped into the
+  // layer once every one of them is valid, so a malformed message leaves the
+  // layer untouched.
+  std::vector<std::pair<BlockIndex, typename Block<VoxelType>::Ptr>>
+      decoded_blocks;
+  decoded_blocks.reserve(msg.blocks.size());
+  for (const voxblox_msgs::Block& block_msg : msg.blocks) {
+    BlockIndex index(block_msg.x_index, block_msg.y_index, block_msg.z_index);
+
+    typename Block<VoxelType>::Ptr block_ptr(new Block<VoxelType>(
+        layer->voxels_per_side(), layer->voxel_size(),
+        getOriginPointFromGridIndex(index, layer->block_size())));
+
+    // An updated block keeps its flags, as if it was overwritten in place.
+    if (action == MapDerializationAction::kUpdate) {
+      typename Block<VoxelType>::ConstPtr old_block_ptr =
+          layer->getBlockPtrByIndex(index);
+      if (old_block_ptr) {
+        block_ptr->has_data() = old_block_ptr->has_data();
+        block_ptr->updated() = old_block_ptr->updated();
+      }
+    }
+
+    if (!deserializeBlockMsg(msg.layer_type, block_msg, block_ptr.get())) {
+      LOG(ERROR) << "Invalid data in block " << index.transpose()
+                 << ", the layer was not changed.";
+      return false;
+    }
+    decoded_blocks.emplace_back(index, std::move(block_ptr));
+  }
+
   if (action == MapDerializationAction::kReset) {
     LOG(INFO) << "Resetting current layer.";
     layer->removeAllBlocks();
   }
 
-  for (const voxblox_msgs::Block& block_msg : msg.blocks) {
-    BlockIndex index(block_msg.x_index, block_msg.y_index, block_msg.z_index);
+  for (std::pair<BlockIndex, typename Block<VoxelType>::Ptr>& decoded_block :
+       decoded_blocks) {
+    const BlockIndex& index = decoded_block.first;
 
     // Either we want to update an existing block or there was no block there
     // before.
     if (action == MapDerializationAction::kUpdate || !layer->hasBlock(index)) {
-      // Create a new block if it doesn't exist yet, or get the existing one
-      // at the correct block index.
-      typename Block<VoxelType>::Ptr block_ptr =
-          layer->allocateBlockPtrByIndex(index);
-
-      std::vector<uint32_t> data = block_msg.data;
-      block_ptr->deserializeFromIntegers(data);
+      layer->removeBlock(index);
+      layer->insertBlock(std::move(decoded_block));
 
     } else if (action == MapDerializationAction::kMerge) {
       typename Block<VoxelType>::Ptr old_block_ptr =
           layer->getBlockPtrByIndex(index);
       CHECK(old_block_ptr);
 
-      typename Block<VoxelType>::Ptr new_block_ptr(new Block<VoxelType>(
-          old_block_ptr->voxels_per_side(), old_block_ptr->voxel_size(),
-          old_block_ptr->origin()));
-
-      std::vector<uint32_t> data = block_msg.data;
-      new_block_ptr->deserializeFromIntegers(data);
-
-      old_block_ptr->mergeBlock(*new_block_ptr);
+      old_block_ptr->mergeBlock(*decoded_block.second);
     }
   }
 
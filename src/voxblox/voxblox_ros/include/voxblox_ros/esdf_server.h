@@ -49,6 +49,9 @@ class EsdfServer : public TsdfServer {
 
   // Overwrites the layer with what's coming from the topic!
   virtual void esdfMapCallback(const voxblox_msgs::Layer& layer_msg);
+  /// Same as esdfMapCallback(), returns false and leaves the layer unchanged
+  /// if the message could not be parsed.
+  bool receiveEsdfMap(const voxblox_msgs::Layer& layer_msg);
 
   inline std::shared_ptr<EsdfMap> getEsdfMapPtr() { return esdf_map_; }
   inline std::shared_ptr<const EsdfMap> getEsdfMapPtr() const {
@@ -97,6 +100,11 @@ class EsdfServer : public TsdfServer {
 
   bool clear_sphere_for_planning_;
   bool publish_esdf_map_;
+  /**
+   * Quantize and run-length encode the blocks of the published ESDF map, see
+   * voxblox/utils/esdf_compression.h.
+   */
+  bool compress_esdf_map_;
   bool publish_traversable_;
   float traversability_radius_;
   bool incremental_update_;
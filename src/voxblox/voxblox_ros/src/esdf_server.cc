@@ -24,6 +24,7 @@ EsdfServer::EsdfServer(const ros::NodeHandle& nh,
                  mesh_config),
       clear_sphere_for_planning_(false),
       publish_esdf_map_(false),
+      compress_esdf_map_(false),
       publish_traversable_(false),
       traversability_radius_(1.0),
       incremental_update_(true),
@@ -59,6 +60,8 @@ void EsdfServer::setupRos() {
   nh_private_.param("clear_sphere_for_planning", clear_sphere_for_planning_,
                     clear_sphere_for_planning_);
   nh_private_.param("publish_esdf_map", publish_esdf_map_, publish_esdf_map_);
+  nh_private_.param("compress_esdf_map", compress_esdf_map_,
+                    compress_esdf_map_);
 
   // Special output for traversable voxels. Publishes all voxels with distance
   // at least traversibility radius.
@@ -157,12 +160,26 @@ void EsdfServer::publishMap(bool reset_remote_map) {
     const bool only_updated = !reset_remote_map;
     timing::Timer publish_map_timer("map/publish_esdf");
     voxblox_msgs::Layer layer_msg;
-    serializeLayerAsMsg<EsdfVoxel>(this->esdf_map_->getEsdfLayer(),
-                                   only_updated, &layer_msg);
+    if (compress_esdf_map_) {
+      serializeCompressedEsdfLayerAsMsg(this->esdf_map_->getEsdfLayer(),
+                                        only_updated, &layer_msg);
+    } else {
+      serializeLayerAsMsg<EsdfVoxel>(this->esdf_map_->getEsdfLayer(),
+                                     only_updated, &layer_msg);
+    }
     if (reset_remote_map) {
       layer_msg.action = static_cast<uint8_t>(MapDerializationAction::kReset);
     }
     this->esdf_map_pub_.publish(layer_msg);
+
+    // The next incremental message only contains the blocks that the ESDF
+    // integrator changed after this one.
+    Layer<EsdfVoxel>* esdf_layer = this->esdf_map_->getEsdfLayerPtr();
+    for (const voxblox_msgs::Block& block_msg : layer_msg.blocks) {
+      const BlockIndex index(block_msg.x_index, block_msg.y_index,
+                             block_msg.z_index);
+      esdf_layer->getBlockByIndex(index).updated().reset(Update::kMap);
+    }
     publish_map_timer.Stop();
   }
   num_subscribers_esdf_map_ = subscribers;
@@ -231,6 +248,10 @@ void EsdfServer::newPoseCallback(const Transformation& T_G_C) {
 }
 
 void EsdfServer::esdfMapCallback(const voxblox_msgs::Layer& layer_msg) {
+  receiveEsdfMap(layer_msg);
+}
+
+bool EsdfServer::receiveEsdfMap(const voxblox_msgs::Layer& layer_msg) {
   timing::Timer receive_map_timer("map/receive_esdf");
 
   bool success =
@@ -242,6 +263,7 @@ void EsdfServer::esdfMapCallback(const voxblox_msgs::Layer& layer_msg) {
     ROS_INFO_ONCE("Got an ESDF map from ROS topic!");
     publishPointclouds();
   }
+  return success;
 }
 
 void EsdfServer::clear() {
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <voxblox/core/layer.h>
+#include <voxblox/core/voxel.h>
+
+#include "voxblox_ros/conversions.h"
+
+using namespace voxblox;  // NOLINT
+
+class ConversionsTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    layer_.reset(new Layer<EsdfVoxel>(voxel_size_, voxels_per_side_));
+    setBlock(BlockIndex(0, 0, 0), 0.5f, layer_.get());
+    setBlock(BlockIndex(1, 0, 0), 1.0f, layer_.get());
+  }
+
+  /// Allocates the block if needed and sets all its voxels to distance.
+  static void setBlock(const BlockIndex& index, float distance,
+                       Layer<EsdfVoxel>* layer) {
+    Block<EsdfVoxel>::Ptr block = layer->allocateBlockPtrByIndex(index);
+    for (size_t i = 0u; i < block->num_voxels(); ++i) {
+      block->getVoxelByLinearIndex(i).distance = distance;
+      block->getVoxelByLinearIndex(i).observed = true;
+    }
+    block->has_data() = true;
+  }
+
+  /// A compressed message of the blocks in source, the last one truncated.
+  static voxblox_msgs::Layer truncatedMsg(const Layer<EsdfVoxel>& source,
+                                          MapDerializationAction action) {
+    voxblox_msgs::Layer msg;
+    constexpr bool kOnlyUpdated = false;
+    serializeCompressedEsdfLayerAsMsg(source, kOnlyUpdated, &msg, action);
+    EXPECT_GE(msg.blocks.size(), 2u);
+    msg.blocks.back().data.pop_back();
+    return msg;
+  }
+
+  void expectLayerUnchanged() const {
+    EXPECT_EQ(layer_->getNumberOfAllocatedBlocks(), 2u);
+    EXPECT_FALSE(layer_->hasBlock(BlockIndex(0, 1, 0)));
+    const std::pair<BlockIndex, float> expected[] = {
+        {BlockIndex(0, 0, 0), 0.5f}, {BlockIndex(1, 0, 0), 1.0f}};
+    for (const std::pair<BlockIndex, float>& block : expected) {
+      ASSERT_TRUE(layer_->hasBlock(block.first));
+      const Block<EsdfVoxel>& layer_block =
+          layer_->getBlockByIndex(block.first);
+      for (size_t i = 0u; i < layer_block.num_voxels(); ++i) {
+        EXPECT_EQ(layer_block.getVoxelByLinearIndex(i).distance,
+                  block.second);
+      }
+    }
+  }
+
+  std::unique_ptr<Layer<EsdfVoxel>> layer_;
+
+  const float voxel_size_ = 0.1f;
+  const size_t voxels_per_side_ = 8u;
+};
+
+TEST_F(ConversionsTest, TruncatedCompressedUpdateLeavesLayerUnchanged) {
+  // Overwrites both existing blocks and adds a third one.
+  Layer<EsdfVoxel> source(voxel_size_, voxels_per_side_);
+  setBlock(BlockIndex(0, 0, 0), 2.0f, &source);
+  setBlock(BlockIndex(1, 0, 0), 2.0f, &source);
+  setBlock(BlockIndex(0, 1, 0), 2.0f, &source);
+  const voxblox_msgs::Layer msg =
+      truncatedMsg(source, MapDerializationAction::kUpdate);
+
+  EXPECT_FALSE(deserializeMsgToLayer(msg, layer_.get()));
+  expectLayerUnchanged();
+}
+
+TEST_F(ConversionsTest, TruncatedCompressedResetLeavesLayerUnchanged) {
+  Layer<EsdfVoxel> source(voxel_size_, voxels_per_side_);
+  setBlock(BlockIndex(0, 1, 0), 2.0f, &source);
+  setBlock(BlockIndex(0, 2, 0), 2.0f, &source);
+  const voxblox_msgs::Layer msg =
+      truncatedMsg(source, MapDerializationAction::kReset);
+
+  EXPECT_FALSE(deserializeMsgToLayer(msg, layer_.get()));
+  expectLayerUnchanged();
+}
+
+TEST_F(ConversionsTest, CompressedUpdate) {
+  Layer<EsdfVoxel> source(voxel_size_, voxels_per_side_);
+  setBlock(BlockIndex(1, 0, 0), 2.0f, &source);
+  setBlock(BlockIndex(0, 1, 0), 2.0f, &source);
+  voxblox_msgs::Layer msg;
+  constexpr bool kOnlyUpdated = false;
+  serializeCompressedEsdfLayerAsMsg(source, kOnlyUpdated, &msg);
+
+  ASSERT_TRUE(deserializeMsgToLayer(msg, layer_.get()));
+  EXPECT_EQ(layer_->getNumberOfAllocatedBlocks(), 3u);
+  const std::pair<BlockIndex, float> expected[] = {
+      {BlockIndex(0, 0, 0), 0.5f},
+      {BlockIndex(1, 0, 0), 2.0f},
+      {BlockIndex(0, 1, 0), 2.0f}};
+  for (const std::pair<BlockIndex, float>& block : expected) {
+    ASSERT_TRUE(layer_->hasBlock(block.first));
+    const Block<EsdfVoxel>& layer_block = layer_->getBlockByIndex(block.first);
+    EXPECT_TRUE(layer_block.has_data());
+    for (size_t i = 0u; i < layer_block.num_voxels(); ++i) {
+      EXPECT_NEAR(layer_block.getVoxelByLinearIndex(i).distance, block.second,
+                  1e-3f);
+      EXPECT_TRUE(layer_block.getVoxelByLinearIndex(i).observed);
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  int result = RUN_ALL_TESTS();
+
+  return result;
+}